@@ -0,0 +1,159 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef INC_ANIM_H_
+#define INC_ANIM_H_
+
+/******************************************************************************
+ * The header file provides an interface to the animation of the checker
+ * moves. A move is not animated synchronously. Instead it is converted to an
+ * animation job, which consists of frames. The jobs are queued and the main
+ * loop advances them with a frame clock. Each frame describes the complete
+ * state of the animated area, so frames can be skipped if the main loop falls
+ * behind.
+ *****************************************************************************/
+
+#include <stdbool.h>
+
+#include "lib_s_point.h"
+#include "s_board_areas.h"
+#include "s_point_layout.h"
+#include "e_owner.h"
+
+/******************************************************************************
+ * The maximum number of frames of a job and the maximum number of queued
+ * jobs.
+ *****************************************************************************/
+
+#define ANIM_FRAMES_MAX 256
+
+#define ANIM_JOBS_MAX 8
+
+/******************************************************************************
+ * The struct defines the state of a stack of checkers on a field, which is
+ * the number of checkers and whether they are compressed or not.
+ *****************************************************************************/
+
+typedef struct {
+
+	int num;
+
+	e_compressed compressed;
+
+} s_anim_stack;
+
+/******************************************************************************
+ * The struct defines a frame of a move. It contains the state of the source
+ * and the destination field and the position of the traveler, if it is
+ * visible.
+ *****************************************************************************/
+
+typedef struct {
+
+	s_anim_stack src;
+
+	s_anim_stack dst;
+
+	bool has_trv;
+
+	s_point trv_pos;
+
+} s_anim_frame;
+
+/******************************************************************************
+ * The struct defines an animation job, which is a move of a checker from a
+ * source to a destination field.
+ *****************************************************************************/
+
+typedef struct {
+
+	//
+	// The positions of the source and destination fields on the board.
+	//
+	s_pos pos_src;
+
+	s_pos pos_dst;
+
+	//
+	// The owner of the moving checker.
+	//
+	e_owner owner;
+
+	//
+	// The state of the fields before the first frame.
+	//
+	s_anim_frame initial;
+
+	//
+	// The frames of the job.
+	//
+	int num_frames;
+
+	s_anim_frame frames[ANIM_FRAMES_MAX];
+
+	//
+	// The start time of the job and the index of the last rendered frame (-1
+	// if no frame is rendered).
+	//
+	long start;
+
+	int frame_idx;
+
+} s_anim_job;
+
+/******************************************************************************
+ * The definitions of the functions.
+ *****************************************************************************/
+
+void anim_init(const int fps, const int step_ms, void (*render_fct)(const s_anim_job *job, const int idx));
+
+void anim_set_keyframes(const bool keyframes);
+
+s_anim_job* anim_job_new();
+
+void anim_job_add_frame(s_anim_job *job, const s_anim_frame *frame);
+
+void anim_job_start(s_anim_job *job);
+
+bool anim_is_active();
+
+int anim_timeout();
+
+bool anim_tick();
+
+bool anim_step();
+
+void anim_finish();
+
+void anim_clear();
+
+/******************************************************************************
+ * The macro returns the last frame of the job, which is the initial state if
+ * the job has no frames.
+ *****************************************************************************/
+
+#define anim_job_last(j) ((j)->num_frames == 0 ? &(j)->initial : &(j)->frames[(j)->num_frames - 1])
+
+#endif /* INC_ANIM_H_ */
@@ -0,0 +1,68 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_BOT_H_
+#define INC_BOT_H_
+
+/******************************************************************************
+ * The header file provides an interface to the computer player. The move
+ * search runs on a worker thread, so the ui stays responsive. If the search
+ * is finished, the worker wakes up the event loop and the play can be
+ * fetched and animated by the ui thread. While the human player is in turn,
+ * the bot searches its plays for the next rolls in advance.
+ *****************************************************************************/
+
+#include <stdbool.h>
+
+#include "engine.h"
+#include "s_game_cfg.h"
+#include "s_status.h"
+
+/******************************************************************************
+ * Definition of functions and macros.
+ *****************************************************************************/
+
+void bot_init(const s_game_cfg *game_cfg);
+
+void bot_free();
+
+void bot_set_owner(const e_owner owner);
+
+bool bot_is_turn(const s_status *status);
+
+void bot_start(const s_status *status, const s_fieldset *fieldset);
+
+bool bot_is_thinking();
+
+bool bot_get_play(s_eng_play *play);
+
+void bot_cancel();
+
+void bot_ponder(const s_fieldset *fieldset);
+
+void bot_ponder_pause();
+
+void bot_log_stats();
+
+#endif /* INC_BOT_H_ */
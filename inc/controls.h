@@ -33,8 +33,7 @@
  * - confirm button
  *****************************************************************************/
 
-#include <ncurses.h>
-
+#include "s_canvas.h"
 #include "s_fieldset.h"
 #include "s_status.h"
 #include "s_game_cfg.h"
@@ -58,7 +57,7 @@
  * The definitions of the functions.
  *****************************************************************************/
 
-void controls_init(const s_game_cfg *game_cfg, WINDOW *win);
+void controls_init(const s_game_cfg *game_cfg, const s_canvas *canvas);
 
 void controls_free();
 
@@ -66,4 +65,6 @@ void controls_print(const s_status *status);
 
 bool controls_process_event(s_status *status, s_fieldset *fieldset, const s_point *event);
 
+bool controls_is_undo(const s_point *event);
+
 #endif /* INC_CONTROLS_H_ */
@@ -0,0 +1,60 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_DIRECT_H_
+#define INC_DIRECT_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "lib_s_point.h"
+#include "s_tarr.h"
+
+/******************************************************************************
+ * The definitions of the functions.
+ *****************************************************************************/
+
+bool direct_is_supported();
+
+void direct_init(FILE *stream, const s_point dim, const bool palette_256);
+
+void direct_free();
+
+void direct_resize(const s_point dim);
+
+s_tarr* direct_cells();
+
+long direct_bytes();
+
+void direct_move_start();
+
+void direct_move_end();
+
+void direct_log_stats();
+
+void direct_invalidate();
+
+void direct_present();
+
+#endif /* INC_DIRECT_H_ */
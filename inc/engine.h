@@ -0,0 +1,207 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_ENGINE_H_
+#define INC_ENGINE_H_
+
+/******************************************************************************
+ * The header file provides an interface to the move search of the computer
+ * player and the hints. The engine works on a compact copy of the position,
+ * so it can run on a worker thread while the ui thread owns the s_fieldset
+ * and the s_status. The moves follow the same rules as the rules module.
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#include "bg_defs.h"
+#include "e_owner.h"
+#include "s_field_id.h"
+#include "s_fieldset.h"
+
+/******************************************************************************
+ * The maximum number of steps of a play (doublets) and the maximum number of
+ * distinct plays for a roll.
+ *****************************************************************************/
+
+#define ENG_STEPS_MAX 4
+
+#define ENG_PLAYS_MAX 2048
+
+/******************************************************************************
+ * The maximum depth of a search in plies.
+ *****************************************************************************/
+
+#define ENG_DEPTH_MAX 2
+
+/******************************************************************************
+ * The source index of a step from the bar.
+ *****************************************************************************/
+
+#define ENG_SRC_BAR -1
+
+/******************************************************************************
+ * The struct is a position from the view of the player in turn. The points
+ * are relative to the player in turn, so the checkers move from index 0 to
+ * the bear off area after index 23. A positive number are checkers of the
+ * player in turn, a negative number are checkers of the opponent. The bar
+ * and the bear off area have the player in turn at index 0 and the opponent
+ * at index 1.
+ *****************************************************************************/
+
+typedef struct {
+
+	signed char point[POINTS_NUM];
+
+	signed char bar[2];
+
+	signed char off[2];
+
+} s_eng_pos;
+
+/******************************************************************************
+ * The struct is a play for a roll. The first dice is the index of the dice
+ * that is used first (the dices are sorted, so the first dice has the higher
+ * value). The steps are the relative source indices of the moves in the
+ * order of the dices. The position is the result of the play.
+ *****************************************************************************/
+
+typedef struct {
+
+	int dice_first;
+
+	int num;
+
+	signed char src[ENG_STEPS_MAX];
+
+	s_eng_pos pos;
+
+	double eval;
+
+} s_eng_play;
+
+/******************************************************************************
+ * The struct contains the plays for a roll and a hash set for the positions,
+ * which is used to remove plays with the same result.
+ *****************************************************************************/
+
+#define ENG_HASH_SIZE (2 * ENG_PLAYS_MAX)
+
+typedef struct {
+
+	int num;
+
+	s_eng_play play[ENG_PLAYS_MAX];
+
+	short hash[ENG_HASH_SIZE];
+
+} s_eng_plays;
+
+/******************************************************************************
+ * The budget of a search: the maximum depth in plies, the deadline in
+ * microseconds of the monotonic clock (0 means no deadline), the maximum
+ * number of evaluated positions (0 means no limit) and a cancel flag, which
+ * can be set by an other thread.
+ *****************************************************************************/
+
+typedef struct {
+
+	int depth;
+
+	long deadline;
+
+	long nodes;
+
+	atomic_bool *cancel;
+
+} s_eng_budget;
+
+/******************************************************************************
+ * The 21 different rolls and their weights in 36th.
+ *****************************************************************************/
+
+#define ENG_ROLLS_NUM 21
+
+typedef struct {
+
+	int dice_1;
+
+	int dice_2;
+
+	int weight;
+
+} s_eng_roll;
+
+/******************************************************************************
+ * The statistics of a search: the number of evaluated positions, the number
+ * of evaluations from the cache, the number of plays, the depth of the best
+ * play and the number of candidates, that were searched with this depth.
+ *****************************************************************************/
+
+typedef struct {
+
+	long nodes;
+
+	long cache_hits;
+
+	int candidates;
+
+	int depth;
+
+	int searched;
+
+} s_eng_stats;
+
+/******************************************************************************
+ * Definition of functions and macros.
+ *****************************************************************************/
+
+void eng_pos_init(s_eng_pos *pos, const s_fieldset *fieldset, const e_owner turn);
+
+void eng_pos_flip(s_eng_pos *dst, const s_eng_pos *src);
+
+bool eng_can_move(const s_eng_pos *pos, const int dice);
+
+void eng_gen_plays(const s_eng_pos *pos, const int dice_1, const int dice_2, s_eng_plays *plays);
+
+double eng_eval(const s_eng_pos *pos);
+
+void eng_rank(const s_eng_pos *pos, const int dice_1, const int dice_2, s_eng_plays *plays, s_eng_stats *stats);
+
+bool eng_eval_ply(const s_eng_play *play, const int depth, const s_eng_budget *budget, s_eng_plays *replies, double *value, s_eng_stats *stats);
+
+void eng_plays_insert(s_eng_play *play, const int idx);
+
+bool eng_search(const s_eng_pos *pos, const int dice_1, const int dice_2, const s_eng_budget *budget, s_eng_play *best, s_eng_stats *stats);
+
+void eng_play_str(const s_eng_pos *pos, const int dice_1, const int dice_2, const s_eng_play *play, char *buf, const size_t size);
+
+s_field_id eng_step_field_id(const e_owner turn, const int src);
+
+s_eng_roll eng_roll(const int idx);
+
+int eng_roll_idx(const int dice_1, const int dice_2);
+
+#endif /* INC_ENGINE_H_ */
@@ -0,0 +1,71 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_HINT_H_
+#define INC_HINT_H_
+
+/******************************************************************************
+ * The header file provides an interface to the hints. The plays for the roll
+ * of the human player are ranked on a worker thread and the best plays are
+ * shown in a box on the highlight layer of the board. The box is updated
+ * while the ranking gets deeper. A play of the box can be selected, which
+ * replaces the moves of the round.
+ *****************************************************************************/
+
+#include <stdbool.h>
+
+#include "s_board.h"
+#include "s_game_cfg.h"
+#include "s_status.h"
+#include "engine.h"
+
+/******************************************************************************
+ * The number of plays, that are shown.
+ *****************************************************************************/
+
+#define HINT_NUM 5
+
+/******************************************************************************
+ * The definitions of the functions.
+ *****************************************************************************/
+
+void hint_init(s_board *board, const s_game_cfg *game_cfg);
+
+void hint_start(const s_status *status, const s_fieldset *fieldset);
+
+void hint_cancel();
+
+void hint_free();
+
+bool hint_is_active();
+
+void hint_reset();
+
+bool hint_tick(const s_status *status);
+
+bool hint_get(const int idx, s_eng_play *play);
+
+void hint_log_stats();
+
+#endif /* INC_HINT_H_ */
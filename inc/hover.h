@@ -0,0 +1,59 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef INC_HOVER_H_
+#define INC_HOVER_H_
+
+/******************************************************************************
+ * The header file provides an interface to the hover highlighting. The
+ * fields with checkers, that can be moved with the active dice, are marked
+ * on the highlight layer of the board. If the mouse hovers over such a
+ * field, the destination of the move is marked as well.
+ *****************************************************************************/
+
+#include <stdbool.h>
+
+#include "s_board.h"
+#include "s_field_id.h"
+#include "s_game_cfg.h"
+#include "s_status.h"
+
+/******************************************************************************
+ * The definitions of the functions.
+ *****************************************************************************/
+
+void hover_init(s_board *board, const s_game_cfg *game_cfg);
+
+void hover_set(const s_field_id field_id);
+
+void hover_reset();
+
+bool hover_tick(const s_status *status, s_fieldset *fieldset);
+
+int hover_timeout();
+
+void hover_log_stats();
+
+#endif /* INC_HOVER_H_ */
@@ -0,0 +1,86 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef INC_INPUT_H_
+#define INC_INPUT_H_
+
+/******************************************************************************
+ * The header file provides an interface to the input layer. All pending
+ * events are read at once. Mouse motions are collapsed and clicks, that were
+ * queued before the state of the game changed, are stale.
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <ncurses.h>
+
+/******************************************************************************
+ * The maximum number of events that are read at once.
+ *****************************************************************************/
+
+#define INPUT_EVENTS_MAX 64
+
+/******************************************************************************
+ * The struct contains an event: the key (KEY_MOUSE for mouse events), the
+ * mouse event, the time the event was read (microseconds) and the epoch of
+ * the state of the game at that time.
+ *****************************************************************************/
+
+typedef struct {
+
+	int key;
+
+	MEVENT mouse;
+
+	long time;
+
+	unsigned long epoch;
+
+} s_input_event;
+
+/******************************************************************************
+ * Definition of functions and macros.
+ *****************************************************************************/
+
+void input_event_init(s_input_event *event, const int key, const MEVENT *mouse);
+
+int input_collapse(s_input_event *events, const int num);
+
+int input_read(s_input_event *events, const int timeout);
+
+bool input_is_stale(const s_input_event *event);
+
+void input_state_changed();
+
+void input_processed(const s_input_event *event);
+
+void input_rendered();
+
+void input_log_stats();
+
+#define input_is_motion(e) ((e)->key == KEY_MOUSE && ((e)->mouse.bstate & REPORT_MOUSE_POSITION))
+
+#define input_is_click(e) ((e)->key == KEY_MOUSE && ((e)->mouse.bstate & BUTTON1_PRESSED))
+
+#endif /* INC_INPUT_H_ */
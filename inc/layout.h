@@ -25,6 +25,8 @@
 #ifndef INC_LAYOUT_H_
 #define INC_LAYOUT_H_
 
+#include <stdbool.h>
+
 #include "lib_s_point.h"
 
 /******************************************************************************
@@ -35,10 +37,18 @@ void layout_init(const s_point dim_board, const s_point dim_dice);
 
 void layout_free();
 
+void layout_perf_show(const s_point dim, const bool show);
+
+void layout_evict_pair(const short cp, const short fg, const short bg);
+
+bool layout_take_repaint(const bool **rows_board, bool *dice);
+
 WINDOW* layout_win_board();
 
 WINDOW* layout_win_dice();
 
+WINDOW* layout_win_perf();
+
 WINDOW* layout_win_game();
 
 #endif /* INC_LAYOUT_H_ */
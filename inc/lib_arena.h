@@ -0,0 +1,85 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_LIB_ARENA_H_
+#define INC_LIB_ARENA_H_
+
+#include <stddef.h>
+
+/******************************************************************************
+ * The header file provides a simple arena allocator. The memory is taken from
+ * large blocks, so many small allocations result in a few calls of malloc.
+ * There is no function to free a single allocation. All allocations are
+ * released together, when the arena is freed.
+ *****************************************************************************/
+
+/******************************************************************************
+ * The alignment of the allocations, which is the size of a cache line.
+ *****************************************************************************/
+
+#define LA_ALIGN 64
+
+#define la_align_up(s) (((s) + LA_ALIGN - 1) / LA_ALIGN * LA_ALIGN)
+
+/******************************************************************************
+ * The arena is a linked list of blocks. The allocations are taken from the
+ * first block, which is the newest.
+ *****************************************************************************/
+
+typedef struct s_arena_block {
+
+	struct s_arena_block *next;
+
+	size_t size;
+
+	size_t used;
+
+} s_arena_block;
+
+typedef struct {
+
+	s_arena_block *head;
+
+	size_t block_size;
+
+	//
+	// The number of allocations and the number of blocks (mallocs).
+	//
+	int num_allocs;
+
+	int num_blocks;
+
+} s_arena;
+
+/******************************************************************************
+ * The definitions of the functions.
+ *****************************************************************************/
+
+s_arena* la_new(const size_t block_size);
+
+void* la_alloc(s_arena *arena, const size_t size);
+
+void la_free(s_arena **arena);
+
+#endif /* INC_LIB_ARENA_H_ */
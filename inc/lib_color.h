@@ -25,6 +25,9 @@
 #ifndef INC_LIB_COLOR_H_
 #define INC_LIB_COLOR_H_
 
+#include <stdio.h>
+#include <stdbool.h>
+
 /******************************************************************************
  * The definitions.
  *****************************************************************************/
@@ -35,8 +38,24 @@
  * The definitions of the functions.
  *****************************************************************************/
 
+void col_init(const int budget, const short tolerance);
+
 short col_color_create(const short r, const short g, const short b);
 
+void col_set_headless(const bool headless);
+
+bool col_color_rgb(const short color, short *r, short *g, short *b);
+
+short col_color_256(const short color);
+
+int col_color_num();
+
+bool col_write(FILE *stream);
+
+bool col_read(FILE *stream);
+
+void col_log_stats();
+
 #define col_is_valid(c) ((c) != COLOR_UNDEF)
 
 #endif /* INC_LIB_COLOR_H_ */
@@ -25,12 +25,58 @@
 #ifndef INC_LIB_COLOR_PAIR_H_
 #define INC_LIB_COLOR_PAIR_H_
 
+#include <stdio.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * The struct contains the statistics of the color pairs:
+ *
+ * requests:  the number of calls of cp_color_pair_get()
+ * hits:      the number of requests with an existing color pair
+ * adds:      the number of init_pair() calls
+ * evictions: the number of recycled color pairs
+ * overflows: the number of requests, that got the default color pair,
+ *            because all color pairs were used in the current frame
+ *****************************************************************************/
+
+typedef struct {
+
+	long requests;
+
+	long hits;
+
+	long adds;
+
+	long evictions;
+
+	long overflows;
+
+} s_cp_stats;
+
 /******************************************************************************
  * The definitions of the functions.
  *****************************************************************************/
 
+void cp_init(const int budget);
+
+void cp_set_evict_fct(void (*evict_fct)(const short cp, const short fg, const short bg));
+
+void cp_frame_next();
+
 short cp_color_pair_add(const short fg, const short bg);
 
 short cp_color_pair_get(const short fg, const short bg);
 
+void cp_stats(s_cp_stats *stats);
+
+bool cp_write(FILE *stream);
+
+bool cp_read(FILE *stream);
+
+int cp_color_pair_num();
+
+int cp_color_pair_budget();
+
+void cp_log_stats();
+
 #endif /* INC_LIB_COLOR_PAIR_H_ */
@@ -53,6 +53,8 @@ WINDOW* lc_win_create_full();
 
 void lc_win_del(WINDOW *win);
 
+int lc_win_pair_rows(WINDOW *win, const short cp, bool *rows);
+
 void lc_win_refresh(WINDOW *win);
 
 bool lc_win_is_inside(WINDOW *win, const int row, const int col);
@@ -0,0 +1,72 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_LIB_FRAME_H_
+#define INC_LIB_FRAME_H_
+
+#include <ncurses.h>
+
+/******************************************************************************
+ * The header file provides a simple frame compositor. Windows that changed
+ * are marked with lf_win_mark(), which copies the window to the virtual
+ * screen with wnoutrefresh(). The event loop calls lf_frame_flush() once per
+ * iteration, which writes all changes to the terminal with a single
+ * doupdate().
+ *****************************************************************************/
+
+/******************************************************************************
+ * The struct contains the statistics of the compositor:
+ *
+ * frames:  the number of calls of lf_frame_flush()
+ * flushes: the number of calls of doupdate()
+ * marks:   the number of calls of wnoutrefresh()
+ *****************************************************************************/
+
+typedef struct {
+
+	long frames;
+
+	long flushes;
+
+	long marks;
+
+} s_frame_stats;
+
+/******************************************************************************
+ * The definitions of the functions.
+ *****************************************************************************/
+
+void lf_win_mark(WINDOW *win);
+
+void lf_frame_mark();
+
+void lf_frame_set_present(void (*present_fct)());
+
+void lf_frame_flush();
+
+void lf_frame_stats(s_frame_stats *stats);
+
+void lf_frame_log_stats();
+
+#endif /* INC_LIB_FRAME_H_ */
@@ -25,26 +25,256 @@
 #ifndef INC_LIB_LOGGING_H_
 #define INC_LIB_LOGGING_H_
 
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 
 /******************************************************************************
- * Definition of the debug logging macro. It is only defined with DEBUG
- * defined. It prints to stderr not to restrain curses.
+ * The header file provides the logging. A log call does not format the
+ * message. It writes a record with a pointer to the static data of the call
+ * site (level, file, line, function and format) and the raw arguments to a
+ * lock-free ring of the thread. A background thread formats the records and
+ * writes them to stderr. The remaining records are written at exit and
+ * before a fatal error is printed.
+ *
+ * The minimum level is set at runtime with the environment variable
+ * BAGA_LOG_LEVEL (trace, debug, info, warn, off). BAGA_LOG_MODULES sets the
+ * level for modules, which are the names of the source files, for example:
+ * "s_tarr=trace,lib_color_pair=off". BAGA_LOG_SYNC=1 formats each record
+ * immediately, which is useful if the program crashes. BAGA_LOG_RING sets the
+ * number of records of the ring of each thread (default: 1024). If a ring is
+ * full, the records are dropped and the number is logged.
+ *****************************************************************************/
+
+/******************************************************************************
+ * The levels of the log records.
  *****************************************************************************/
 
+#define LOG_LEVEL_TRACE 0
+
+#define LOG_LEVEL_DEBUG 1
+
+#define LOG_LEVEL_INFO  2
+
+#define LOG_LEVEL_WARN  3
+
+#define LOG_LEVEL_OFF   4
+
+/******************************************************************************
+ * The compile time minimum level. The calls with a lower level compile to
+ * nothing. The default is debug for debug builds and info otherwise. The
+ * makefile parameter LOG_LEVEL_MIN sets the level for all files. A source
+ * file can define LOG_MODULE_LEVEL before its includes, to remove the calls
+ * of the file with a lower level. The more restrictive of the two levels is
+ * used, so a file cannot switch on calls, that the build removes.
+ *****************************************************************************/
+
+#ifndef LOG_LEVEL_MIN
 #ifdef DEBUG
+#define LOG_LEVEL_MIN LOG_LEVEL_DEBUG
+#else
+#define LOG_LEVEL_MIN LOG_LEVEL_INFO
+#endif
+#endif
+
+#if defined(LOG_MODULE_LEVEL) && LOG_MODULE_LEVEL > LOG_LEVEL_MIN
+#define LOG_LEVEL_COMPILE LOG_MODULE_LEVEL
+#else
+#define LOG_LEVEL_COMPILE LOG_LEVEL_MIN
+#endif
+
+/******************************************************************************
+ * Each source file is a module with a runtime mask of the enabled levels.
+ * The mask is resolved with the first log call of the module. The bit of a
+ * level is: 1 << level.
+ *****************************************************************************/
+
+#define LOG_MASK_UNRESOLVED -1
+
+#define log_mask(level) ((0xf << (level)) & 0xf)
+
+typedef struct s_log_module {
+
+	const char *file;
+
+	atomic_int mask;
+
+	//
+	// The flag is set if the mask is configured for the module. Otherwise
+	// the mask follows the minimum level.
+	//
+	bool own;
+
+	struct s_log_module *next;
+
+} s_log_module;
+
+static s_log_module _log_module __attribute__((unused)) = { .file = __BASE_FILE__, .mask = LOG_MASK_UNRESOLVED, .own = false, .next = NULL };
+
+#define log_module_enabled(lvl) (atomic_load_explicit(&_log_module.mask, memory_order_relaxed) == LOG_MASK_UNRESOLVED ? log_module_init(&_log_module, lvl) : (atomic_load_explicit(&_log_module.mask, memory_order_relaxed) >> (lvl)) & 1)
+
+#define log_is_enabled(lvl) ((lvl) >= LOG_LEVEL_COMPILE && log_module_enabled(lvl))
+
+/******************************************************************************
+ * The static data of a call site.
+ *****************************************************************************/
+
+typedef struct {
+
+	int level;
+
+	const char *file;
+
+	int line;
+
+	const char *func;
+
+	const char *fmt;
+
+} s_log_site;
+
+/******************************************************************************
+ * A raw argument of a log call. A string argument is copied to the record,
+ * the value is the offset of the copy.
+ *****************************************************************************/
+
+#define LOG_ARG_INT 0
+
+#define LOG_ARG_DBL 1
+
+#define LOG_ARG_STR 2
+
+#define LOG_ARG_PTR 3
+
+typedef struct {
+
+	int type;
+
+	union {
 
-#define log_debug(fmt, ...) fprintf(stderr, "DEBUG %s:%d:%s() " fmt "\n", __FILE__, __LINE__, __func__, ##__VA_ARGS__)
-#define log_debug_str(fmt)  fprintf(stderr, "DEBUG %s:%d:%s() " fmt "\n", __FILE__, __LINE__, __func__)
+		long long i;
+
+		double d;
+
+		const void *p;
+
+		const char *s;
+	};
+
+} s_log_arg;
+
+/******************************************************************************
+ * The record of a log call with the time in nanoseconds of the monotonic
+ * clock, the arguments and the copies of the strings.
+ *****************************************************************************/
+
+#define LOG_ARGS_MAX 10
+
+#define LOG_STR_SIZE 96
+
+typedef struct {
+
+	const s_log_site *site;
+
+	long time;
+
+	int num;
+
+	s_log_arg arg[LOG_ARGS_MAX];
+
+	char str[LOG_STR_SIZE];
+
+} s_log_rec;
+
+/******************************************************************************
+ * The macros convert an argument to a s_log_arg, depending on its type.
+ *****************************************************************************/
+
+#define log_arg(a) _Generic((a),               \
+	_Bool: log_arg_int,                        \
+	char: log_arg_int,                         \
+	signed char: log_arg_int,                  \
+	unsigned char: log_arg_int,                \
+	short: log_arg_int,                        \
+	unsigned short: log_arg_int,               \
+	int: log_arg_int,                          \
+	unsigned int: log_arg_int,                 \
+	long: log_arg_int,                         \
+	unsigned long: log_arg_int,                \
+	long long: log_arg_int,                    \
+	unsigned long long: log_arg_int,           \
+	float: log_arg_dbl,                        \
+	double: log_arg_dbl,                       \
+	long double: log_arg_dbl,                  \
+	char*: log_arg_str,                        \
+	const char*: log_arg_str,                  \
+	default: log_arg_ptr)(a)
+
+#define LOG_NARG(...) LOG_NARG_(__VA_ARGS__, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARG_(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, n, ...) n
+
+#define LOG_MAP_1(a)      log_arg(a)
+#define LOG_MAP_2(a, ...) log_arg(a), LOG_MAP_1(__VA_ARGS__)
+#define LOG_MAP_3(a, ...) log_arg(a), LOG_MAP_2(__VA_ARGS__)
+#define LOG_MAP_4(a, ...) log_arg(a), LOG_MAP_3(__VA_ARGS__)
+#define LOG_MAP_5(a, ...) log_arg(a), LOG_MAP_4(__VA_ARGS__)
+#define LOG_MAP_6(a, ...) log_arg(a), LOG_MAP_5(__VA_ARGS__)
+#define LOG_MAP_7(a, ...) log_arg(a), LOG_MAP_6(__VA_ARGS__)
+#define LOG_MAP_8(a, ...) log_arg(a), LOG_MAP_7(__VA_ARGS__)
+#define LOG_MAP_9(a, ...) log_arg(a), LOG_MAP_8(__VA_ARGS__)
+#define LOG_MAP_10(a, ...) log_arg(a), LOG_MAP_9(__VA_ARGS__)
+
+#define LOG_MAP_(n, ...) LOG_MAP_##n(__VA_ARGS__)
+#define LOG_MAP(n, ...)  LOG_MAP_(n, __VA_ARGS__)
+
+/******************************************************************************
+ * The macros write a record with and without arguments. The dead fprintf()
+ * call lets the compiler check the format and the arguments.
+ *****************************************************************************/
+
+#define log_write(lvl, fmt, ...) do {                                                    \
+	if (log_is_enabled(lvl)) {                                                          \
+		static const s_log_site _log_site = { lvl, __FILE__, __LINE__, __func__, fmt }; \
+		const s_log_arg _log_args[] = { LOG_MAP(LOG_NARG(__VA_ARGS__), __VA_ARGS__) };  \
+		log_record(&_log_site, LOG_NARG(__VA_ARGS__), _log_args);                       \
+	}                                                                                   \
+	if (0) {                                                                            \
+		fprintf(stderr, fmt, __VA_ARGS__);                                              \
+	}                                                                                   \
+} while (0)
+
+#define log_write_str(lvl, fmt) do {                                                     \
+	if (log_is_enabled(lvl)) {                                                          \
+		static const s_log_site _log_site = { lvl, __FILE__, __LINE__, __func__, fmt }; \
+		log_record(&_log_site, 0, NULL);                                                \
+	}                                                                                   \
+} while (0)
+
+/******************************************************************************
+ * Definition of the logging macros for the levels. They print to stderr not
+ * to restrain curses. The trace level is for inner loops, like the cells of
+ * an area or the steps of a move.
+ *****************************************************************************/
+
+#define log_trace(fmt, ...) log_write(LOG_LEVEL_TRACE, fmt, __VA_ARGS__)
+#define log_trace_str(fmt)  log_write_str(LOG_LEVEL_TRACE, fmt)
+
+#define log_debug(fmt, ...) log_write(LOG_LEVEL_DEBUG, fmt, __VA_ARGS__)
+#define log_debug_str(fmt)  log_write_str(LOG_LEVEL_DEBUG, fmt)
+
+#define log_info(fmt, ...)  log_write(LOG_LEVEL_INFO, fmt, __VA_ARGS__)
+#define log_info_str(fmt)   log_write_str(LOG_LEVEL_INFO, fmt)
+
+#define log_warn(fmt, ...)  log_write(LOG_LEVEL_WARN, fmt, __VA_ARGS__)
+#define log_warn_str(fmt)   log_write_str(LOG_LEVEL_WARN, fmt)
+
+#ifdef DEBUG
 
 #define DEBUG_USED
 
 #else
 
-#define log_debug(fmt, ...)
-#define log_debug_str(fmt)
-
 //
 // Can be used for function parameters, that are only used in debug mode.
 //
@@ -64,6 +294,32 @@
  * The definition of the functions.
  *****************************************************************************/
 
+void log_init();
+
+void log_free();
+
+void log_flush();
+
+void log_set_level(const int level);
+
+void log_set_module(const char *name, const int level);
+
+int log_module_init(s_log_module *module, const int level);
+
+s_log_arg log_arg_int(const long long value);
+
+s_log_arg log_arg_dbl(const double value);
+
+s_log_arg log_arg_str(const char *value);
+
+s_log_arg log_arg_ptr(const void *value);
+
+void log_record(const s_log_site *site, const int num, const s_log_arg *arg);
+
+void log_rec_init(s_log_rec *rec, const s_log_site *site, const int num, const s_log_arg *arg);
+
+size_t log_rec_format(const s_log_rec *rec, char *buf, const size_t size);
+
 void log_fatal(FILE *stream, const char *fmt, ...);
 
 void log_atexit(void (*exit_callback_ptr)());
@@ -0,0 +1,159 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_LIB_PERF_H_
+#define INC_LIB_PERF_H_
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * The header file defines the performance counters. Each counter has the
+ * number of calls and the time spent in the calls. The counters are
+ * per-thread, so an increment is a relaxed load and store without
+ * contention. The totals are the sums over all threads.
+ *
+ * The counters are compiled with the PERF flag. Without the flag, the macros
+ * expand to nothing.
+ *****************************************************************************/
+
+typedef enum {
+
+	PF_RULES_CAN_MV = 0,
+
+	PF_RULES_UPDATE_PHASE,
+
+	PF_CANVAS_PRINT,
+
+	PF_COLOR_PAIR_GET,
+
+	PF_FRAME_FLUSH,
+
+	PF_ANIM_RENDER,
+
+	PF_CONTROLS_PRINT,
+
+	PF_CANVAS_CELLS,
+
+	PF_TERM_BYTES,
+
+	PF_ENG_NODES,
+
+	PF_ENG_CACHE_HITS,
+
+	PF_NUM
+
+} e_pf_id;
+
+/******************************************************************************
+ * The counters of a thread. The owning thread is the only writer. The
+ * structs are linked, so the totals can be computed without a lock.
+ *****************************************************************************/
+
+typedef struct s_pf_thread {
+
+	atomic_long count[PF_NUM];
+
+	atomic_long ns[PF_NUM];
+
+	struct s_pf_thread *next;
+
+} s_pf_thread;
+
+/******************************************************************************
+ * The totals of the counters.
+ *****************************************************************************/
+
+typedef struct {
+
+	long count[PF_NUM];
+
+	long ns[PF_NUM];
+
+} s_pf_stats;
+
+/******************************************************************************
+ * A scoped timer. The time is added to the counter when the variable goes out
+ * of scope.
+ *****************************************************************************/
+
+typedef struct {
+
+	e_pf_id id;
+
+	long start;
+
+} s_pf_scope;
+
+/******************************************************************************
+ * The definitions of the macros. pf_count() increments the number of calls
+ * and pf_count_add() adds a number, for example of bytes. pf_scope()
+ * additionally measures the time until the end of the block.
+ *****************************************************************************/
+
+extern _Thread_local s_pf_thread *_pf_thread;
+
+#define pf_thread() (_pf_thread != NULL ? _pf_thread : pf_thread_new())
+
+#define pf_add(counter, num) atomic_store_explicit(&(counter), atomic_load_explicit(&(counter), memory_order_relaxed) + (num), memory_order_relaxed)
+
+#ifdef PERF
+
+#define pf_count(id) pf_add(pf_thread()->count[id], 1)
+
+#define pf_count_add(id, num) pf_add(pf_thread()->count[id], num)
+
+#define pf_scope(id) s_pf_scope _pf_scope __attribute__((cleanup(pf_scope_end))) = pf_scope_start(id)
+
+#else
+
+#define pf_count(id) do { } while (0)
+
+#define pf_count_add(id, num) do { } while (0)
+
+#define pf_scope(id)
+
+#endif
+
+/******************************************************************************
+ * The definitions of the functions.
+ *****************************************************************************/
+
+s_pf_thread* pf_thread_new();
+
+s_pf_scope pf_scope_start(const e_pf_id id);
+
+void pf_scope_end(const s_pf_scope *scope);
+
+const char* e_pf_id_str(const e_pf_id id);
+
+void pf_stats(s_pf_stats *stats);
+
+void pf_request_dump();
+
+bool pf_is_dump_requested();
+
+void pf_log_stats();
+
+#endif /* INC_LIB_PERF_H_ */
@@ -0,0 +1,133 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_LIB_POOL_H_
+#define INC_LIB_POOL_H_
+
+/******************************************************************************
+ * The header file provides a work-stealing thread pool, which is shared by
+ * all features, that run on worker threads (computer player, pondering and
+ * hints). So the number of threads does not depend on the number of
+ * features, that run at the same time.
+ *
+ * Each worker has a Chase-Lev deque. Tasks that are spawned on a worker are
+ * pushed to its deque, tasks from other threads are queued in a shared
+ * queue. An idle worker takes the tasks from its deque, from the shared
+ * queue and steals tasks from the other workers.
+ *
+ * Tasks are spawned in a group, which is a fork / join unit with a cancel
+ * flag. The flag is a cooperative cancellation token, the tasks have to
+ * check it (for example as the cancel flag of an engine budget).
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/******************************************************************************
+ * The maximum number of workers and the capacity of the deque of a worker.
+ *****************************************************************************/
+
+#define TP_WORKERS_MAX 8
+
+#define TP_DEQUE_SIZE 256
+
+/******************************************************************************
+ * The group of tasks: the number of tasks, that are not finished and the
+ * cancel flag.
+ *****************************************************************************/
+
+typedef struct {
+
+	atomic_int pending;
+
+	atomic_bool cancel;
+
+} s_tp_group;
+
+/******************************************************************************
+ * The task is a function with an argument. The memory of the task is owned by
+ * the caller and has to be valid until the group is joined.
+ *****************************************************************************/
+
+typedef struct s_tp_task {
+
+	void (*fct)(void *arg);
+
+	void *arg;
+
+	s_tp_group *group;
+
+	//
+	// The next task in the shared queue.
+	//
+	struct s_tp_task *next;
+
+} s_tp_task;
+
+/******************************************************************************
+ * The statistics of a worker: the number of executed tasks, the number of
+ * stolen tasks, the current and the maximum depth of the deque.
+ *****************************************************************************/
+
+typedef struct {
+
+	long tasks;
+
+	long steals;
+
+	long depth;
+
+	long depth_max;
+
+} s_tp_stats;
+
+/******************************************************************************
+ * The definitions of the functions.
+ *****************************************************************************/
+
+void tp_init(const int workers, const bool pin);
+
+void tp_free();
+
+int tp_workers();
+
+bool tp_is_worker();
+
+void tp_group_init(s_tp_group *group);
+
+void tp_spawn(s_tp_group *group, s_tp_task *task, void (*fct)(void *arg), void *arg);
+
+void tp_group_cancel(s_tp_group *group);
+
+bool tp_group_is_cancelled(s_tp_group *group);
+
+bool tp_group_is_done(s_tp_group *group);
+
+void tp_group_wait(s_tp_group *group);
+
+void tp_stats(const int idx, s_tp_stats *stats);
+
+void tp_log_stats();
+
+#endif /* INC_LIB_POOL_H_ */
@@ -0,0 +1,61 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef INC_LOOP_H_
+#define INC_LOOP_H_
+
+/******************************************************************************
+ * The header file provides an interface to the event loop. The loop waits
+ * with poll() for input on stdin, for a timer (the next animation frame) and
+ * for results of background workers.
+ *****************************************************************************/
+
+/******************************************************************************
+ * The sources of the loop, which are returned as a bit mask.
+ *****************************************************************************/
+
+#define LOOP_INPUT  0x01
+
+#define LOOP_TIMER  0x02
+
+#define LOOP_WORKER 0x04
+
+/******************************************************************************
+ * Definition of functions and macros.
+ *****************************************************************************/
+
+void loop_init();
+
+void loop_free();
+
+void loop_set_timer(const int timeout_ms);
+
+int loop_wait();
+
+void loop_wake();
+
+void loop_log_stats();
+
+#endif /* INC_LOOP_H_ */
@@ -25,9 +25,8 @@
 #ifndef INC_NC_BOARD_H_
 #define INC_NC_BOARD_H_
 
-#include <ncurses.h>
-
 #include "bg_defs.h"
+#include "s_canvas.h"
 #include "s_fieldset.h"
 #include "s_point_layout.h"
 #include "s_game_cfg.h"
@@ -37,16 +36,18 @@
  * Function definitions that are only used for unit tests.
  *****************************************************************************/
 
-void nc_board_init(WINDOW *win, const s_game_cfg *game_cfg, const s_board_areas *board_areas);
+void nc_board_init(const s_canvas *canvas, const s_game_cfg *game_cfg, const s_board_areas *board_areas);
 
 void nc_board_free();
 
 void nc_board_print_win();
 
+void nc_board_print_rows(const bool *rows);
+
 void nc_board_points_add_checker(s_fieldset *fieldset);
 
 void nc_board_reset(s_fieldset *fieldset);
 
-void nc_board_process(s_status *status, s_fieldset *fieldset, const s_field_id field);
+bool nc_board_process(s_status *status, s_fieldset *fieldset, const s_field_id field);
 
 #endif /* INC_NC_BOARD_H_ */
@@ -0,0 +1,49 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_OVERLAY_H_
+#define INC_OVERLAY_H_
+
+/******************************************************************************
+ * The header file provides an interface to the performance overlay. The
+ * overlay is a small window, that shows the frame time, the frame rate, the
+ * cells and bytes per frame, the color pairs and the speed of the engine.
+ * It can be toggled while playing.
+ *****************************************************************************/
+
+#include <stdbool.h>
+
+/******************************************************************************
+ * The definitions of the functions.
+ *****************************************************************************/
+
+void overlay_init(const bool bytes);
+
+bool overlay_toggle();
+
+bool overlay_tick();
+
+int overlay_timeout();
+
+#endif /* INC_OVERLAY_H_ */
@@ -25,10 +25,9 @@
 #ifndef INC_S_BOARD_H_
 #define INC_S_BOARD_H_
 
-#include <ncurses.h>
-
 #include "lib_s_point.h"
 #include "s_tarr.h"
+#include "s_canvas.h"
 
 /******************************************************************************
  * The struct contains the data necessary for the board.
@@ -36,6 +35,9 @@
  * We have two two-dimensional arrays, which represents the foreground and the
  * background. The background contains the board and the foreground the
  * checkers on the board. So the foreground is mostly transparent.
+ *
+ * The highlight layer is an overlay above the foreground. It marks the fields
+ * that can be used for a move and is also mostly transparent.
  *****************************************************************************/
 
 typedef struct {
@@ -51,9 +53,20 @@ typedef struct {
 	s_tarr *bg;
 
 	//
-	// The window of the board.
+	// The s_tarr with the highlight overlay.
+	//
+	s_tarr *hl;
+
+	//
+	// The arena for the arrays of the board and the templates. All of them
+	// are released together.
 	//
-	WINDOW *win;
+	s_arena *arena;
+
+	//
+	// The canvas of the board, which is a window or a headless cell buffer.
+	//
+	s_canvas canvas;
 
 } s_board;
 
@@ -61,16 +74,16 @@ typedef struct {
  * Definition of functions and macros.
  *****************************************************************************/
 
-void s_board_init(WINDOW *win, s_board *board, const s_point dim);
+void s_board_init(const s_canvas *canvas, s_board *board, const s_point dim);
 
 void s_board_free(s_board *board);
 
-void s_board_win_refresh(const s_board *board, const bool do_sleep);
+void s_board_mark(const s_board *board);
 
-void s_board_trv_del(const s_board *board, const s_tarr *tmpl, const s_point tmpl_pos);
+void s_board_print_area(const s_board *board, const s_point pos, const s_point dim);
 
-void s_board_trv_mv_line(const s_board *board, const s_tarr *tmpl, s_point *tmpl_pos, const s_point target);
+void s_board_trv_print(const s_board *board, const s_tarr *tmpl, const s_point tmpl_pos);
 
-void s_board_trv_mv_to(const s_board *board, const s_tarr *tmpl, s_point *tmpl_pos, const e_dir dir);
+void s_board_trv_del(const s_board *board, const s_tarr *tmpl, const s_point tmpl_pos);
 
 #endif /* INC_S_BOARD_H_ */
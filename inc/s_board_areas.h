@@ -87,6 +87,8 @@ const s_board_areas* s_board_areas_init();
 
 const s_pos* s_board_areas_get_points();
 
+s_pos s_board_areas_get_field(const s_field_id field_id);
+
 s_pos s_board_areas_get_checker(const s_field_id field_id);
 
 void s_board_areas_mouse_target(const s_point mouse, s_field_id *field_id);
@@ -0,0 +1,96 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_S_CANVAS_H_
+#define INC_S_CANVAS_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <ncurses.h>
+
+#include "lib_s_point.h"
+#include "s_tarr.h"
+
+/******************************************************************************
+ * A canvas is the target of the rendering. It is either a curses window or an
+ * area of an in-memory cell buffer (headless). The cell buffer is a s_tarr,
+ * which can be shared by several canvases, each with its own position. So the
+ * board and the controls can be composited in a single buffer, without a
+ * terminal and without calling initscr().
+ *****************************************************************************/
+
+typedef enum {
+
+	E_CANVAS_CURSES, E_CANVAS_CELLS
+
+} e_canvas_type;
+
+typedef struct {
+
+	e_canvas_type type;
+
+	//
+	// The window of a curses canvas.
+	//
+	WINDOW *win;
+
+	//
+	// The cell buffer of a headless canvas and the position of the canvas
+	// inside the buffer.
+	//
+	s_tarr *cells;
+
+	s_point pos;
+
+} s_canvas;
+
+/******************************************************************************
+ * The character of a cell that was printed empty.
+ *****************************************************************************/
+
+#define S_TCHAR_EMPTY (s_tchar ) { L' ', -1, -1 }
+
+/******************************************************************************
+ * The definitions of the functions.
+ *****************************************************************************/
+
+void s_canvas_init_curses(s_canvas *canvas, WINDOW *win);
+
+void s_canvas_init_cells(s_canvas *canvas, s_tarr *cells, const s_point pos);
+
+void s_canvas_mark(const s_canvas *canvas);
+
+void s_canvas_print_area(const s_canvas *canvas, const s_tarr *ta_fg, const s_tarr *ta_bg, const s_point pos, const s_point dim);
+
+void s_canvas_print_overlay(const s_canvas *canvas, const s_tarr *ta_ov, const s_tarr *ta_fg, const s_tarr *ta_bg, const s_point pos, const s_point dim);
+
+void s_canvas_print(const s_canvas *canvas, const s_tarr *tarr, const s_point pos);
+
+void s_canvas_print_empty(const s_canvas *canvas, const s_point dim, const s_point pos);
+
+size_t s_canvas_present(FILE *stream, const s_tarr *cells, s_tarr *prev, const s_point visible, const bool palette_256);
+
+size_t s_canvas_dump(FILE *stream, const s_tarr *cells, const bool ansi);
+
+#endif /* INC_S_CANVAS_H_ */
@@ -44,12 +44,6 @@ typedef struct {
 
 #define s_color_def_set(c, cr, cg, cb) (c)->r = (cr) ; (c)->g = (cg) ; (c)->b = (cb)
 
-void s_color_def_gradient(short *colors, const int num, const char *str_start, const char *str_end);
-
-/******************************************************************************
- * Function definitions that are only used for unit tests.
- *****************************************************************************/
-
 int s_color_def_hex_chr(const char c);
 
 void s_color_def_hex_str(s_color_def *color_def, const char *color);
@@ -58,6 +52,4 @@ void s_color_def_hex_dec(s_color_def *color_def);
 
 void s_color_def_gradient_do(const int num, const int i, const s_color_def *start, const s_color_def *end, s_color_def *result);
 
-short s_color_def_hex_create(const char *hex);
-
 #endif /* INC_S_COLOR_DEF_H_ */
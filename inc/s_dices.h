@@ -142,6 +142,8 @@ void s_dices_debug(const s_dices *dices);
 
 void s_dices_next(s_dices *dices);
 
+void s_dices_set_not_pos(s_dices *dices);
+
 bool s_dice_toggle_active(s_dices *dices, const int idx);
 
 #endif /* INC_S_DICES_H_ */
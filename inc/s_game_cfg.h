@@ -25,9 +25,17 @@
 #ifndef INC_S_GAME_CFG_H_
 #define INC_S_GAME_CFG_H_
 
+#include <stdbool.h>
+
 #include "bg_defs.h"
 #include "e_owner.h"
 
+/******************************************************************************
+ * The number of color definitions (hex strings) of the game configuration.
+ *****************************************************************************/
+
+#define GAME_CFG_COLORS_NUM 26
+
 /******************************************************************************
  * The definition of various configurations of the game.
  *****************************************************************************/
@@ -110,6 +118,98 @@ typedef struct s_game_cfg {
 	// TODO: currently not used
 	char *clr_ctrl_bg_inactive;
 
+	//
+	// Color: highlights of the fields, that can be moved and the destination
+	// of the field under the mouse.
+	//
+	char *clr_hl_src;
+
+	char *clr_hl_dst;
+
+	//
+	// Color: the text and the background of the hints.
+	//
+	char *clr_hint_fg;
+
+	char *clr_hint_bg;
+
+	//
+	// Animation: the maximum number of frames per second and the duration of
+	// a step of the traveler in milliseconds.
+	//
+	int anim_fps;
+
+	int anim_step_ms;
+
+	//
+	// Colors: the maximum number of colors that are created (0 means that the
+	// number is taken from the terminal) and the tolerance for the red, green
+	// and blue values (0-1000), below which colors share a color id.
+	//
+	int clr_budget;
+
+	short clr_tolerance;
+
+	//
+	// The maximum number of color pairs (0 means that the number is taken from
+	// the terminal). If all are used, the least recently used is recycled.
+	//
+	int clr_pair_budget;
+
+	//
+	// A flag to write truecolor directly to the terminal, if the terminal
+	// supports it. Otherwise curses colors and color pairs are used. The
+	// environment variable BAGA_DIRECT=1 switches it on.
+	//
+	bool clr_direct;
+
+	//
+	// A low bandwidth mode for remote terminals. The gradients are collapsed
+	// to a few solid bands, only the first and the last frame of the
+	// animations are rendered and only the changed cells are written with the
+	// 256 color palette. The environment variable BAGA_LOW_BW=1 switches it
+	// on.
+	//
+	bool low_bw;
+
+	int low_bw_bands;
+
+	//
+	// The level of the computer player (0-3), which defines the depth and
+	// the budget of the search. The environment variable BAGA_BOT_LEVEL
+	// overwrites the value.
+	//
+	int bot_level;
+
+	//
+	// The time budget of the computer player for a move in milliseconds. The
+	// search stops with the best play found so far. A value of 0 uses the
+	// time of the level. The environment variable BAGA_BOT_THINK_MS
+	// overwrites the value.
+	//
+	int bot_think_ms;
+
+	//
+	// A flag to search the plays of the computer player for the next rolls,
+	// while the human player is in turn. The environment variable
+	// BAGA_BOT_PONDER=0 switches it off.
+	//
+	bool bot_ponder;
+
+	//
+	// The number of workers of the thread pool, which is shared by the
+	// computer player, the pondering and the hints. A value of 0 uses the
+	// number of cores minus the core of the ui thread. The environment
+	// variable BAGA_POOL_WORKERS overwrites the value.
+	//
+	int pool_workers;
+
+	//
+	// A flag to pin the workers to the cores. The environment variable
+	// BAGA_POOL_PIN=1 switches it on.
+	//
+	bool pool_pin;
+
 } s_game_cfg;
 
 /******************************************************************************
@@ -118,4 +218,6 @@ typedef struct s_game_cfg {
 
 void s_game_cfg_init(s_game_cfg *game_cfg);
 
+void s_game_cfg_colors(const s_game_cfg *game_cfg, const char *colors[GAME_CFG_COLORS_NUM]);
+
 #endif /* INC_S_GAME_CFG_H_ */
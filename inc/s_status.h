@@ -92,4 +92,6 @@ void s_status_next_dice(s_status *status);
 
 void s_status_undo_reset(s_status *status, s_fieldset *fieldset);
 
+bool s_status_undo_round(s_status *status, s_fieldset *fieldset);
+
 #endif /* INC_S_STATUS_H_ */
@@ -26,21 +26,47 @@
 #define INC_S_TARR_H_
 
 #include <stdbool.h>
-#include <ncurses.h>
+#include <stdalign.h>
 
 #include "lib_s_point.h"
 #include "lib_s_tchar.h"
+#include "lib_arena.h"
 
 /******************************************************************************
- * The structure represents a two dimensional array. The data is stored in a
- * one dimensional array. We have a macro to access an element.
+ * The structure represents a two dimensional array of terminal characters.
+ * The data is stored as a structure of arrays. Each component of the s_tchar
+ * has its own one dimensional array (plane), so rows of a plane can be copied
+ * and filled in one go. We have macros to access the elements.
+ *
+ * The structure and the planes are a single allocation. The planes are
+ * stored in the flexible array member. The rows of the planes are aligned to
+ * LA_ALIGN bytes, so the number of elements of a row (stride) can be larger
+ * than the number of columns.
  *****************************************************************************/
 
 typedef struct {
 
 	s_point dim;
 
-	s_tchar *arr;
+	int stride;
+
+	//
+	// The flag is true if the s_tarr was allocated from an arena. In this
+	// case the memory is released with the arena.
+	//
+	bool in_arena;
+
+	//
+	// The planes with the characters, the foreground and the background
+	// colors.
+	//
+	wchar_t *chr;
+
+	short *fg;
+
+	short *bg;
+
+	alignas(LA_ALIGN) unsigned char data[];
 
 } s_tarr;
 
@@ -50,10 +76,16 @@ typedef struct {
 
 s_tarr* s_tarr_new(const int row, const int col);
 
+s_tarr* s_tarr_new_arena(s_arena *arena, const int row, const int col);
+
 void s_tarr_free(s_tarr **tarr);
 
 void s_tarr_set(s_tarr *tarr, const s_tchar tchar);
 
+void s_tarr_set_area(const s_tarr *ta_target, const s_point dim_area, const s_point pos_area, const s_tchar tchar);
+
+void s_tarr_set_str(const s_tarr *ta_target, const s_point pos, const char *str, const short fg, const short bg);
+
 void s_tarr_del(const s_tarr *ta_target, const s_point dim_del, const s_point pos_del);
 
 void s_tarr_set_gradient(s_tarr *tarr, const wchar_t chr, const short fg_color, const short *bg_colors);
@@ -68,16 +100,34 @@ s_point s_tarr_cp_pos(s_tarr *to_arr, const s_tarr *from_arr, s_point pos, const
 
 s_point s_tarr_ul_pos_get(const s_tarr *tarr, s_point cur_pos, const bool reverse);
 
-void s_tarr_print_area(WINDOW *win, const s_tarr *ta_fg, const s_tarr *ta_bg, const s_point pos, const s_point dim);
+/******************************************************************************
+ * The macros to access the elements of the planes.
+ *****************************************************************************/
+
+#define s_tarr_idx(t,r,c) ((r) * (t)->stride + (c))
 
-void s_tarr_print(WINDOW *win, const s_tarr *tarr, const s_point pos);
+#define s_tarr_chr(t,r,c) ((t)->chr[s_tarr_idx(t,r,c)])
 
-void s_tarr_print_empty(WINDOW *win, const s_point dim, const s_point pos);
+#define s_tarr_fg(t,r,c) ((t)->fg[s_tarr_idx(t,r,c)])
+
+#define s_tarr_bg(t,r,c) ((t)->bg[s_tarr_idx(t,r,c)])
 
 /******************************************************************************
- * The macro to access the elements of the array.
+ * The adapters to access an element as a s_tchar. The get macro returns a
+ * copy of the element, so it can only be used for reading. The set adapter
+ * is an inline function, so a call is a single statement and the s_tchar can
+ * be a compound literal without extra parentheses.
  *****************************************************************************/
 
-#define s_tarr_get(t,r,c) ((t)->arr[ (r) * (t)->dim.col + (c) ])
+#define s_tarr_get(t,r,c) ((s_tchar ) { s_tarr_chr(t,r,c), s_tarr_fg(t,r,c), s_tarr_bg(t,r,c) })
+
+static inline void s_tarr_set_tchar(const s_tarr *tarr, const int row, const int col, const s_tchar tchar) {
+
+	const int idx = s_tarr_idx(tarr, row, col);
+
+	tarr->chr[idx] = tchar.chr;
+	tarr->fg[idx] = tchar.fg;
+	tarr->bg[idx] = tchar.bg;
+}
 
 #endif /* INC_S_TARR_H_ */
@@ -0,0 +1,58 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_S_THEME_H_
+#define INC_S_THEME_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "s_color_def.h"
+#include "s_game_cfg.h"
+
+/******************************************************************************
+ * Definition of functions and macros.
+ *****************************************************************************/
+
+void s_theme_reset();
+
+void s_theme_compile(const s_game_cfg *game_cfg);
+
+const s_color_def* s_theme_ramp(const char *str_start, const char *str_end, const int num);
+
+void s_theme_set_bands(const int bands);
+
+int s_theme_band_idx(const int idx, const int num);
+
+void s_theme_gradient(short *colors, const int num, const char *str_start, const char *str_end);
+
+short s_theme_color_create(const char *hex);
+
+bool s_theme_write(FILE *stream);
+
+bool s_theme_read(FILE *stream);
+
+void s_theme_log_stats();
+
+#endif /* INC_S_THEME_H_ */
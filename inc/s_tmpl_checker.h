@@ -36,7 +36,7 @@
  * Declaration of the functions.
  *****************************************************************************/
 
-void s_tmpl_checker_create(const s_game_cfg *game_cfg);
+void s_tmpl_checker_create(const s_game_cfg *game_cfg, s_arena *arena);
 
 void s_tmpl_checker_free();
 
@@ -0,0 +1,359 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/******************************************************************************
+ * The source file implements the animation of the checker moves. The jobs
+ * are stored in a ring buffer. The first job is the active job. The frame of
+ * the active job is computed from the time that elapsed since the job was
+ * started. The frames are rendered with a callback function, which has to
+ * render a frame starting from the last rendered frame.
+ *
+ * The number of renderings is limited by the frames per second. If the main
+ * loop falls behind, the intermediate frames are skipped.
+ *****************************************************************************/
+
+#include "lib_logging.h"
+#include "lib_utils.h"
+#include "lib_time.h"
+#include "anim.h"
+
+/******************************************************************************
+ * The ring buffer with the jobs. The job at the head is the active job.
+ *****************************************************************************/
+
+static s_anim_job _jobs[ANIM_JOBS_MAX];
+
+static int _head = 0;
+
+static int _num = 0;
+
+#define anim_job_get(i) (&_jobs[(_head + (i)) % ANIM_JOBS_MAX])
+
+/******************************************************************************
+ * The configuration of the animation: the milliseconds for a frame (derived
+ * from the frames per second) and the milliseconds for a step of a job.
+ *****************************************************************************/
+
+static int _frame_ms;
+
+static int _step_ms;
+
+static void (*_render_fct)(const s_anim_job *job, const int idx) = NULL;
+
+//
+// The earliest time, at which the next rendering is allowed.
+//
+static long _next_render = 0;
+
+//
+// If the flag is set, only the first and the last frame of a job are
+// rendered.
+//
+static bool _keyframes = false;
+
+/******************************************************************************
+ * The function initializes the animation with the frames per second, the
+ * duration of a step and the function that renders a frame.
+ *****************************************************************************/
+
+void anim_init(const int fps, const int step_ms, void (*render_fct)(const s_anim_job *job, const int idx)) {
+
+	log_debug("fps: %d step: %d", fps, step_ms);
+
+	_frame_ms = fps > 0 ? 1000 / fps : 0;
+
+	_step_ms = lu_max(step_ms, 1);
+
+	_render_fct = render_fct;
+
+	_head = 0;
+
+	_num = 0;
+}
+
+/******************************************************************************
+ * The function sets the keyframes flag. If it is set, the intermediate frames
+ * of the jobs are dropped, which saves output for slow terminals.
+ *****************************************************************************/
+
+void anim_set_keyframes(const bool keyframes) {
+
+	log_debug("keyframes: %d", keyframes);
+
+	_keyframes = keyframes;
+}
+
+/******************************************************************************
+ * The function renders a frame of the job and stores the index of the
+ * rendered frame.
+ *****************************************************************************/
+
+static void anim_job_render(s_anim_job *job, const int idx) {
+
+	(*_render_fct)(job, idx);
+
+	job->frame_idx = idx;
+}
+
+/******************************************************************************
+ * The function removes the active job from the queue. If the job was not
+ * completely rendered, the last frame is rendered before.
+ *****************************************************************************/
+
+static void anim_job_finish_first() {
+
+	s_anim_job *job = anim_job_get(0);
+
+	if (job->frame_idx < job->num_frames - 1) {
+		anim_job_render(job, job->num_frames - 1);
+	}
+
+	_head = (_head + 1) % ANIM_JOBS_MAX;
+	_num--;
+}
+
+/******************************************************************************
+ * The function returns a new job, which has to be filled with frames and
+ * started. If the queue is full, the active job is finished.
+ *****************************************************************************/
+
+s_anim_job* anim_job_new() {
+
+	if (_num == ANIM_JOBS_MAX) {
+		log_debug_str("Queue is full, finishing the active job.");
+		anim_job_finish_first();
+	}
+
+	s_anim_job *job = anim_job_get(_num);
+
+	job->num_frames = 0;
+	job->frame_idx = -1;
+	job->start = -1;
+
+	return job;
+}
+
+/******************************************************************************
+ * The function adds a frame to the job.
+ *****************************************************************************/
+
+void anim_job_add_frame(s_anim_job *job, const s_anim_frame *frame) {
+
+	if (job->num_frames == ANIM_FRAMES_MAX) {
+		log_exit("Too many frames: %d", job->num_frames);
+	}
+
+	job->frames[job->num_frames++] = *frame;
+}
+
+/******************************************************************************
+ * The function adds the job to the queue. The job has to be the job that was
+ * returned by the last call of anim_job_new().
+ *****************************************************************************/
+
+void anim_job_start(s_anim_job *job) {
+
+#ifdef DEBUG
+
+	//
+	// Ensure that the job is the next free job of the queue.
+	//
+	if (job != anim_job_get(_num)) {
+		log_exit_str("Job is not the next free job!");
+	}
+#endif
+
+	//
+	// A job without frames has nothing to animate.
+	//
+	if (job->num_frames == 0) {
+		log_debug_str("Job has no frames!");
+		return;
+	}
+
+	//
+	// Keep only the first and the last frame. The render function renders
+	// from the last rendered frame, so frames can be skipped.
+	//
+	if (_keyframes && job->num_frames > 2) {
+		job->frames[1] = job->frames[job->num_frames - 1];
+		job->num_frames = 2;
+	}
+
+	_num++;
+
+	log_debug("Job with frames: %d queued: %d", job->num_frames, _num);
+}
+
+/******************************************************************************
+ * The function returns true if there are jobs to animate.
+ *****************************************************************************/
+
+bool anim_is_active() {
+	return _num > 0;
+}
+
+/******************************************************************************
+ * The function returns the number of milliseconds until the next frame is due
+ * or -1 if there is nothing to animate. The value can be used as a timeout
+ * for reading input.
+ *****************************************************************************/
+
+int anim_timeout() {
+
+	if (_num == 0) {
+		return -1;
+	}
+
+	const s_anim_job *job = anim_job_get(0);
+
+	//
+	// A job that was not started yet is due immediately.
+	//
+	if (job->start < 0) {
+		return 0;
+	}
+
+	//
+	// The next frame is due when the index changes, but not earlier than the
+	// frame rate allows.
+	//
+	const long due = lu_max(_next_render, job->start + (long ) (job->frame_idx + 1) * _step_ms);
+
+	return (int) lu_max(due - lt_now_ms(), 0);
+}
+
+/******************************************************************************
+ * The function is called from the main loop. It renders the frame of the
+ * active job that is due. Frames that are already out of date are skipped.
+ * The function returns true if a frame was rendered.
+ *****************************************************************************/
+
+bool anim_tick() {
+
+	if (_num == 0) {
+		return false;
+	}
+
+	const long now = lt_now_ms();
+
+	if (now < _next_render) {
+		return false;
+	}
+
+	bool rendered = false;
+	s_anim_job *job;
+
+	while (_num > 0) {
+
+		job = anim_job_get(0);
+
+		if (job->start < 0) {
+			job->start = now;
+		}
+
+		const int idx = (now - job->start) / _step_ms;
+
+		//
+		// If the job is over, it is finished and the next job is started.
+		//
+		if (idx >= job->num_frames) {
+
+			if (job->frame_idx < job->num_frames - 1) {
+				rendered = true;
+			}
+
+			anim_job_finish_first();
+			continue;
+		}
+
+		if (idx != job->frame_idx) {
+			anim_job_render(job, idx);
+			rendered = true;
+		}
+
+		break;
+	}
+
+	if (rendered) {
+		_next_render = now + _frame_ms;
+	}
+
+	return rendered;
+}
+
+/******************************************************************************
+ * The function renders the next frame of the active job, without respecting
+ * the time. It is used to render all frames without waiting (for example for
+ * benchmarks). The function returns false if there is nothing to animate.
+ *****************************************************************************/
+
+bool anim_step() {
+
+	if (_num == 0) {
+		return false;
+	}
+
+	s_anim_job *job = anim_job_get(0);
+
+	anim_job_render(job, job->frame_idx + 1);
+
+	if (job->frame_idx == job->num_frames - 1) {
+		anim_job_finish_first();
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * The function fast forwards the animation. The last frames of all jobs are
+ * rendered and the queue is empty afterwards.
+ *****************************************************************************/
+
+void anim_finish() {
+
+	log_debug("Finishing jobs: %d", _num);
+
+	while (_num > 0) {
+		anim_job_finish_first();
+	}
+
+	_next_render = 0;
+}
+
+/******************************************************************************
+ * The function removes all jobs without rendering them. This can be used if
+ * the board is reset.
+ *****************************************************************************/
+
+void anim_clear() {
+
+	log_debug("Removing jobs: %d", _num);
+
+	_head = 0;
+	_num = 0;
+
+	_next_render = 0;
+}
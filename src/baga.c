@@ -23,16 +23,34 @@
  */
 
 #include <locale.h>
+#include <signal.h>
+#include <unistd.h>
 
 #include "lib_logging.h"
 #include "lib_curses.h"
 #include "lib_string.h"
+#include "lib_utils.h"
+#include "lib_pool.h"
+#include "lib_perf.h"
 #include "lib_popup.h"
 #include "s_board_areas.h"
 #include "s_fieldset.h"
 #include "nc_board.h"
 #include "layout.h"
 #include "controls.h"
+#include "anim.h"
+#include "hover.h"
+#include "hint.h"
+#include "overlay.h"
+#include "input.h"
+#include "loop.h"
+#include "lib_frame.h"
+#include "lib_color.h"
+#include "lib_color_pair.h"
+#include "direct.h"
+#include "s_theme.h"
+#include "palette.h"
+#include "bot.h"
 
 static const char *headers[] = {
 
@@ -54,18 +72,69 @@ static const char *headers[] = {
 
 NULL };
 
+/******************************************************************************
+ * The flag is set if the colors are written directly to the terminal.
+ *****************************************************************************/
+
+static bool _direct = false;
+
+/******************************************************************************
+ * The flag is set if the play of the computer player was processed. The
+ * round is confirmed, if the animation of the play is finished.
+ *****************************************************************************/
+
+static bool _bot_moved = false;
+
 /******************************************************************************
  * The exit callback function resets the terminal and frees the memory.
  *****************************************************************************/
 
 static void exit_callback() {
 
+	//
+	// Stop a running search before the resources are freed.
+	//
+	bot_free();
+
+	hint_free();
+
+	tp_log_stats();
+
+	tp_free();
+
+	pf_log_stats();
+
+	bot_log_stats();
+
+	lf_frame_log_stats();
+
+	if (_direct) {
+		direct_log_stats();
+		direct_free();
+	}
+
+	loop_log_stats();
+
+	input_log_stats();
+
+	hover_log_stats();
+
+	hint_log_stats();
+
+	s_theme_log_stats();
+
+	col_log_stats();
+
+	cp_log_stats();
+
 	layout_free();
 
 	controls_free();
 
 	nc_board_free();
 
+	loop_free();
+
 	//
 	// Finish ncurses stuff
 	//
@@ -74,6 +143,20 @@ static void exit_callback() {
 	lc_curses_finish();
 }
 
+/******************************************************************************
+ * The signal handler requests a dump of the performance counters. The dump is
+ * written by the main loop, which is woken up.
+ *****************************************************************************/
+
+static void perf_signal_handler(const int sig) {
+
+	(void) sig;
+
+	pf_request_dump();
+
+	loop_wake();
+}
+
 /******************************************************************************
  * The method initializes the application.
  *****************************************************************************/
@@ -97,48 +180,492 @@ static void init() {
 	//
 	lc_curses_init();
 
-	lc_mouse_init(BUTTON1_PRESSED | REPORT_MOUSE_POSITION, true);
+	lc_mouse_init(BUTTON1_PRESSED | BUTTON1_RELEASED | REPORT_MOUSE_POSITION, true);
+
+	//
+	// The event loop waits for input, timers and workers.
+	//
+	loop_init();
+
+	//
+	// SIGUSR1 dumps the performance counters of the running game.
+	//
+	struct sigaction action = { 0 };
+	action.sa_handler = perf_signal_handler;
+	sigemptyset(&action.sa_mask);
+
+	if (sigaction(SIGUSR1, &action, NULL) != 0) {
+		log_exit_str("Unable to register signal handler!");
+	}
+}
+
+/******************************************************************************
+ * The function is the regular shutdown of the game, which is used by the menu
+ * and the main loop. It writes the palette, so the next start can use it. The
+ * exit callback does the rest of the cleanup.
+ *****************************************************************************/
+
+static void shutdown_game() {
+
+	palette_save();
+
+	exit(EXIT_SUCCESS);
 }
 
 /******************************************************************************
  *
  *****************************************************************************/
 
-void show_menu() {
+void show_menu(const s_game_cfg *game_cfg) {
 	log_debug_str("Showing start menu");
 
 	//
 	// Initialize the choices array.
 	//
-	const char *choices[3] = { "New Game", "Exit" };
+	const char *choices[4] = { "New Game", "New Game vs Computer", "Exit" };
 
 	//
 	// Process the menu (the second parameter is a flag to ignore ESC)
 	//
 	const int idx = lp_process_menu(headers, choices, 0, true);
 
-	if (idx == 1) {
-		exit(EXIT_SUCCESS);
+	if (idx == 2) {
+		shutdown_game();
 
 	} else if (idx == 0) {
 		log_debug_str("New game!");
 
+	} else if (idx == 1) {
+		log_debug_str("New game vs computer!");
+
+		//
+		// The human player starts.
+		//
+		bot_set_owner(e_owner_other(game_cfg->owner_start));
+
 	} else {
 		log_exit("Unknown index: %d", idx);
 	}
 }
 
+/******************************************************************************
+ * The function is called if the rules reject a step of a play of the engine.
+ * The engine and the rules should not disagree, but the game should not end
+ * in this case. The function moves the first checker (from the view of the
+ * player), that the rules accept, for each remaining dice, until no checker
+ * can be moved.
+ *****************************************************************************/
+
+static void process_play_rules(s_status *status, s_fieldset *fieldset) {
+
+	while (!s_status_need_confirm(status)) {
+
+		if (!nc_board_process(status, fieldset, eng_step_field_id(status->turn, ENG_SRC_BAR))) {
+
+			int src = POINTS_NUM - 1;
+
+			while (src >= 0 && !nc_board_process(status, fieldset, eng_step_field_id(status->turn, src))) {
+				src--;
+			}
+
+			if (src < 0) {
+				return;
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * The function processes a play of the engine, which is the play of the
+ * computer player or a hint. The steps are processed like mouse clicks, so
+ * the checkers are animated. If the rules reject a step, the rest of the play
+ * is discarded and the remaining dices are played by the rules. The dices,
+ * that cannot be used, are marked as not possible.
+ *****************************************************************************/
+
+static void process_play(s_status *status, s_fieldset *fieldset, const s_eng_play *play) {
+
+	if (_direct) {
+		direct_move_start();
+	}
+
+	if (play->dice_first == 1) {
+		s_dice_toggle_active(&status->dices, 1);
+	}
+
+	for (int i = 0; i < play->num; i++) {
+
+		if (!nc_board_process(status, fieldset, eng_step_field_id(status->turn, play->src[i]))) {
+			log_warn("Step: %d src: %d is not valid - play by the rules!", i, play->src[i]);
+			process_play_rules(status, fieldset);
+			break;
+		}
+	}
+
+	if (!s_status_need_confirm(status)) {
+		s_dices_set_not_pos(&status->dices);
+	}
+
+	controls_print(status);
+
+	input_state_changed();
+}
+
+/******************************************************************************
+ * The function shows or hides the hints. The plays are ranked for the
+ * position at the start of the round, so the moves, that are already done,
+ * do not change the hints.
+ *****************************************************************************/
+
+static void process_hint_toggle(const s_status *status) {
+	s_status status_round;
+	s_fieldset fieldset_round;
+
+	if (hint_is_active()) {
+		hint_cancel();
+		return;
+	}
+
+	if (bot_is_turn(status) || s_status_is_end(status)) {
+		return;
+	}
+
+	s_status_undo_reset(&status_round, &fieldset_round);
+
+	//
+	// The pondering is paused while the hint is shown, so the ranking does
+	// not wait for the rolls on the workers.
+	//
+	bot_ponder_pause();
+
+	hint_start(&status_round, &fieldset_round);
+}
+
+/******************************************************************************
+ * The function shows or hides the performance overlay. Curses does not know
+ * the cells of the direct output, so they are written again, if the overlay
+ * is hidden.
+ *****************************************************************************/
+
+static void process_overlay_toggle() {
+
+	if (!overlay_toggle() && _direct) {
+		direct_invalidate();
+	}
+}
+
+/******************************************************************************
+ * The function returns the minimum of two timeouts, where a negative timeout
+ * means that nothing is due.
+ *****************************************************************************/
+
+static int timeout_min(const int timeout_1, const int timeout_2) {
+	return timeout_1 < 0 ? timeout_2 : timeout_2 < 0 ? timeout_1 : lu_min(timeout_1, timeout_2);
+}
+
+/******************************************************************************
+ * The function plays a hint. The moves of the round are undone and the play
+ * of the hint is processed. The round has to be confirmed by the player.
+ *****************************************************************************/
+
+static void process_hint_play(s_status *status, s_fieldset *fieldset, const int idx) {
+	s_eng_play play;
+
+	if (bot_is_turn(status) || !hint_get(idx, &play)) {
+		return;
+	}
+
+	hint_cancel();
+
+	s_status_undo_reset(status, fieldset);
+
+	nc_board_reset(fieldset);
+
+	process_play(status, fieldset, &play);
+}
+
+/******************************************************************************
+ * The function processes the round of the computer player. The search is
+ * started, if the bot is in turn. If the play is ready, it is processed and
+ * the round is confirmed after the animation. If the human player is in
+ * turn, the bot ponders.
+ *****************************************************************************/
+
+static void process_bot(s_status *status, s_fieldset *fieldset) {
+	s_eng_play play;
+
+	if (s_status_is_end(status)) {
+		return;
+	}
+
+	//
+	// While the human player is in turn, the bot ponders the current
+	// position, unless a hint is shown.
+	//
+	if (!bot_is_turn(status)) {
+
+		if (!hint_is_active()) {
+			bot_ponder(fieldset);
+		}
+
+		return;
+	}
+
+	if (_bot_moved) {
+
+		if (!anim_is_active()) {
+			_bot_moved = false;
+
+			s_status_do_confirm(status, fieldset);
+			controls_print(status);
+
+			input_state_changed();
+		}
+
+		return;
+	}
+
+	if (bot_get_play(&play)) {
+		process_play(status, fieldset, &play);
+		_bot_moved = true;
+
+	} else if (!bot_is_thinking()) {
+		bot_start(status, fieldset);
+	}
+}
+
+/******************************************************************************
+ * The function checks if the player in turn can move a checker with one of
+ * the dices, that are not set. If not, the dices are marked as not possible,
+ * so the player can confirm the round.
+ *****************************************************************************/
+
+static void process_pass(s_status *status, const s_fieldset *fieldset) {
+	s_eng_pos pos;
+
+	if (bot_is_turn(status) || s_status_is_end(status) || s_status_need_confirm(status)) {
+		return;
+	}
+
+	eng_pos_init(&pos, fieldset, status->turn);
+
+	for (int idx = 0; idx < 2; idx++) {
+
+		if (s_dices_has_status(status->dices, idx, E_DICE_SET)) {
+			continue;
+		}
+
+		if (eng_can_move(&pos, status->dices.dice[idx].value)) {
+			return;
+		}
+	}
+
+	log_debug_str("No move possible!");
+
+	s_dices_set_not_pos(&status->dices);
+
+	controls_print(status);
+
+	input_state_changed();
+}
+
+/******************************************************************************
+ * The function processes a mouse event.
+ *****************************************************************************/
+
+static void process_mouse(s_status *status, s_fieldset *fieldset, const s_input_event *event) {
+	s_point m_event;
+	s_field_id field_id;
+
+	if (input_is_click(event)) {
+
+		//
+		// A click, that was read before the state changed, is ignored.
+		//
+		if (input_is_stale(event)) {
+			return;
+		}
+
+		//
+		// If the computer player is in turn, the human player can only undo
+		// the last round, which cancels the search.
+		//
+		if (bot_is_turn(status)) {
+
+			if (lc_event_stdscr_to_win(layout_win_dice(), event->mouse.y, event->mouse.x, &m_event) && controls_is_undo(&m_event) && s_status_undo_round(status, fieldset)) {
+
+				bot_cancel();
+				_bot_moved = false;
+
+				nc_board_reset(fieldset);
+				controls_print(status);
+
+				input_state_changed();
+			}
+
+			return;
+		}
+
+		if (lc_event_stdscr_to_win(layout_win_board(), event->mouse.y, event->mouse.x, &m_event)) {
+
+			// TODO: check if a dice is active (this is done but not obvious from the macro name).
+			if (s_status_need_confirm(status)) {
+				return;
+			}
+
+			s_board_areas_mouse_target(m_event, &field_id);
+
+			if (field_id.type != E_FIELD_NONE) {
+
+				if (_direct) {
+					direct_move_start();
+				}
+
+				if (nc_board_process(status, fieldset, field_id)) {
+					input_state_changed();
+				}
+			}
+
+		} else if (lc_event_stdscr_to_win(layout_win_dice(), event->mouse.y, event->mouse.x, &m_event)) {
+
+			if (controls_process_event(status, fieldset, &m_event)) {
+				bot_cancel();
+				nc_board_reset(fieldset);
+			}
+
+			//
+			// The controls may change the dices or the player.
+			//
+			input_state_changed();
+		}
+
+	} else if (input_is_motion(event)) {
+
+		//
+		// Mouse motion only sets the hovered field, the highlights are
+		// redrawn with the next tick.
+		//
+		if (lc_event_stdscr_to_win(layout_win_board(), event->mouse.y, event->mouse.x, &m_event)) {
+			s_board_areas_mouse_target(m_event, &field_id);
+
+		} else {
+			s_field_id_set(field_id, E_FIELD_NONE, FIELD_NONE_IDX);
+		}
+
+		hover_set(field_id);
+	}
+}
+
+/******************************************************************************
+ * The function processes an event. It returns false if the program should
+ * exit.
+ *****************************************************************************/
+
+static bool process_event(s_status *status, s_fieldset *fieldset, const s_input_event *event) {
+
+	const int c = event->key;
+
+	//
+	// Exit with 'q'
+	//
+	if (c == 'q') {
+		return false;
+	}
+
+	//
+	// A key press fast forwards the animation.
+	//
+	if (c != KEY_MOUSE && anim_is_active()) {
+		log_debug_str("Fast forward the animation.");
+		anim_finish();
+	}
+
+	switch (c) {
+
+	case KEY_MOUSE:
+		process_mouse(status, fieldset, event);
+		break;
+
+	case KEY_RESIZE:
+		log_debug_str("reseize");
+
+		if (_direct) {
+			direct_resize((s_point ) { .row = LINES, .col = COLS });
+		}
+
+		nc_board_print_win();
+		break;
+
+	case 27:
+		log_debug_str("esc");
+		hint_cancel();
+		break;
+
+	case 'h':
+		process_hint_toggle(status);
+		break;
+
+	case 'p':
+		process_overlay_toggle();
+		break;
+
+	case '1':
+	case '2':
+	case '3':
+	case '4':
+	case '5':
+		process_hint_play(status, fieldset, c - '1');
+		break;
+
+	case KEY_UP:
+		log_debug_str("KEY_UP");
+		break;
+
+	case KEY_DOWN:
+		log_debug_str("KEY_DOWN");
+		break;
+
+	case KEY_LEFT:
+		log_debug_str("KEY_LEFT");
+		break;
+
+	case KEY_RIGHT:
+		log_debug_str("KEY_RIGHT");
+		break;
+
+	case '\t':
+		log_debug_str("tab");
+		break;
+
+	case 10:
+		log_debug_str("enter");
+		break;
+
+	default:
+		log_debug("Pressed key %d (%s)", c, keyname(c));
+		break;
+	}
+
+	return true;
+}
+
 /******************************************************************************
  * The main function.
  *****************************************************************************/
 
 int main() {
 	s_status status;
-	s_point m_event;
 	s_game_cfg game_cfg;
 
-	MEVENT event;
-	s_field_id field_id;
+	log_init();
+
+	//
+	// Without a redirection of stderr, the log lines would corrupt the
+	// screen. A level from the environment is used anyway.
+	//
+	if (isatty(STDERR_FILENO) && getenv("BAGA_LOG_LEVEL") == NULL) {
+		log_set_level(LOG_LEVEL_OFF);
+	}
 
 	log_debug_str("Starting baga...");
 
@@ -147,6 +674,31 @@ int main() {
 	// TODO: sort init functions
 	s_game_cfg_init(&game_cfg);
 
+	//
+	// With direct output, the colors are not initialized with curses. The low
+	// bandwidth mode uses the direct output with the 256 color palette, so
+	// only the changed cells are written. If the terminal has less colors,
+	// the low bandwidth mode uses curses.
+	//
+	const bool palette_256 = game_cfg.low_bw && COLORS >= 256;
+
+	_direct = palette_256 || (game_cfg.clr_direct && direct_is_supported());
+
+	log_info("Direct output: %s low bandwidth: %s", ls_bool_str(_direct), ls_bool_str(game_cfg.low_bw));
+
+	s_theme_set_bands(game_cfg.low_bw ? game_cfg.low_bw_bands : 0);
+
+	col_set_headless(_direct);
+
+	col_init(game_cfg.clr_budget, game_cfg.clr_tolerance);
+
+	cp_init(game_cfg.clr_pair_budget);
+
+	//
+	// Read the palette from the cache or compile the theme.
+	//
+	palette_load(&game_cfg, _direct);
+
 	s_dices_init();
 
 	s_status_init(&status, &game_cfg);
@@ -155,19 +707,63 @@ int main() {
 
 	layout_init(board_areas->board_dim, (s_point ) { .row = D_ROWS, .col = D_COLS * 4 + D_PAD * 3 });
 
-	controls_init(&game_cfg, layout_win_dice());
+	//
+	// Cells with a recycled color pair are repaired in the layout windows.
+	//
+	cp_set_evict_fct(layout_evict_pair);
+
+	s_canvas canvas_dice;
+	s_canvas canvas_board;
+
+	if (_direct) {
+		direct_init(stdout, (s_point ) { .row = LINES, .col = COLS }, palette_256);
+
+		s_canvas_init_cells(&canvas_dice, direct_cells(), (s_point ) { getbegy(layout_win_dice()), getbegx(layout_win_dice()) });
+		s_canvas_init_cells(&canvas_board, direct_cells(), (s_point ) { getbegy(layout_win_board()), getbegx(layout_win_board()) });
+
+	} else {
+		s_canvas_init_curses(&canvas_dice, layout_win_dice());
+		s_canvas_init_curses(&canvas_board, layout_win_board());
+	}
+
+	controls_init(&game_cfg, &canvas_dice);
+
+	//
+	// The overlay is hidden until it is toggled. The bytes are only counted
+	// by the direct output.
+	//
+	overlay_init(_direct);
 
 	//
 	// Initialize the ncurses board function
 	//
-	nc_board_init(layout_win_board(), &game_cfg, board_areas);
+	nc_board_init(&canvas_board, &game_cfg, board_areas);
 
 	//
 	// Write the whole windows.
 	//
 	wrefresh(stdscr);
 
-	show_menu();
+	//
+	// The ui thread needs one core, the others are used by the workers. Two
+	// workers are the minimum, so the rolls of the pondering are searched in
+	// parallel. A hint pauses the pondering, so it does not wait for a roll.
+	//
+	const int workers = game_cfg.pool_workers > 0 ? game_cfg.pool_workers : lu_max(2, (int ) sysconf(_SC_NPROCESSORS_ONLN) - 1);
+
+	tp_init(lu_min(workers, TP_WORKERS_MAX), game_cfg.pool_pin);
+
+	bot_init(&game_cfg);
+
+	show_menu(&game_cfg);
+
+	//
+	// The menu was written by curses, so the direct output has to be written
+	// again.
+	//
+	if (_direct) {
+		direct_invalidate();
+	}
 
 	//
 	// Show dice window
@@ -198,110 +794,110 @@ int main() {
 
 	log_debug_str("Ending baga...");
 
-	for (;;) {
-		int c = wgetch(stdscr);
-
-		//
-		// Exit with 'q'
-		//
-		if (c == 'q') {
-			break;
-		}
-
-		if (c == ERR) {
-			log_debug_str("Nothing happened.");
-			continue;
-		}
-
-		if (c == KEY_RESIZE) {
-
-			log_debug_str("reseize");
-
-			nc_board_print_win();
+	s_input_event events[INPUT_EVENTS_MAX];
 
-		} else if (c == 27) {
-
-			log_debug_str("esc");
+	//
+	// The rows of the board and the flag for the dice, that have to be
+	// printed again, because a color pair was recycled.
+	//
+	const bool *repaint_rows;
+	bool repaint_dice;
 
-		} else {
+	bool running = true;
 
-			switch (c) {
+	while (running) {
 
-			case KEY_MOUSE:
+		//
+		// Start or finish the round of the computer player or mark the dices
+		// of the human player, that cannot be used.
+		//
+		process_bot(&status, &fieldset);
 
-				if (getmouse(&event) != OK) {
+		process_pass(&status, &fieldset);
 
-					//
-					// Report the details of the mouse event.
-					//
-					log_exit("Unable to get mouse event! mask: %s coords: %d/%d/%d", ls_bool_str(event.bstate == 0), event.x, event.y, event.z);
-				}
+		//
+		// Render the animation frame that is due and wait for input until the
+		// next frame is due (or forever if nothing is animated).
+		//
+		anim_tick();
 
-				if (event.bstate & BUTTON1_PRESSED) {
+		//
+		// Redraw the highlights, if the mouse moved or the dices changed.
+		//
+		hover_tick(&status, &fieldset);
 
-					if (lc_event_stdscr_to_win(layout_win_board(), event.y, event.x, &m_event)) {
+		//
+		// Redraw the hints, if the ranking is updated.
+		//
+		hint_tick(&status);
 
-						// TODO: check if a dice is active (this is done but not obvious from the macro name).
-						if (s_status_need_confirm(&status)) {
-							continue;
-						}
+		//
+		// Update the performance overlay, if it is shown and the update is
+		// due.
+		//
+		overlay_tick();
 
-						s_board_areas_mouse_target(m_event, &field_id);
+		//
+		// If a color pair of a visible cell was recycled, the rows with the
+		// cell are printed again. The color pairs of this frame are not
+		// recycled, so the loop ends.
+		//
+		while (layout_take_repaint(&repaint_rows, &repaint_dice)) {
+			nc_board_print_rows(repaint_rows);
 
-						if (field_id.type != E_FIELD_NONE) {
-							nc_board_process(&status, &fieldset, field_id);
-						}
+			if (repaint_dice) {
+				controls_print(&status);
+			}
+		}
 
-					} else if (lc_event_stdscr_to_win(layout_win_dice(), event.y, event.x, &m_event)) {
+		//
+		// Write all windows that changed with a single update to the terminal.
+		//
+		lf_frame_flush();
 
-						if (controls_process_event(&status, &fieldset, &m_event)) {
-							nc_board_reset(&fieldset);
-						}
-					}
+		input_rendered();
 
-					continue;
-				} else {
-					continue;
-				}
+		//
+		// If the animation is finished, the output of the move is complete.
+		//
+		if (_direct && !anim_is_active()) {
+			direct_move_end();
+		}
 
-				break;
+		const int timeout_anim = anim_timeout();
+		const int timeout_hover = hover_timeout();
+		const int timeout_overlay = overlay_timeout();
 
-			case KEY_UP:
-				log_debug_str("KEY_UP");
-				break;
+		//
+		// The timer expires if the next frame is due (or never if nothing is
+		// animated). If the animation of the computer player finished, the
+		// round is confirmed without waiting.
+		//
+		if (_bot_moved && !anim_is_active()) {
+			loop_set_timer(0);
 
-			case KEY_DOWN:
-				log_debug_str("KEY_DOWN");
-				break;
+		} else {
+			loop_set_timer(timeout_min(timeout_min(timeout_anim, timeout_hover), timeout_overlay));
+		}
 
-			case KEY_LEFT:
-				log_debug_str("KEY_LEFT");
-				break;
+		const int ready = loop_wait();
 
-			case KEY_RIGHT:
-				log_debug_str("KEY_RIGHT");
-				break;
+		if (pf_is_dump_requested()) {
+			pf_log_stats();
+		}
 
-			case '\t':
-				log_debug_str("tab");
-				break;
+		//
+		// Read all pending events without blocking.
+		//
+		const int num = (ready & LOOP_INPUT) ? input_read(events, 0) : 0;
 
-			case 10:
-				log_debug_str("enter");
+		for (int i = 0; i < num && running; i++) {
 
-				break;
+			running = process_event(&status, &fieldset, &events[i]);
 
-			default:
-				log_debug("Pressed key %d (%s)", c, keyname(c));
-				continue;
-			}
+			input_processed(&events[i]);
 		}
-
-		//
-		// Do a refresh
-		//
-		// TODO
 	}
 
-	exit(EXIT_SUCCESS);
+	shutdown_game();
 }
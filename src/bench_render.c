@@ -0,0 +1,525 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/******************************************************************************
+ * The program measures the throughput of the rendering. It renders the board,
+ * the traveler animation of checker moves and the controls and reports the
+ * frames per second and the number of bytes, that would be written to the
+ * terminal.
+ *
+ * Usage: bench_render [cells|curses|direct|lowbw] [iterations]
+ *
+ * cells:  the headless backend. The bytes are the size of the ANSI dump of
+ *         the cell buffer for each frame.
+ * direct: the headless backend with the direct truecolor output. The bytes
+ *         are the changed cells, that are written to the terminal.
+ * lowbw:  the direct output in the low bandwidth mode, with collapsed
+ *         gradients, keyframe animations and the 256 color palette. It
+ *         writes about 7 times less bytes per move than curses. Most of the
+ *         remaining bytes are the dices, which are tossed for each turn and
+ *         consist of block characters with 3 bytes each (UTF-8).
+ * curses: ncurses with newterm() writing to a temp file. The bytes are the
+ *         bytes that ncurses writes to the terminal.
+ *
+ * The logging of the DEBUG mode dominates the results, so the program should
+ * be build with: make DEBUG=false bench_render
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+
+#include "lib_logging.h"
+#include "lib_time.h"
+#include "lib_color.h"
+#include "lib_color_pair.h"
+#include "lib_frame.h"
+#include "lib_utils.h"
+#include "s_board_areas.h"
+#include "s_fieldset.h"
+#include "s_status.h"
+#include "nc_board.h"
+#include "layout.h"
+#include "controls.h"
+#include "anim.h"
+#include "direct.h"
+#include "s_theme.h"
+
+/******************************************************************************
+ * The definitions of the backends.
+ *****************************************************************************/
+
+typedef enum {
+
+	E_BACKEND_CELLS, E_BACKEND_CURSES, E_BACKEND_DIRECT, E_BACKEND_LOW_BW
+
+} e_backend;
+
+static const char *_backend_names[] = { "cells", "curses", "direct", "lowbw" };
+
+/******************************************************************************
+ * The default number of iterations for each case.
+ *****************************************************************************/
+
+#define BENCH_ITERATIONS 500
+
+/******************************************************************************
+ * The rows between the board and the controls (same as the layout).
+ *****************************************************************************/
+
+#define BENCH_BORDER_ROW 2
+
+/******************************************************************************
+ * The state of the benchmark: the backend, the cell buffer of the headless
+ * backend, the output file of the curses backend and the stream, that counts
+ * the bytes of the ANSI dumps.
+ *****************************************************************************/
+
+static e_backend _backend;
+
+static s_tarr *_cells = NULL;
+
+static FILE *_out = NULL;
+
+static FILE *_in = NULL;
+
+static FILE *_null = NULL;
+
+//
+// The canvases and the areas of the board, which are used to initialize the
+// board and the controls.
+//
+static s_canvas _canvas_board;
+
+static s_canvas _canvas_dice;
+
+static const s_board_areas *_board_areas = NULL;
+
+//
+// The status, that is used to print the controls again, if a color pair was
+// recycled.
+//
+static const s_status *_status = NULL;
+
+/******************************************************************************
+ * The result of a benchmark case.
+ *****************************************************************************/
+
+typedef struct {
+
+	long frames;
+
+	long moves;
+
+	long bytes;
+
+	long start;
+
+} s_bench;
+
+/******************************************************************************
+ * The function finishes a frame and returns the number of bytes, that the
+ * frame produced.
+ *****************************************************************************/
+
+static long bench_frame() {
+
+	if (_backend == E_BACKEND_CELLS) {
+		return s_canvas_dump(_null, _cells, true);
+	}
+
+	if (_backend == E_BACKEND_DIRECT || _backend == E_BACKEND_LOW_BW) {
+		const long before = direct_bytes();
+		direct_present();
+		return direct_bytes() - before;
+	}
+
+	const long before = ftell(_out);
+
+	const bool *repaint_rows;
+	bool repaint_dice;
+
+	while (layout_take_repaint(&repaint_rows, &repaint_dice)) {
+		nc_board_print_rows(repaint_rows);
+
+		if (repaint_dice) {
+			controls_print(_status);
+		}
+	}
+
+	lf_frame_flush();
+
+	fflush(_out);
+
+	return ftell(_out) - before;
+}
+
+/******************************************************************************
+ * The function starts a benchmark case.
+ *****************************************************************************/
+
+static void bench_start(s_bench *bench) {
+	bench->frames = 0;
+	bench->moves = 0;
+	bench->bytes = 0;
+	bench->start = lt_now_ms();
+}
+
+/******************************************************************************
+ * The function adds a frame to the benchmark case.
+ *****************************************************************************/
+
+static void bench_add_frame(s_bench *bench) {
+	bench->bytes += bench_frame();
+	bench->frames++;
+}
+
+/******************************************************************************
+ * The function prints the result of a benchmark case.
+ *****************************************************************************/
+
+static void bench_print(const s_bench *bench, const char *name) {
+
+	const long ms = lu_max(lt_now_ms() - bench->start, 1);
+
+	printf("%-18s %8ld %8ld %10.1f %12ld %10ld\n", name, bench->frames, ms, bench->frames * 1000.0 / ms, bench->bytes, bench->bytes / lu_max(bench->frames, 1));
+}
+
+/******************************************************************************
+ * The function initializes the curses backend. The terminal is written to a
+ * temp file, so no tty is necessary.
+ *****************************************************************************/
+
+static void bench_init_curses() {
+
+	//
+	// The size of the terminal is taken from the environment.
+	//
+	setenv("LINES", "60", 1);
+	setenv("COLUMNS", "160", 1);
+
+	if ((_out = tmpfile()) == NULL || (_in = fopen("/dev/null", "r")) == NULL) {
+		log_exit_str("Unable to open files!");
+	}
+
+	if (newterm("xterm-256color", _out, _in) == NULL) {
+		log_exit_str("Unable to create terminal!");
+	}
+
+	//
+	// The input is /dev/null, which is always readable. Without disabling the
+	// typeahead check, ncurses would interrupt the updates.
+	//
+	typeahead(-1);
+
+	if (start_color() == ERR) {
+		log_exit_str("Unable to start color!");
+	}
+}
+
+/******************************************************************************
+ * The function initializes the game with the given backend.
+ *****************************************************************************/
+
+static void bench_init(s_game_cfg *game_cfg, s_status *status, s_fieldset *fieldset) {
+
+	if ((_null = fopen("/dev/null", "w")) == NULL) {
+		log_exit_str("Unable to open: /dev/null");
+	}
+
+	s_game_cfg_init(game_cfg);
+
+	game_cfg->low_bw = _backend == E_BACKEND_LOW_BW;
+
+	s_theme_set_bands(game_cfg->low_bw ? game_cfg->low_bw_bands : 0);
+
+	s_theme_compile(game_cfg);
+
+	s_dices_init();
+
+	//
+	// Use a fixed seed to get reproducible dices.
+	//
+	srand(1);
+
+	s_status_init(status, game_cfg);
+
+	const s_board_areas *board_areas = s_board_areas_init();
+
+	_board_areas = board_areas;
+
+	_status = status;
+
+	const s_point dim_dice = { .row = D_ROWS, .col = D_COLS * 4 + D_PAD * 3 };
+
+	if (_backend == E_BACKEND_CURSES) {
+		bench_init_curses();
+
+		layout_init(board_areas->board_dim, dim_dice);
+
+		cp_init(game_cfg->clr_pair_budget);
+		cp_set_evict_fct(layout_evict_pair);
+
+		s_canvas_init_curses(&_canvas_board, layout_win_board());
+		s_canvas_init_curses(&_canvas_dice, layout_win_dice());
+
+	} else {
+		col_set_headless(true);
+
+		const s_point total = { .row = board_areas->board_dim.row + BENCH_BORDER_ROW + dim_dice.row, .col = lu_max(board_areas->board_dim.col, dim_dice.col) };
+
+		if (_backend == E_BACKEND_DIRECT || _backend == E_BACKEND_LOW_BW) {
+			direct_init(_null, total, game_cfg->low_bw);
+			_cells = direct_cells();
+
+		} else {
+			_cells = s_tarr_new(total.row, total.col);
+			s_tarr_set(_cells, S_TCHAR_EMPTY);
+		}
+
+		s_canvas_init_cells(&_canvas_board, _cells, (s_point ) { 0, 0 });
+		s_canvas_init_cells(&_canvas_dice, _cells, (s_point ) { board_areas->board_dim.row + BENCH_BORDER_ROW, lu_center(total.col, dim_dice.col) });
+	}
+
+	col_init(game_cfg->clr_budget, game_cfg->clr_tolerance);
+
+	controls_init(game_cfg, &_canvas_dice);
+
+	nc_board_init(&_canvas_board, game_cfg, board_areas);
+
+	s_fieldset_new_game(fieldset);
+
+	s_status_start(status, fieldset);
+
+	nc_board_points_add_checker(fieldset);
+}
+
+/******************************************************************************
+ * The function frees the resources of the benchmark.
+ *****************************************************************************/
+
+static void bench_free() {
+
+	controls_free();
+
+	nc_board_free();
+
+	if (_backend == E_BACKEND_CURSES) {
+		layout_free();
+		endwin();
+		fclose(_in);
+		fclose(_out);
+
+	} else if (_backend == E_BACKEND_DIRECT || _backend == E_BACKEND_LOW_BW) {
+		direct_free();
+
+	} else {
+		s_tarr_free(&_cells);
+	}
+
+	fclose(_null);
+}
+
+/******************************************************************************
+ * The function measures a full repaint of the board.
+ *****************************************************************************/
+
+static void bench_board(const int iterations) {
+	s_bench bench;
+
+	bench_start(&bench);
+
+	for (int i = 0; i < iterations; i++) {
+		nc_board_print_win();
+		bench_add_frame(&bench);
+	}
+
+	bench_print(&bench, "board repaint");
+}
+
+/******************************************************************************
+ * The function tries to move a checker with the current dices. The bar is
+ * tried first, then the points. The function returns true if a checker was
+ * moved.
+ *****************************************************************************/
+
+static bool bench_move(s_status *status, s_fieldset *fieldset) {
+
+	nc_board_process(status, fieldset, (s_field_id ) { .type = E_FIELD_BAR, .idx = status->turn });
+
+	for (int idx = 0; idx < POINTS_NUM && !anim_is_active(); idx++) {
+		nc_board_process(status, fieldset, (s_field_id ) { .type = E_FIELD_POINTS, .idx = idx });
+	}
+
+	return anim_is_active();
+}
+
+/******************************************************************************
+ * The function measures the traveler animation. Checkers are moved with the
+ * first possible move and all frames of the animation are rendered without
+ * waiting.
+ *****************************************************************************/
+
+static void bench_traveler(s_status *status, s_fieldset *fieldset, const int iterations) {
+	s_bench bench;
+
+	bench_start(&bench);
+
+	for (int i = 0; i < iterations; i++) {
+
+		//
+		// If the game ended, a new game is started.
+		//
+		if (s_status_is_end(status)) {
+			s_fieldset_new_game(fieldset);
+			s_status_start(status, fieldset);
+			nc_board_reset(fieldset);
+		}
+
+		//
+		// If the dices are processed the turn is confirmed.
+		//
+		if (s_status_need_confirm(status)) {
+			s_status_do_confirm(status, fieldset);
+		}
+
+		//
+		// If no move is possible with the dices, the other player continues.
+		//
+		if (!bench_move(status, fieldset)) {
+			status->turn = e_owner_other(status->turn);
+			s_dices_toss(&status->dices);
+			continue;
+		}
+
+		bench.moves++;
+
+		while (anim_step()) {
+			bench_add_frame(&bench);
+		}
+	}
+
+	bench_print(&bench, "traveler");
+
+	printf("%-18s %8ld %8s %10s %12ld %10ld\n", "traveler per move", bench.moves, "", "", bench.bytes, bench.bytes / lu_max(bench.moves, 1));
+}
+
+/******************************************************************************
+ * The function measures the refresh of the controls with new dices.
+ *****************************************************************************/
+
+static void bench_controls(s_status *status, const int iterations) {
+	s_bench bench;
+
+	bench_start(&bench);
+
+	for (int i = 0; i < iterations; i++) {
+		s_dices_toss(&status->dices);
+		controls_print(status);
+		bench_add_frame(&bench);
+	}
+
+	bench_print(&bench, "controls");
+}
+
+/******************************************************************************
+ * The function measures the initialization of the board and the controls,
+ * which computes the gradients and creates the colors. The board is empty
+ * afterwards, so it has to be the last case.
+ *****************************************************************************/
+
+static void bench_startup(const s_game_cfg *game_cfg, const int iterations) {
+	s_bench bench;
+
+	bench_start(&bench);
+
+	for (int i = 0; i < iterations; i++) {
+
+		controls_free();
+		nc_board_free();
+
+		controls_init(game_cfg, &_canvas_dice);
+		nc_board_init(&_canvas_board, game_cfg, _board_areas);
+
+		bench.frames++;
+	}
+
+	bench_print(&bench, "startup");
+}
+
+/******************************************************************************
+ * The main function.
+ *****************************************************************************/
+
+int main(const int argc, const char *argv[]) {
+	s_game_cfg game_cfg;
+	s_status status;
+	s_fieldset fieldset;
+
+	log_init();
+
+	if (setlocale(LC_CTYPE, "") == NULL) {
+		log_exit_str("Unable to set the locale.");
+	}
+
+	//
+	// Without a multi byte locale, the wide characters of the board are not
+	// printed and the results are wrong.
+	//
+	if (MB_CUR_MAX == 1 && setlocale(LC_CTYPE, "C.UTF-8") == NULL) {
+		log_exit_str("Unable to set a UTF-8 locale.");
+	}
+
+	_backend = E_BACKEND_CELLS;
+
+	if (argc > 1 && strcmp(argv[1], "curses") == 0) {
+		_backend = E_BACKEND_CURSES;
+
+	} else if (argc > 1 && strcmp(argv[1], "direct") == 0) {
+		_backend = E_BACKEND_DIRECT;
+
+	} else if (argc > 1 && strcmp(argv[1], "lowbw") == 0) {
+		_backend = E_BACKEND_LOW_BW;
+	}
+
+	const int iterations = argc > 2 ? atoi(argv[2]) : BENCH_ITERATIONS;
+
+	bench_init(&game_cfg, &status, &fieldset);
+
+	printf("backend: %s iterations: %d\n", _backend_names[_backend], iterations);
+	printf("%-18s %8s %8s %10s %12s %10s\n", "case", "frames", "ms", "fps", "bytes", "bytes/frame");
+
+	bench_board(iterations);
+
+	bench_traveler(&status, &fieldset, iterations);
+
+	bench_controls(&status, iterations);
+
+	bench_startup(&game_cfg, iterations);
+
+	bench_free();
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,547 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/******************************************************************************
+ * The source file implements the computer player. A search is started with a
+ * copy of the position as a task of the thread pool, so the worker does not
+ * share data with the ui thread. The only shared data are the state, which
+ * is set by the task if the play is ready, and the cancel flag of the group,
+ * which is set by the ui thread.
+ *
+ * While the human player is in turn, the bot ponders: the best plays for all
+ * 21 rolls are searched for the current position on the workers of the pool.
+ * If the human player confirms the round with this position, the play of the
+ * bot is a lookup in the table of the rolls. Otherwise the pondering is
+ * cancelled and started again with the new position.
+ *****************************************************************************/
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "lib_logging.h"
+#include "lib_pool.h"
+#include "lib_string.h"
+#include "lib_time.h"
+#include "lib_utils.h"
+#include "loop.h"
+#include "bot.h"
+
+/******************************************************************************
+ * The states of the bot. The worker switches from BOT_THINKING to BOT_READY,
+ * all other changes are done by the ui thread.
+ *****************************************************************************/
+
+#define BOT_IDLE     0
+
+#define BOT_THINKING 1
+
+#define BOT_READY    2
+
+static atomic_int _state = BOT_IDLE;
+
+//
+// The search is a task of the pool. The cancel flag of the group cancels the
+// search.
+//
+static s_tp_group _group;
+
+static s_tp_task _task;
+
+/******************************************************************************
+ * The levels of the bot define the budget of a search: the maximum depth in
+ * plies, the time in milliseconds and the maximum number of evaluated
+ * positions (0 means no limit). The search stops with the first exhausted
+ * limit, so the time is the guaranteed response time.
+ *****************************************************************************/
+
+typedef struct {
+
+	int depth;
+
+	int think_ms;
+
+	long nodes;
+
+} s_bot_level;
+
+#define BOT_LEVELS_NUM 4
+
+static const s_bot_level _levels[BOT_LEVELS_NUM] = {
+
+	{ .depth = 0, .think_ms = 0, .nodes = 0 },
+
+	{ .depth = 1, .think_ms = 250, .nodes = 100000 },
+
+	{ .depth = 2, .think_ms = 1000, .nodes = 1000000 },
+
+	{ .depth = 2, .think_ms = 3000, .nodes = 0 }
+};
+
+/******************************************************************************
+ * The owner of the checkers of the bot (E_OWNER_NONE if there is no bot) and
+ * the level with the budget of a search.
+ *****************************************************************************/
+
+static e_owner _owner = E_OWNER_NONE;
+
+static s_bot_level _level;
+
+/******************************************************************************
+ * The input and the output of the worker. The data is written before the
+ * thread is started or before the state is set to BOT_READY.
+ *****************************************************************************/
+
+static s_eng_pos _pos;
+
+static int _dice_1;
+
+static int _dice_2;
+
+static s_eng_play _play;
+
+static s_eng_stats _stats;
+
+static long _think_us;
+
+//
+// The statistics: the number of searches, the number of cancelled searches,
+// the number of evaluated positions and the think times.
+//
+static long _stat_searches = 0;
+
+static long _stat_cancelled = 0;
+
+static long _stat_nodes = 0;
+
+static long _stat_think_us = 0;
+
+static long _stat_think_us_max = 0;
+
+static long _stat_cache_hits = 0;
+
+static long _stat_depths[ENG_DEPTH_MAX + 1] = { 0 };
+
+/******************************************************************************
+ * The pondering: a task spawns a task for each roll on its worker, so the
+ * idle workers steal the rolls. Each task stores the play for its roll in the
+ * table. The done flag of a roll is set after its play is written.
+ *****************************************************************************/
+
+static bool _ponder = false;
+
+static s_tp_group _ponder_group;
+
+static s_tp_task _ponder_task;
+
+static s_tp_task _ponder_tasks[ENG_ROLLS_NUM];
+
+static bool _ponder_running = false;
+
+static bool _ponder_valid = false;
+
+static s_eng_pos _ponder_pos;
+
+static s_eng_play _ponder_plays[ENG_ROLLS_NUM];
+
+static int _ponder_depths[ENG_ROLLS_NUM];
+
+static atomic_bool _ponder_done[ENG_ROLLS_NUM];
+
+static s_eng_stats _ponder_stats[ENG_ROLLS_NUM];
+
+//
+// The statistics of the pondering: the number of positions, the number of
+// lookups, that found a play, that did not find a play and the number of
+// evaluated positions.
+//
+static long _stat_ponders = 0;
+
+static long _stat_ponder_hits = 0;
+
+static long _stat_ponder_misses = 0;
+
+static long _stat_ponder_nodes = 0;
+
+/******************************************************************************
+ * The function initializes the bot with the level from the config. A think
+ * time from the config overwrites the time of the level.
+ *****************************************************************************/
+
+void bot_init(const s_game_cfg *game_cfg) {
+
+	if (game_cfg->bot_level < 0 || game_cfg->bot_level >= BOT_LEVELS_NUM) {
+		log_exit("Unknown bot level: %d", game_cfg->bot_level);
+	}
+
+	_level = _levels[game_cfg->bot_level];
+
+	if (game_cfg->bot_think_ms > 0) {
+		_level.think_ms = game_cfg->bot_think_ms;
+	}
+
+	_ponder = game_cfg->bot_ponder;
+
+	log_info("Level: %d depth: %d think time: %d ms nodes: %ld ponder: %s", game_cfg->bot_level, _level.depth, _level.think_ms, _level.nodes, ls_bool_str(_ponder));
+}
+
+/******************************************************************************
+ * The function returns the budget of a search from the level, which starts
+ * now.
+ *****************************************************************************/
+
+static s_eng_budget bot_budget(const long start, atomic_bool *cancel) {
+
+	return (s_eng_budget ) { .depth = _level.depth, .deadline = _level.think_ms > 0 ? start + _level.think_ms * 1000L : 0, .nodes = _level.nodes, .cancel = cancel };
+}
+
+/******************************************************************************
+ * The function is the task of a roll. It searches the play for the roll,
+ * unless the pondering is cancelled.
+ *****************************************************************************/
+
+static void bot_ponder_roll(void *arg) {
+	s_eng_play play;
+
+	const int idx = (int) (intptr_t) arg;
+
+	const s_eng_roll roll = eng_roll(idx);
+
+	const s_eng_budget budget = bot_budget(lt_now_us(), &_ponder_group.cancel);
+
+	if (!eng_search(&_ponder_pos, roll.dice_1, roll.dice_2, &budget, &play, &_ponder_stats[idx])) {
+		return;
+	}
+
+	_ponder_plays[idx] = play;
+	_ponder_depths[idx] = _ponder_stats[idx].depth;
+
+	atomic_store(&_ponder_done[idx], true);
+}
+
+/******************************************************************************
+ * The function is the task of the pondering. It spawns the tasks of the
+ * rolls in the group of the pondering, so they are pushed to the deque of
+ * the worker.
+ *****************************************************************************/
+
+static void bot_ponder_spawn(void *arg) {
+	(void) arg;
+
+	for (int i = 0; i < ENG_ROLLS_NUM && !tp_group_is_cancelled(&_ponder_group); i++) {
+		tp_spawn(&_ponder_group, &_ponder_tasks[i], bot_ponder_roll, (void*) (intptr_t) i);
+	}
+}
+
+/******************************************************************************
+ * The function cancels the pondering and waits for the tasks.
+ *****************************************************************************/
+
+static void bot_ponder_cancel() {
+
+	if (!_ponder_running) {
+		return;
+	}
+
+	tp_group_cancel(&_ponder_group);
+
+	tp_group_wait(&_ponder_group);
+
+	for (int i = 0; i < ENG_ROLLS_NUM; i++) {
+		_stat_ponder_nodes += _ponder_stats[i].nodes;
+		_stat_cache_hits += _ponder_stats[i].cache_hits;
+	}
+
+	_ponder_running = false;
+}
+
+/******************************************************************************
+ * The function starts the pondering for the position of the fieldset, if the
+ * position changed. It is called while the human player is in turn.
+ *****************************************************************************/
+
+void bot_ponder(const s_fieldset *fieldset) {
+	s_eng_pos pos;
+
+	if (_owner == E_OWNER_NONE || !_ponder) {
+		return;
+	}
+
+	eng_pos_init(&pos, fieldset, _owner);
+
+	if (_ponder_valid && memcmp(&pos, &_ponder_pos, sizeof(s_eng_pos)) == 0) {
+		return;
+	}
+
+	bot_ponder_cancel();
+
+	_ponder_pos = pos;
+	_ponder_valid = true;
+
+	for (int i = 0; i < ENG_ROLLS_NUM; i++) {
+		atomic_store(&_ponder_done[i], false);
+	}
+
+	memset(_ponder_stats, 0, sizeof(_ponder_stats));
+
+	tp_group_init(&_ponder_group);
+
+	tp_spawn(&_ponder_group, &_ponder_task, bot_ponder_spawn, NULL);
+
+	_ponder_running = true;
+
+	_stat_ponders++;
+}
+
+/******************************************************************************
+ * The function stops the pondering, so the workers are free for a hint. The
+ * rolls of a worker are searched one after the other and each roll takes the
+ * think time, so a hint would wait for the rolls otherwise. The plays are
+ * discarded and the pondering starts again with the next call of
+ * bot_ponder().
+ *****************************************************************************/
+
+void bot_ponder_pause() {
+
+	if (!_ponder_running) {
+		return;
+	}
+
+	log_debug_str("Pause pondering");
+
+	bot_ponder_cancel();
+
+	_ponder_valid = false;
+}
+
+/******************************************************************************
+ * The function stops the pondering and looks up the play for the position
+ * and the dices of the search. The function returns true if the play was
+ * found. The depth is the depth of the search of the play.
+ *****************************************************************************/
+
+static bool bot_ponder_lookup(s_eng_play *play, int *depth) {
+
+	if (!_ponder_valid) {
+		return false;
+	}
+
+	bot_ponder_cancel();
+
+	_ponder_valid = false;
+
+	const int idx = eng_roll_idx(_dice_1, _dice_2);
+
+	if (memcmp(&_pos, &_ponder_pos, sizeof(s_eng_pos)) != 0 || !atomic_load(&_ponder_done[idx])) {
+		_stat_ponder_misses++;
+		return false;
+	}
+
+	*play = _ponder_plays[idx];
+	*depth = _ponder_depths[idx];
+
+	_stat_ponder_hits++;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function cancels a running search. It is called with the exit
+ * callback, which can be called from a worker with log_exit(). In this
+ * case the tasks cannot be joined.
+ *****************************************************************************/
+
+void bot_free() {
+
+	if (tp_is_worker()) {
+		return;
+	}
+
+	bot_cancel();
+
+	bot_ponder_cancel();
+}
+
+/******************************************************************************
+ * The function sets the owner of the checkers of the bot. E_OWNER_NONE means
+ * that there is no bot.
+ *****************************************************************************/
+
+void bot_set_owner(const e_owner owner) {
+
+	log_debug("Bot owner: %s", e_owner_str(owner));
+
+	_owner = owner;
+}
+
+/******************************************************************************
+ * The function checks if the bot is the player in turn.
+ *****************************************************************************/
+
+bool bot_is_turn(const s_status *status) {
+
+	return _owner != E_OWNER_NONE && status->turn == _owner;
+}
+
+/******************************************************************************
+ * The function is the task of the search. It searches the play and wakes up
+ * the event loop, if the play is ready.
+ *****************************************************************************/
+
+static void bot_worker(void *arg) {
+	(void) arg;
+
+	const long start = lt_now_us();
+
+	const s_eng_budget budget = bot_budget(start, &_group.cancel);
+
+	if (eng_search(&_pos, _dice_1, _dice_2, &budget, &_play, &_stats)) {
+
+		_think_us = lt_now_us() - start;
+
+		atomic_store(&_state, BOT_READY);
+
+		loop_wake();
+	}
+}
+
+/******************************************************************************
+ * The function starts a search for the player in turn with a copy of the
+ * position and the dices.
+ *****************************************************************************/
+
+void bot_start(const s_status *status, const s_fieldset *fieldset) {
+
+#ifdef DEBUG
+
+	//
+	// Ensure that the last search is finished.
+	//
+	if (atomic_load(&_state) != BOT_IDLE) {
+		log_exit_str("Search is still running!");
+	}
+#endif
+
+	eng_pos_init(&_pos, fieldset, status->turn);
+
+	_dice_1 = status->dices.dice[0].value;
+	_dice_2 = status->dices.dice[1].value;
+
+	//
+	// If the position was pondered, the play is ready.
+	//
+	memset(&_stats, 0, sizeof(s_eng_stats));
+
+	if (bot_ponder_lookup(&_play, &_stats.depth)) {
+
+		_think_us = 0;
+
+		atomic_store(&_state, BOT_READY);
+
+		loop_wake();
+
+		log_debug("Pondered: %d-%d", _dice_1, _dice_2);
+		return;
+	}
+
+	tp_group_init(&_group);
+
+	atomic_store(&_state, BOT_THINKING);
+
+	tp_spawn(&_group, &_task, bot_worker, NULL);
+
+	log_debug("Search started: %d-%d", _dice_1, _dice_2);
+}
+
+/******************************************************************************
+ * The function checks if a search is running or a play is ready.
+ *****************************************************************************/
+
+bool bot_is_thinking() {
+
+	return atomic_load(&_state) != BOT_IDLE;
+}
+
+/******************************************************************************
+ * The function returns true and copies the play, if the search is finished.
+ *****************************************************************************/
+
+bool bot_get_play(s_eng_play *play) {
+
+	if (atomic_load(&_state) != BOT_READY) {
+		return false;
+	}
+
+	tp_group_wait(&_group);
+
+	atomic_store(&_state, BOT_IDLE);
+
+	*play = _play;
+
+	_stat_searches++;
+	_stat_nodes += _stats.nodes;
+	_stat_cache_hits += _stats.cache_hits;
+	_stat_think_us += _think_us;
+	_stat_think_us_max = lu_max(_stat_think_us_max, _think_us);
+	_stat_depths[_stats.depth]++;
+
+	log_debug("Play: %d steps eval: %.2f candidates: %d depth: %d searched: %d nodes: %ld time: %ld us", play->num, play->eval, _stats.candidates, _stats.depth, _stats.searched, _stats.nodes, _think_us);
+
+	return true;
+}
+
+/******************************************************************************
+ * The function cancels the search and waits for the task. A play, that is
+ * ready, is dropped.
+ *****************************************************************************/
+
+void bot_cancel() {
+
+	if (atomic_load(&_state) == BOT_IDLE) {
+		return;
+	}
+
+	tp_group_cancel(&_group);
+
+	tp_group_wait(&_group);
+
+	atomic_store(&_state, BOT_IDLE);
+
+	_stat_cancelled++;
+
+	log_debug_str("Search cancelled!");
+}
+
+/******************************************************************************
+ * The function logs the statistics of the bot.
+ *****************************************************************************/
+
+void bot_log_stats() {
+
+	log_debug("searches: %ld cancelled: %ld nodes: %ld think avg: %ld us max: %ld us", _stat_searches, _stat_cancelled, _stat_nodes, _stat_searches == 0 ? 0 : _stat_think_us / _stat_searches, _stat_think_us_max);
+
+	log_debug("depth 0: %ld depth 1: %ld depth 2: %ld", _stat_depths[0], _stat_depths[1], _stat_depths[2]);
+
+	log_debug("ponders: %ld hits: %ld misses: %ld nodes: %ld cache hits: %ld", _stat_ponders, _stat_ponder_hits, _stat_ponder_misses, _stat_ponder_nodes, _stat_cache_hits);
+}
@@ -32,8 +32,9 @@
 #include <wchar.h>
 
 #include "../inc/controls.h"
-#include "s_color_def.h"
+#include "s_theme.h"
 #include "lib_logging.h"
+#include "lib_perf.h"
 #include "s_tarr.h"
 
 /******************************************************************************
@@ -207,10 +208,10 @@ static const wchar_t _tmpl_confirm[D_ROWS][D_COLS] =
 };
 
 /******************************************************************************
- * The window for the dices and buttons.
+ * The canvas for the dices and buttons.
  *****************************************************************************/
 
-static WINDOW *_win;
+static s_canvas _canvas;
 
 /******************************************************************************
  * The template that is used for the dices and the buttons. (The dices are
@@ -276,19 +277,19 @@ static short _color_ctrl_bg[BUTTON_STATUS_MAX];
  * colors for the buttons.
  *****************************************************************************/
 
-void controls_init(const s_game_cfg *game_cfg, WINDOW *win) {
+void controls_init(const s_game_cfg *game_cfg, const s_canvas *canvas) {
 
 #ifdef DEBUG
 
 	//
 	// Ensure that we initialized all in the correct order.
 	//
-	if (win == NULL) {
+	if (canvas->type == E_CANVAS_CURSES && canvas->win == NULL) {
 		log_exit_str("No window!");
 	}
 #endif
 
-	_win = win;
+	_canvas = *canvas;
 
 	_button_tmpl = s_tarr_new(D_ROWS, D_COLS);
 
@@ -296,33 +297,33 @@ void controls_init(const s_game_cfg *game_cfg, WINDOW *win) {
 	// Create color: black
 	//
 	const int owner_black = e_player_color_2_owner(game_cfg->owner_top_color, PLAYER_COLOR_BLACK);
-	_color_dices[owner_black][E_BUTTON_ACTIVE] = s_color_def_hex_create(game_cfg->clr_dice_black_active);
-	_color_dices[owner_black][E_BUTTON_INACTIVE] = s_color_def_hex_create(game_cfg->clr_dice_black_inactive);
+	_color_dices[owner_black][E_BUTTON_ACTIVE] = s_theme_color_create(game_cfg->clr_dice_black_active);
+	_color_dices[owner_black][E_BUTTON_INACTIVE] = s_theme_color_create(game_cfg->clr_dice_black_inactive);
 
 	//
 	// Create color: white
 	//
 	const int owner_white = e_player_color_2_owner(game_cfg->owner_top_color, PLAYER_COLOR_WHITE);
-	_color_dices[owner_white][E_BUTTON_ACTIVE] = s_color_def_hex_create(game_cfg->clr_dice_white_active);
-	_color_dices[owner_white][E_BUTTON_INACTIVE] = s_color_def_hex_create(game_cfg->clr_dice_white_inactive);
+	_color_dices[owner_white][E_BUTTON_ACTIVE] = s_theme_color_create(game_cfg->clr_dice_white_active);
+	_color_dices[owner_white][E_BUTTON_INACTIVE] = s_theme_color_create(game_cfg->clr_dice_white_inactive);
 
 	//
 	// Create color: undo
 	//
-	_color_ctrl_undo[E_BUTTON_ACTIVE] = s_color_def_hex_create(game_cfg->clr_ctrl_undo_active);
-	_color_ctrl_undo[E_BUTTON_INACTIVE] = s_color_def_hex_create(game_cfg->clr_ctrl_undo_inactive);
+	_color_ctrl_undo[E_BUTTON_ACTIVE] = s_theme_color_create(game_cfg->clr_ctrl_undo_active);
+	_color_ctrl_undo[E_BUTTON_INACTIVE] = s_theme_color_create(game_cfg->clr_ctrl_undo_inactive);
 
 	//
 	// Create color: confirm
 	//
-	_color_ctrl_confirm[E_BUTTON_ACTIVE] = s_color_def_hex_create(game_cfg->clr_ctrl_confirm_active);
-	_color_ctrl_confirm[E_BUTTON_INACTIVE] = s_color_def_hex_create(game_cfg->clr_ctrl_confirm_inactive);
+	_color_ctrl_confirm[E_BUTTON_ACTIVE] = s_theme_color_create(game_cfg->clr_ctrl_confirm_active);
+	_color_ctrl_confirm[E_BUTTON_INACTIVE] = s_theme_color_create(game_cfg->clr_ctrl_confirm_inactive);
 
 	//
 	// Create color: background
 	//
-	_color_ctrl_bg[E_BUTTON_ACTIVE] = s_color_def_hex_create(game_cfg->clr_ctrl_bg_active);
-	_color_ctrl_bg[E_BUTTON_INACTIVE] = s_color_def_hex_create(game_cfg->clr_ctrl_bg_inactive);
+	_color_ctrl_bg[E_BUTTON_ACTIVE] = s_theme_color_create(game_cfg->clr_ctrl_bg_active);
+	_color_ctrl_bg[E_BUTTON_INACTIVE] = s_theme_color_create(game_cfg->clr_ctrl_bg_inactive);
 }
 
 /******************************************************************************
@@ -345,16 +346,12 @@ void controls_free() {
  *****************************************************************************/
 
 static void update_button_tmpl(s_tarr *tmpl_button, const wchar_t tmpl_chars[D_ROWS][D_COLS], const short fg, const short bg) {
-	s_tchar *tchar;
-
 	for (int row = 0; row < D_ROWS; row++) {
 		for (int col = 0; col < D_COLS; col++) {
 
-			tchar = &s_tarr_get(tmpl_button, row, col);
-
-			tchar->chr = tmpl_chars[row][col];
-			tchar->fg = fg;
-			tchar->bg = (row == 0) ? 0 : bg;
+			s_tarr_chr(tmpl_button, row, col) = tmpl_chars[row][col];
+			s_tarr_fg(tmpl_button, row, col) = fg;
+			s_tarr_bg(tmpl_button, row, col) = (row == 0) ? 0 : bg;
 		}
 	}
 }
@@ -381,6 +378,8 @@ static void controls_get_color(const s_status *status, const bool active, short
 
 void controls_print(const s_status *status) {
 
+	pf_scope(PF_CONTROLS_PRINT);
+
 	short fg, bg;
 
 	//
@@ -388,14 +387,14 @@ void controls_print(const s_status *status) {
 	//
 	controls_get_color(status, s_dices_has_status(status->dices, 0, E_DICE_ACTIVE), &fg, &bg);
 	update_button_tmpl(_button_tmpl, _tmpl_dices[status->dices.dice[0].value - 1], fg, bg);
-	s_tarr_print(_win, _button_tmpl, _pos_dice_0);
+	s_canvas_print(&_canvas, _button_tmpl, _pos_dice_0);
 
 	//
 	// Dice: 1
 	//
 	controls_get_color(status, s_dices_has_status(status->dices, 1, E_DICE_ACTIVE), &fg, &bg);
 	update_button_tmpl(_button_tmpl, _tmpl_dices[status->dices.dice[1].value - 1], fg, bg);
-	s_tarr_print(_win, _button_tmpl, _pos_dice_1);
+	s_canvas_print(&_canvas, _button_tmpl, _pos_dice_1);
 
 	//
 	// Control: undo
@@ -404,10 +403,10 @@ void controls_print(const s_status *status) {
 		bg = _color_ctrl_undo[E_BUTTON_ACTIVE];
 		fg = _color_ctrl_bg[E_BUTTON_ACTIVE];
 		update_button_tmpl(_button_tmpl, _tmpl_undo, fg, bg);
-		s_tarr_print(_win, _button_tmpl, _pos_undo);
+		s_canvas_print(&_canvas, _button_tmpl, _pos_undo);
 
 	} else {
-		s_tarr_print_empty(_win, _tmp_dim, _pos_undo);
+		s_canvas_print_empty(&_canvas, _tmp_dim, _pos_undo);
 	}
 
 	//
@@ -417,13 +416,13 @@ void controls_print(const s_status *status) {
 		bg = _color_ctrl_confirm[E_BUTTON_ACTIVE];
 		fg = _color_ctrl_bg[E_BUTTON_ACTIVE];
 		update_button_tmpl(_button_tmpl, _tmpl_confirm, fg, bg);
-		s_tarr_print(_win, _button_tmpl, _pos_confim);
+		s_canvas_print(&_canvas, _button_tmpl, _pos_confim);
 
 	} else {
-		s_tarr_print_empty(_win, _tmp_dim, _pos_confim);
+		s_canvas_print_empty(&_canvas, _tmp_dim, _pos_confim);
 	}
 
-	wrefresh(_win);
+	s_canvas_mark(&_canvas);
 }
 
 /******************************************************************************
@@ -486,3 +485,13 @@ bool controls_process_event(s_status *status, s_fieldset *fieldset, const s_poin
 
 	return false;
 }
+
+/******************************************************************************
+ * The function checks if a mouse event is on the undo button. The event is
+ * relative to the window.
+ *****************************************************************************/
+
+bool controls_is_undo(const s_point *event) {
+
+	return s_point_is_inside(&_pos_undo, &_tmp_dim, event);
+}
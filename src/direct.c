@@ -0,0 +1,270 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/******************************************************************************
+ * The source file implements the direct truecolor output. The canvases render
+ * to a cell buffer with the size of the terminal. On each flush of a changed
+ * frame, the cells that differ from the last presented cells are written
+ * directly to the terminal with truecolor SGR sequences. No curses colors or
+ * color pairs are allocated.
+ *
+ * Curses still handles the input and the popups. It does not know the cells
+ * that were written directly, so after curses wrote to the area of the cell
+ * buffer, direct_invalidate() has to be called.
+ *****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <term.h>
+
+#include "lib_logging.h"
+#include "lib_perf.h"
+#include "lib_frame.h"
+#include "s_canvas.h"
+#include "direct.h"
+
+/******************************************************************************
+ * The cell buffer, the last presented cells, the stream of the terminal and
+ * the number of bytes that were written.
+ *****************************************************************************/
+
+static s_tarr *_cells = NULL;
+
+static s_tarr *_prev = NULL;
+
+static FILE *_stream = NULL;
+
+static long _bytes = 0;
+
+//
+// The current dimension of the terminal. The cell buffers keep the dimension
+// of the start, because the windows of the game do not move on a resize.
+// Only the cells inside the terminal are written.
+//
+static s_point _visible;
+
+//
+// The flag is set if the colors of the 256 color palette are used instead of
+// truecolor.
+//
+static bool _palette_256 = false;
+
+//
+// The statistics of the bytes per move. The start is the number of bytes at
+// the start of the current move or -1 if no move is active.
+//
+static long _move_start = -1;
+
+static long _moves = 0;
+
+static long _moves_bytes = 0;
+
+//
+// A cell that is never rendered, so the cells are presented with the next
+// flush.
+//
+#define DIRECT_TCHAR_INVALID (s_tchar ) { TCHAR_CHR_UNUSED, -2, -2 }
+
+/******************************************************************************
+ * The function checks whether the terminal supports direct colors. This is
+ * the case if the terminfo has the RGB or the Tc flag or the COLORTERM
+ * variable is set to truecolor or 24bit (most terminals do not have a
+ * terminfo entry with the flags).
+ *****************************************************************************/
+
+bool direct_is_supported() {
+
+	char rgb[] = "RGB";
+	char tc[] = "Tc";
+
+	if (tigetflag(rgb) > 0 || tigetflag(tc) > 0) {
+		return true;
+	}
+
+	const char *colorterm = getenv("COLORTERM");
+
+	return colorterm != NULL && (strcmp(colorterm, "truecolor") == 0 || strcmp(colorterm, "24bit") == 0);
+}
+
+/******************************************************************************
+ * The function initializes the direct output with the stream of the terminal
+ * and its dimension. The cells are presented on each frame flush. The colors
+ * are written as truecolor or with the 256 color palette.
+ *****************************************************************************/
+
+void direct_init(FILE *stream, const s_point dim, const bool palette_256) {
+
+	log_debug("dim: %d/%d palette 256: %d", dim.row, dim.col, palette_256);
+
+	_stream = stream;
+
+	_palette_256 = palette_256;
+
+	_visible = dim;
+
+	_cells = s_tarr_new(dim.row, dim.col);
+	s_tarr_set(_cells, S_TCHAR_EMPTY);
+
+	_prev = s_tarr_new(dim.row, dim.col);
+
+	direct_invalidate();
+
+	lf_frame_set_present(direct_present);
+}
+
+/******************************************************************************
+ * The function is called if the terminal was resized. Curses cleared the
+ * screen, so all visible cells are written with the next flush.
+ *****************************************************************************/
+
+void direct_resize(const s_point dim) {
+
+	log_debug("dim: %d/%d", dim.row, dim.col);
+
+	_visible = dim;
+
+	direct_invalidate();
+}
+
+/******************************************************************************
+ * The function frees the cell buffers.
+ *****************************************************************************/
+
+void direct_free() {
+
+	log_debug("bytes: %ld", _bytes);
+
+	lf_frame_set_present(NULL);
+
+	s_tarr_free(&_cells);
+
+	s_tarr_free(&_prev);
+}
+
+/******************************************************************************
+ * Simple getter function.
+ *****************************************************************************/
+
+s_tarr* direct_cells() {
+	return _cells;
+}
+
+/******************************************************************************
+ * Simple getter function.
+ *****************************************************************************/
+
+long direct_bytes() {
+	return _bytes;
+}
+
+/******************************************************************************
+ * The function is called if a move starts. The bytes are counted until the
+ * move ends.
+ *****************************************************************************/
+
+void direct_move_start() {
+
+	if (_move_start < 0) {
+		_move_start = _bytes;
+	}
+}
+
+/******************************************************************************
+ * The function is called if the output of a move is complete, which means
+ * that its animation is finished. It logs the bytes of the move.
+ *****************************************************************************/
+
+void direct_move_end() {
+
+	if (_move_start < 0) {
+		return;
+	}
+
+	const long bytes = _bytes - _move_start;
+
+	_move_start = -1;
+
+	//
+	// A click without output (for example on an empty field) is not a move.
+	//
+	if (bytes == 0) {
+		return;
+	}
+
+	_moves++;
+	_moves_bytes += bytes;
+
+	log_debug("move: %ld bytes: %ld", _moves, bytes);
+}
+
+/******************************************************************************
+ * The function logs the number of bytes that were written.
+ *****************************************************************************/
+
+void direct_log_stats() {
+
+	log_debug("bytes: %ld moves: %ld bytes per move: %ld", _bytes, _moves, _moves > 0 ? _moves_bytes / _moves : 0);
+}
+
+/******************************************************************************
+ * The function invalidates the presented cells, so all cells are written with
+ * the next flush.
+ *****************************************************************************/
+
+void direct_invalidate() {
+
+	s_tarr_set(_prev, DIRECT_TCHAR_INVALID);
+
+	lf_frame_mark();
+}
+
+/******************************************************************************
+ * The function writes the changed cells to the terminal. Curses assumes that
+ * the cursor is at the position where curses left it, so the cursor is moved
+ * back. The attributes are reset by s_canvas_present() and curses has to know
+ * that.
+ *****************************************************************************/
+
+void direct_present() {
+
+	if (curscr != NULL) {
+		vidattr(A_NORMAL);
+	}
+
+	long bytes = (long) s_canvas_present(_stream, _cells, _prev, _visible, _palette_256);
+
+	if (bytes == 0) {
+		return;
+	}
+
+	if (curscr != NULL) {
+		bytes += fprintf(_stream, "\033[%d;%dH", getcury(curscr) + 1, getcurx(curscr) + 1);
+	}
+
+	_bytes += bytes;
+
+	pf_count_add(PF_TERM_BYTES, bytes);
+
+	fflush(_stream);
+}
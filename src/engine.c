@@ -0,0 +1,901 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/******************************************************************************
+ * The source file implements the move search of the computer player. The
+ * plays for a roll are generated on a compact position, which is relative to
+ * the player in turn. The plays are evaluated with a heuristic and the best
+ * candidates are searched deeper (iterative deepening), as long as the budget
+ * allows. Each iteration searches the candidates in the order of the previous
+ * iteration, so the search can stop at any time with the best play so far.
+ *
+ * A ply are all 21 rolls of the player to move. For each roll the player
+ * selects the play with the best evaluation (greedy), so the search of a
+ * play with a depth of n evaluates about (21 * 20)^n positions.
+ *
+ * The functions do not log and do not use the rules module, because they
+ * are called from a worker thread with many positions.
+ *
+ * The evaluations are stored in a cache, which is shared by all threads. The
+ * cache is lock-free: an entry stores the evaluation and the key xor the
+ * evaluation, so an entry, which is written by two threads at the same time,
+ * does not match the key and is a miss.
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib_logging.h"
+#include "lib_perf.h"
+#include "lib_time.h"
+#include "lib_utils.h"
+#include "s_field.h"
+#include "engine.h"
+
+/******************************************************************************
+ * The destination of a move: the bear off area or no legal destination.
+ *****************************************************************************/
+
+#define ENG_DST_OFF POINTS_NUM
+
+#define ENG_DST_NONE -2
+
+/******************************************************************************
+ * The start of the home board. If all checkers are in the home board, the
+ * player can bear off.
+ *****************************************************************************/
+
+#define ENG_HOME (3 * POINTS_QUARTER)
+
+/******************************************************************************
+ * The weights of the evaluation. The unit is a pip.
+ *****************************************************************************/
+
+#define ENG_EVAL_WIN 1000.0
+
+#define ENG_W_POINT 1.0
+
+#define ENG_W_POINT_HOME 2.0
+
+#define ENG_W_ANCHOR 1.0
+
+#define ENG_W_PRIME 1.5
+
+#define ENG_W_STACK 0.2
+
+#define ENG_W_BAR 4.0
+
+#define ENG_W_HIT_TEMPO 4.0
+
+#define ENG_W_SHOT 0.25
+
+/******************************************************************************
+ * The number of candidates, that are searched with a given depth. Each
+ * iteration searches the best candidates of the previous iteration.
+ *****************************************************************************/
+
+static const int _candidates[ENG_DEPTH_MAX + 1] = { ENG_PLAYS_MAX, 8, 4 };
+
+/******************************************************************************
+ * The shared evaluation cache with 64k entries.
+ *****************************************************************************/
+
+#define ENG_CACHE_BITS 16
+
+#define ENG_CACHE_SIZE (1 << ENG_CACHE_BITS)
+
+typedef struct {
+
+	_Atomic uint64_t check;
+
+	_Atomic uint64_t data;
+
+} s_eng_cache_entry;
+
+static s_eng_cache_entry _cache[ENG_CACHE_SIZE];
+
+/******************************************************************************
+ * The probability (in 36th) to hit a blot with a given distance (1-12) with
+ * a single checker, ignoring blocked points.
+ *****************************************************************************/
+
+static const int _hit_36[13] = { 0, 11, 12, 14, 15, 15, 17, 6, 6, 5, 3, 2, 3 };
+
+/******************************************************************************
+ * The 21 different rolls and their weights in 36th.
+ *****************************************************************************/
+
+static const s_eng_roll _rolls[ENG_ROLLS_NUM] = {
+
+	{ 6, 6, 1 }, { 6, 5, 2 }, { 6, 4, 2 }, { 6, 3, 2 }, { 6, 2, 2 }, { 6, 1, 2 },
+
+	{ 5, 5, 1 }, { 5, 4, 2 }, { 5, 3, 2 }, { 5, 2, 2 }, { 5, 1, 2 }, { 4, 4, 1 },
+
+	{ 4, 3, 2 }, { 4, 2, 2 }, { 4, 1, 2 }, { 3, 3, 1 }, { 3, 2, 2 }, { 3, 1, 2 },
+
+	{ 2, 2, 1 }, { 2, 1, 2 }, { 1, 1, 1 }
+};
+
+/******************************************************************************
+ * The function initializes the position from a fieldset for the player in
+ * turn.
+ *****************************************************************************/
+
+void eng_pos_init(s_eng_pos *pos, const s_fieldset *fieldset, const e_owner turn) {
+	const s_field *field;
+
+	const e_owner other = e_owner_other(turn);
+
+	for (int idx_rel = 0; idx_rel < POINTS_NUM; idx_rel++) {
+
+		field = &fieldset->point[s_field_idx_rel(turn, idx_rel)];
+
+		if (field->owner == turn) {
+			pos->point[idx_rel] = (signed char) field->num;
+
+		} else if (field->owner == other) {
+			pos->point[idx_rel] = (signed char) -field->num;
+
+		} else {
+			pos->point[idx_rel] = 0;
+		}
+	}
+
+	pos->bar[0] = (signed char) fieldset->reenter[turn].num;
+	pos->bar[1] = (signed char) fieldset->reenter[other].num;
+
+	pos->off[0] = (signed char) fieldset->bear_off[turn].num;
+	pos->off[1] = (signed char) fieldset->bear_off[other].num;
+}
+
+/******************************************************************************
+ * The function flips the position, so the opponent is the player in turn.
+ * The source and the destination can be the same.
+ *****************************************************************************/
+
+void eng_pos_flip(s_eng_pos *dst, const s_eng_pos *src) {
+	s_eng_pos tmp;
+
+	for (int i = 0; i < POINTS_NUM; i++) {
+		tmp.point[i] = (signed char) -src->point[lu_reverse_idx(POINTS_NUM, i)];
+	}
+
+	tmp.bar[0] = src->bar[1];
+	tmp.bar[1] = src->bar[0];
+
+	tmp.off[0] = src->off[1];
+	tmp.off[1] = src->off[0];
+
+	*dst = tmp;
+}
+
+/******************************************************************************
+ * The function returns the relative index of the last checker of the player
+ * in turn or POINTS_NUM if there is no checker on the points.
+ *****************************************************************************/
+
+static int eng_min_rel_idx(const s_eng_pos *pos) {
+
+	for (int idx = 0; idx < POINTS_NUM; idx++) {
+		if (pos->point[idx] > 0) {
+			return idx;
+		}
+	}
+
+	return POINTS_NUM;
+}
+
+/******************************************************************************
+ * The function returns the destination of a move from a source with a dice
+ * value or ENG_DST_NONE if the move is not allowed. The source has to be a
+ * legal source. This means it is the bar if the player has checkers on the
+ * bar. The checks are the same as in rules_can_mv().
+ *****************************************************************************/
+
+static int eng_dst(const s_eng_pos *pos, const int src, const int dice) {
+
+	const int dst = src + dice;
+
+	//
+	// CASE: destination is a point, which is not occupied by the opponent.
+	//
+	if (dst < POINTS_NUM) {
+		return pos->point[dst] < -1 ? ENG_DST_NONE : dst;
+	}
+
+	//
+	// CASE: destination is outside, which requires the bear off phase.
+	//
+	const int min_rel_idx = eng_min_rel_idx(pos);
+
+	if (pos->bar[0] > 0 || min_rel_idx < ENG_HOME) {
+		return ENG_DST_NONE;
+	}
+
+	//
+	// CASE: exact outside or far outside with the last checker.
+	//
+	if (dst == POINTS_NUM || min_rel_idx + dice >= POINTS_NUM) {
+		return ENG_DST_OFF;
+	}
+
+	return ENG_DST_NONE;
+}
+
+/******************************************************************************
+ * The function moves a checker of the player in turn and hits a blot of the
+ * opponent.
+ *****************************************************************************/
+
+static void eng_mv(s_eng_pos *pos, const int src, const int dst) {
+
+	if (src == ENG_SRC_BAR) {
+		pos->bar[0]--;
+	} else {
+		pos->point[src]--;
+	}
+
+	if (dst == ENG_DST_OFF) {
+		pos->off[0]++;
+		return;
+	}
+
+	if (pos->point[dst] == -1) {
+		pos->point[dst] = 0;
+		pos->bar[1]++;
+	}
+
+	pos->point[dst]++;
+}
+
+/******************************************************************************
+ * The function checks if the player in turn can move a checker with the dice
+ * value.
+ *****************************************************************************/
+
+bool eng_can_move(const s_eng_pos *pos, const int dice) {
+
+	if (pos->bar[0] > 0) {
+		return eng_dst(pos, ENG_SRC_BAR, dice) != ENG_DST_NONE;
+	}
+
+	for (int src = 0; src < POINTS_NUM; src++) {
+		if (pos->point[src] > 0 && eng_dst(pos, src, dice) != ENG_DST_NONE) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * The function computes a hash value for a position (FNV-1a). It is used for
+ * the hash set of the plays and as the key of the evaluation cache.
+ *****************************************************************************/
+
+static uint64_t eng_pos_hash(const s_eng_pos *pos) {
+
+	const unsigned char *ptr = (const unsigned char*) pos;
+	uint64_t hash = 14695981039346656037u;
+
+	for (size_t i = 0; i < sizeof(s_eng_pos); i++) {
+		hash = (hash ^ ptr[i]) * 1099511628211u;
+	}
+
+	return hash;
+}
+
+/******************************************************************************
+ * The function removes all plays and clears the hash set.
+ *****************************************************************************/
+
+static void eng_plays_clear(s_eng_plays *plays) {
+
+	plays->num = 0;
+
+	memset(plays->hash, -1, sizeof(plays->hash));
+}
+
+/******************************************************************************
+ * The function adds a play, if no play with the same result exists. Only the
+ * plays with the maximum number of steps are kept, so the dices that are not
+ * used cannot be used at all.
+ *****************************************************************************/
+
+static void eng_plays_add(s_eng_plays *plays, const s_eng_play *play) {
+
+	if (plays->num > 0) {
+
+		if (play->num < plays->play[0].num) {
+			return;
+		}
+
+		if (play->num > plays->play[0].num) {
+			eng_plays_clear(plays);
+		}
+	}
+
+	unsigned int idx = (unsigned int) (eng_pos_hash(&play->pos) % ENG_HASH_SIZE);
+
+	while (plays->hash[idx] >= 0) {
+
+		if (memcmp(&plays->play[plays->hash[idx]].pos, &play->pos, sizeof(s_eng_pos)) == 0) {
+			return;
+		}
+
+		idx = (idx + 1) % ENG_HASH_SIZE;
+	}
+
+	//
+	// If the array is full, the play is ignored.
+	//
+	if (plays->num == ENG_PLAYS_MAX) {
+		return;
+	}
+
+	plays->hash[idx] = (short) plays->num;
+	plays->play[plays->num++] = *play;
+}
+
+/******************************************************************************
+ * The function generates the plays recursively. Each call sets the step with
+ * the given index. If no checker can be moved with the dice value of the
+ * step, the play ends with the previous step.
+ *****************************************************************************/
+
+static void eng_gen_step(s_eng_play *play, const int *dices, const int num_dices, const int step, s_eng_plays *plays) {
+
+	bool moved = false;
+
+	if (step < num_dices) {
+
+		const s_eng_pos pos = play->pos;
+
+		//
+		// If the player has checkers on the bar, they have to reenter first.
+		//
+		const int src_start = pos.bar[0] > 0 ? ENG_SRC_BAR : 0;
+		const int src_end = pos.bar[0] > 0 ? ENG_SRC_BAR : POINTS_NUM - 1;
+
+		for (int src = src_start; src <= src_end; src++) {
+
+			if (src != ENG_SRC_BAR && pos.point[src] <= 0) {
+				continue;
+			}
+
+			const int dst = eng_dst(&pos, src, dices[step]);
+
+			if (dst == ENG_DST_NONE) {
+				continue;
+			}
+
+			eng_mv(&play->pos, src, dst);
+			play->src[step] = (signed char) src;
+
+			eng_gen_step(play, dices, num_dices, step + 1, plays);
+
+			play->pos = pos;
+			moved = true;
+		}
+	}
+
+	if (!moved) {
+		play->num = step;
+		eng_plays_add(plays, play);
+	}
+}
+
+/******************************************************************************
+ * The function generates all plays for a roll. Doublets have four steps,
+ * otherwise both orders of the dices are tried. If no checker can be moved,
+ * the result is a single play without steps.
+ *****************************************************************************/
+
+void eng_gen_plays(const s_eng_pos *pos, const int dice_1, const int dice_2, s_eng_plays *plays) {
+	s_eng_play play;
+
+	eng_plays_clear(plays);
+
+	play.pos = *pos;
+	play.eval = 0.0;
+
+	if (dice_1 == dice_2) {
+		const int dices[ENG_STEPS_MAX] = { dice_1, dice_1, dice_1, dice_1 };
+
+		play.dice_first = 0;
+		eng_gen_step(&play, dices, ENG_STEPS_MAX, 0, plays);
+
+	} else {
+		const int dices_1[2] = { dice_1, dice_2 };
+		const int dices_2[2] = { dice_2, dice_1 };
+
+		play.dice_first = 0;
+		eng_gen_step(&play, dices_1, 2, 0, plays);
+
+		play.dice_first = 1;
+		eng_gen_step(&play, dices_2, 2, 0, plays);
+	}
+}
+
+/******************************************************************************
+ * The function computes the probability, that a checker at the index is hit
+ * by checkers, that move in the opposite direction. The direction is given
+ * by the sign of the checkers of the shooter.
+ *****************************************************************************/
+
+static double eng_hit_prob(const s_eng_pos *pos, const int idx, const int sign) {
+	double miss = 1.0;
+	int dist;
+
+	for (int i = 0; i < POINTS_NUM; i++) {
+
+		if (pos->point[i] * sign <= 0) {
+			continue;
+		}
+
+		dist = sign < 0 ? i - idx : idx - i;
+
+		if (dist >= 1 && dist <= 12) {
+			miss *= 1.0 - _hit_36[dist] / 36.0;
+		}
+	}
+
+	//
+	// Checkers on the bar enter from outside of the board.
+	//
+	dist = sign < 0 ? POINTS_NUM - idx : idx + 1;
+
+	if (pos->bar[sign < 0 ? 1 : 0] > 0 && dist <= 12) {
+		miss *= 1.0 - _hit_36[dist] / 36.0;
+	}
+
+	return 1.0 - miss;
+}
+
+/******************************************************************************
+ * The function evaluates a position after a play of the player in turn, so
+ * the opponent is on roll. The result is from the view of the player in turn
+ * and its unit is roughly a pip.
+ *****************************************************************************/
+
+double eng_eval(const s_eng_pos *pos) {
+
+	if (pos->off[0] == CHECKER_NUM) {
+		return ENG_EVAL_WIN;
+	}
+
+	if (pos->off[1] == CHECKER_NUM) {
+		return -ENG_EVAL_WIN;
+	}
+
+	int pips_own = pos->bar[0] * (POINTS_NUM + 1);
+	int pips_opp = pos->bar[1] * (POINTS_NUM + 1);
+
+	double score = ENG_W_BAR * (pos->bar[1] - pos->bar[0]);
+
+	int prime = 0;
+	int prime_max = 0;
+
+	for (int i = 0; i < POINTS_NUM; i++) {
+
+		const int num = pos->point[i];
+
+		if (num < 0) {
+			pips_opp -= num * (i + 1);
+
+			//
+			// A blot of the opponent can be hit with the roll after the next.
+			//
+			if (num == -1) {
+				score += ENG_W_SHOT * eng_hit_prob(pos, i, 1) * (POINTS_NUM - i);
+			}
+
+			prime = 0;
+			continue;
+		}
+
+		pips_own += num * (POINTS_NUM - i);
+
+		if (num == 1) {
+
+			//
+			// A blot loses its pips and a tempo, if it is hit.
+			//
+			score -= eng_hit_prob(pos, i, -1) * (i + 1 + ENG_W_HIT_TEMPO);
+			prime = 0;
+
+		} else if (num >= 2) {
+
+			score += ENG_W_POINT;
+
+			if (i >= ENG_HOME) {
+				score += ENG_W_POINT_HOME;
+
+			} else if (i < POINTS_QUARTER) {
+				score += ENG_W_ANCHOR;
+			}
+
+			if (num > 3) {
+				score -= ENG_W_STACK * (num - 3);
+			}
+
+			prime_max = lu_max(prime_max, ++prime);
+
+		} else {
+			prime = 0;
+		}
+	}
+
+	if (prime_max > 1) {
+		score += ENG_W_PRIME * (prime_max - 1);
+	}
+
+	return score + pips_opp - pips_own;
+}
+
+/******************************************************************************
+ * The function returns the evaluation of a position from the shared cache.
+ * On a miss the position is evaluated and stored in the cache.
+ *****************************************************************************/
+
+static double eng_eval_cached(const s_eng_pos *pos, s_eng_stats *stats) {
+	double eval;
+	uint64_t data;
+
+	const uint64_t key = eng_pos_hash(pos);
+
+	s_eng_cache_entry *entry = &_cache[key & (ENG_CACHE_SIZE - 1)];
+
+	stats->nodes++;
+
+	pf_count(PF_ENG_NODES);
+
+	data = atomic_load_explicit(&entry->data, memory_order_relaxed);
+
+	if ((atomic_load_explicit(&entry->check, memory_order_relaxed) ^ data) == key) {
+		stats->cache_hits++;
+
+		pf_count(PF_ENG_CACHE_HITS);
+
+		memcpy(&eval, &data, sizeof(double));
+		return eval;
+	}
+
+	eval = eng_eval(pos);
+
+	memcpy(&data, &eval, sizeof(double));
+
+	atomic_store_explicit(&entry->data, data, memory_order_relaxed);
+	atomic_store_explicit(&entry->check, key ^ data, memory_order_relaxed);
+
+	return eval;
+}
+
+/******************************************************************************
+ * The function checks if the budget is exhausted: the search is cancelled,
+ * the deadline is reached or the maximum number of nodes is evaluated.
+ *****************************************************************************/
+
+static bool eng_budget_done(const s_eng_budget *budget, const s_eng_stats *stats) {
+
+	if (budget->cancel != NULL && atomic_load_explicit(budget->cancel, memory_order_relaxed)) {
+		return true;
+	}
+
+	if (budget->nodes > 0 && stats->nodes >= budget->nodes) {
+		return true;
+	}
+
+	return budget->deadline > 0 && lt_now_us() >= budget->deadline;
+}
+
+/******************************************************************************
+ * The function computes the value of a position with a given depth. The
+ * position is the result of a play, so it is relative to the player, that
+ * moved and the opponent is in turn. For each of the 21 rolls the opponent
+ * selects the play with the best evaluation and the value of its result is
+ * computed one ply less deep. The replies array has an element for each
+ * ply. The function returns false if the budget is exhausted.
+ *****************************************************************************/
+
+static bool eng_value(const s_eng_pos *pos, const int depth, const s_eng_budget *budget, s_eng_plays *replies, double *value, s_eng_stats *stats) {
+	s_eng_pos pos_opp;
+	double value_opp;
+	double eval;
+
+	if (pos->off[0] == CHECKER_NUM) {
+		*value = ENG_EVAL_WIN;
+		return true;
+	}
+
+	if (depth == 0) {
+		*value = eng_eval_cached(pos, stats);
+		return true;
+	}
+
+	eng_pos_flip(&pos_opp, pos);
+
+	double sum = 0.0;
+
+	for (int r = 0; r < ENG_ROLLS_NUM; r++) {
+
+		if (eng_budget_done(budget, stats)) {
+			return false;
+		}
+
+		eng_gen_plays(&pos_opp, _rolls[r].dice_1, _rolls[r].dice_2, replies);
+
+		int best_idx = 0;
+		double best = -ENG_EVAL_WIN - 1.0;
+
+		for (int i = 0; i < replies->num; i++) {
+
+			if ((eval = eng_eval_cached(&replies->play[i].pos, stats)) > best) {
+				best = eval;
+				best_idx = i;
+			}
+		}
+
+		//
+		// On the last ply the evaluation of the selected reply is its value.
+		//
+		if (depth == 1) {
+			value_opp = best;
+
+		} else if (!eng_value(&replies->play[best_idx].pos, depth - 1, budget, replies + 1, &value_opp, stats)) {
+			return false;
+		}
+
+		sum += _rolls[r].weight * value_opp;
+	}
+
+	*value = -sum / 36.0;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function computes the value of a play with a given depth (1 or more
+ * plies). The replies array has to have an element for each ply. The function
+ * returns false if the budget is exhausted before all rolls are done.
+ *****************************************************************************/
+
+bool eng_eval_ply(const s_eng_play *play, const int depth, const s_eng_budget *budget, s_eng_plays *replies, double *value, s_eng_stats *stats) {
+
+	return eng_value(&play->pos, depth, budget, replies, value, stats);
+}
+
+/******************************************************************************
+ * The function compares two plays by their evaluation (descending).
+ *****************************************************************************/
+
+static int eng_play_cmp(const void *ptr_1, const void *ptr_2) {
+
+	const double eval_1 = ((const s_eng_play*) ptr_1)->eval;
+	const double eval_2 = ((const s_eng_play*) ptr_2)->eval;
+
+	return (eval_1 < eval_2) - (eval_1 > eval_2);
+}
+
+/******************************************************************************
+ * The function generates the plays for a roll, evaluates them and sorts them
+ * by the evaluation (best first).
+ *****************************************************************************/
+
+void eng_rank(const s_eng_pos *pos, const int dice_1, const int dice_2, s_eng_plays *plays, s_eng_stats *stats) {
+
+	eng_gen_plays(pos, dice_1, dice_2, plays);
+
+	for (int i = 0; i < plays->num; i++) {
+		plays->play[i].eval = eng_eval_cached(&plays->play[i].pos, stats);
+	}
+
+	qsort(plays->play, (size_t) plays->num, sizeof(s_eng_play), eng_play_cmp);
+}
+
+/******************************************************************************
+ * The function sorts the play with the index into the sorted prefix of the
+ * array (insertion sort). The plays after the index are not changed, so an
+ * iteration, that searches the plays in order, can be stopped at any time.
+ *****************************************************************************/
+
+void eng_plays_insert(s_eng_play *play, const int idx) {
+	int i;
+
+	const s_eng_play tmp = play[idx];
+
+	for (i = idx; i > 0 && play[i - 1].eval < tmp.eval; i--) {
+		play[i] = play[i - 1];
+	}
+
+	play[i] = tmp;
+}
+
+/******************************************************************************
+ * The function searches the best play for a roll with iterative deepening.
+ * All plays are evaluated and sorted. Then the best candidates are searched
+ * one ply deeper with each iteration, until the depth of the budget is
+ * reached or the budget is exhausted.
+ *
+ * The candidates of an iteration are searched in the order of the previous
+ * iteration. If an iteration is stopped, the best play of the previous
+ * iteration is already searched, so the best of the searched candidates is
+ * the best play found so far. The stats contain the depth of the play.
+ *
+ * If the search is cancelled, the function returns false and the play is not
+ * set.
+ *****************************************************************************/
+
+bool eng_search(const s_eng_pos *pos, const int dice_1, const int dice_2, const s_eng_budget *budget, s_eng_play *best, s_eng_stats *stats) {
+	double value;
+
+	s_eng_plays *plays = malloc((1 + ENG_DEPTH_MAX) * sizeof(s_eng_plays));
+
+	if (plays == NULL) {
+		log_exit_str("Unable to allocate memory!");
+	}
+
+	s_eng_plays *replies = &plays[1];
+
+	memset(stats, 0, sizeof(s_eng_stats));
+
+	//
+	// Iteration 0: evaluate all plays and sort them.
+	//
+	eng_rank(pos, dice_1, dice_2, plays, stats);
+
+	stats->candidates = plays->num;
+
+	*best = plays->play[0];
+
+	//
+	// A single play has no alternative, so there is nothing to search.
+	//
+	int num = plays->num > 1 ? plays->num : 0;
+
+	const int depth_max = lu_min(budget->depth, ENG_DEPTH_MAX);
+
+	for (int depth = 1; depth <= depth_max && num > 0; depth++) {
+
+		num = lu_min(num, _candidates[depth]);
+
+		int searched = 0;
+
+		while (searched < num && eng_eval_ply(&plays->play[searched], depth, budget, replies, &value, stats)) {
+
+			plays->play[searched].eval = value;
+
+			eng_plays_insert(plays->play, searched);
+
+			searched++;
+		}
+
+		if (searched == 0) {
+			break;
+		}
+
+		*best = plays->play[0];
+
+		stats->depth = depth;
+		stats->searched = searched;
+
+		if (searched < num) {
+			break;
+		}
+	}
+
+	free(plays);
+
+	return budget->cancel == NULL || !atomic_load(budget->cancel);
+}
+
+/******************************************************************************
+ * The function returns the field id for the source of a step.
+ *****************************************************************************/
+
+s_field_id eng_step_field_id(const e_owner turn, const int src) {
+
+	if (src == ENG_SRC_BAR) {
+		return (s_field_id ) { .type = E_FIELD_BAR, .idx = turn };
+	}
+
+	return (s_field_id ) { .type = E_FIELD_POINTS, .idx = s_field_idx_rel(turn, src) };
+}
+
+/******************************************************************************
+ * The function writes the notation of a play to a buffer, for example
+ * "24/18 13/8*". The points are numbered from the view of the player in turn,
+ * so the checkers move from 24 to 1. A hit is marked with a '*'.
+ *****************************************************************************/
+
+void eng_play_str(const s_eng_pos *pos, const int dice_1, const int dice_2, const s_eng_play *play, char *buf, const size_t size) {
+	char src_str[12];
+	char dst_str[12];
+	size_t len = 0;
+
+	s_eng_pos tmp = *pos;
+
+	buf[0] = '\0';
+
+	if (play->num == 0) {
+		snprintf(buf, size, "(no move)");
+		return;
+	}
+
+	for (int i = 0; i < play->num; i++) {
+
+		const int dice = dice_1 == dice_2 || i == play->dice_first ? dice_1 : dice_2;
+
+		const int src = play->src[i];
+
+		const int dst = eng_dst(&tmp, src, dice);
+
+		const bool hit = dst != ENG_DST_OFF && tmp.point[dst] == -1;
+
+		if (src == ENG_SRC_BAR) {
+			snprintf(src_str, sizeof(src_str), "bar");
+		} else {
+			snprintf(src_str, sizeof(src_str), "%d", POINTS_NUM - src);
+		}
+
+		if (dst == ENG_DST_OFF) {
+			snprintf(dst_str, sizeof(dst_str), "off");
+		} else {
+			snprintf(dst_str, sizeof(dst_str), "%d", POINTS_NUM - dst);
+		}
+
+		eng_mv(&tmp, src, dst);
+
+		if (len < size) {
+			len += (size_t) snprintf(buf + len, size - len, "%s%s/%s%s", i == 0 ? "" : " ", src_str, dst_str, hit ? "*" : "");
+		}
+	}
+}
+
+/******************************************************************************
+ * The function returns one of the 21 rolls.
+ *****************************************************************************/
+
+s_eng_roll eng_roll(const int idx) {
+
+	return _rolls[idx];
+}
+
+/******************************************************************************
+ * The function returns the index of a roll. The first dice has the higher
+ * value (like s_dices).
+ *****************************************************************************/
+
+int eng_roll_idx(const int dice_1, const int dice_2) {
+
+	int idx = 0;
+
+	for (int i = 6; i > dice_1; i--) {
+		idx += i;
+	}
+
+	return idx + dice_1 - dice_2;
+}
@@ -0,0 +1,538 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/******************************************************************************
+ * The source file implements the hints. A task of the thread pool ranks all
+ * plays of the roll with iterative deepening: first with the evaluation (0
+ * ply), then all plays with one ply and then the shown plays with two plies.
+ * The plays, that are searched deeper, are sorted into the prefix of the
+ * array, so the array is always ranked: first the plays of the current
+ * iteration and then the remaining plays of the previous iteration.
+ *
+ * The task publishes the best plays with a mutex and increments a version.
+ * The ui thread copies the plays if the version changed and redraws the box.
+ *****************************************************************************/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib_logging.h"
+#include "lib_pool.h"
+#include "lib_time.h"
+#include "lib_utils.h"
+#include "s_theme.h"
+#include "loop.h"
+#include "hint.h"
+
+/******************************************************************************
+ * The box has a header line, a line for each play and a help line.
+ *****************************************************************************/
+
+#define HINT_ROWS (HINT_NUM + 2)
+
+#define HINT_COLS 36
+
+//
+// The buffer for a line is large enough for any number, the line is cut at
+// the width of the box.
+//
+#define HINT_LINE_SIZE 512
+
+/******************************************************************************
+ * The minimum time between two updates of the worker in microseconds.
+ *****************************************************************************/
+
+#define HINT_PUBLISH_US 100000L
+
+/******************************************************************************
+ * The result of the ranking: the best plays, the depth of the current
+ * iteration, the number of plays, that were searched with this depth and the
+ * number of plays of the iteration.
+ *****************************************************************************/
+
+typedef struct {
+
+	int num;
+
+	s_eng_play play[HINT_NUM];
+
+	int depth;
+
+	int searched;
+
+	int total;
+
+} s_hint_result;
+
+/******************************************************************************
+ * The board with the highlight layer and the colors of the box.
+ *****************************************************************************/
+
+static s_board *_board;
+
+static short _color_fg;
+
+static short _color_bg;
+
+static s_point _box_pos;
+
+static const s_point _box_dim = { .row = HINT_ROWS, .col = HINT_COLS };
+
+/******************************************************************************
+ * The state of the ui thread: the flag is set if the box is shown and the
+ * dirty flag is set if the box has to be redrawn.
+ *****************************************************************************/
+
+static bool _active = false;
+
+static bool _dirty = false;
+
+static s_hint_result _shown;
+
+static int _shown_version;
+
+/******************************************************************************
+ * The task of the ranking and its input, which is written before the task is
+ * spawned. The stats and the done flag are read after the group is joined.
+ * The cancel flag of the group cancels the ranking.
+ *****************************************************************************/
+
+static s_tp_group _group;
+
+static s_tp_task _task;
+
+static bool _running = false;
+
+static s_eng_pos _pos;
+
+static e_owner _turn;
+
+static int _dice_1;
+
+static int _dice_2;
+
+static s_eng_stats _stats;
+
+static bool _done;
+
+/******************************************************************************
+ * The result of the worker, which is protected by the mutex, and its
+ * version.
+ *****************************************************************************/
+
+static pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static s_hint_result _result;
+
+static atomic_int _version = 0;
+
+//
+// The statistics: the number of hints, the number of cancelled hints, the
+// number of evaluated positions, the number of redraws and the number of
+// selected plays.
+//
+static long _stat_hints = 0;
+
+static long _stat_cancelled = 0;
+
+static long _stat_nodes = 0;
+
+static long _stat_redraws = 0;
+
+static long _stat_selected = 0;
+
+/******************************************************************************
+ * The function initializes the hints. The box is centered on the board.
+ *****************************************************************************/
+
+void hint_init(s_board *board, const s_game_cfg *game_cfg) {
+
+	_board = board;
+
+	_color_fg = s_theme_color_create(game_cfg->clr_hint_fg);
+
+	_color_bg = s_theme_color_create(game_cfg->clr_hint_bg);
+
+	_box_pos = (s_point ) { .row = (board->hl->dim.row - HINT_ROWS) / 2, .col = (board->hl->dim.col - HINT_COLS) / 2 };
+}
+
+/******************************************************************************
+ * The function publishes the best plays of the ranking and wakes up the ui
+ * thread.
+ *****************************************************************************/
+
+static void hint_publish(const s_eng_plays *plays, const int depth, const int searched, const int total) {
+
+	pthread_mutex_lock(&_mutex);
+
+	_result.num = lu_min(plays->num, HINT_NUM);
+
+	memcpy(_result.play, plays->play, _result.num * sizeof(s_eng_play));
+
+	_result.depth = depth;
+
+	_result.searched = searched;
+
+	_result.total = total;
+
+	pthread_mutex_unlock(&_mutex);
+
+	atomic_fetch_add(&_version, 1);
+
+	loop_wake();
+}
+
+/******************************************************************************
+ * The function searches the plays of an iteration with a depth in the order
+ * of the previous iteration. The ranking is published after a play is done,
+ * if the last update is old enough. The function returns false if the hint
+ * is cancelled.
+ *****************************************************************************/
+
+static bool hint_iteration(s_eng_plays *plays, const int depth, const int num, s_eng_plays *replies, long *published) {
+	double value;
+
+	const s_eng_budget budget = { .depth = depth, .deadline = 0, .nodes = 0, .cancel = &_group.cancel };
+
+	for (int i = 0; i < num; i++) {
+
+		if (!eng_eval_ply(&plays->play[i], depth, &budget, replies, &value, &_stats)) {
+			return false;
+		}
+
+		plays->play[i].eval = value;
+
+		eng_plays_insert(plays->play, i);
+
+		_stats.searched++;
+
+		if (i == num - 1 || lt_now_us() - *published >= HINT_PUBLISH_US) {
+
+			hint_publish(plays, depth, i + 1, num);
+
+			*published = lt_now_us();
+		}
+	}
+
+	_stats.depth = depth;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function is the task of the hints. It ranks all plays and searches
+ * them deeper until the maximum depth is reached or the hint is cancelled.
+ * All plays are searched with one ply, the deeper plies are only searched
+ * for the shown plays.
+ *****************************************************************************/
+
+static void hint_worker(void *arg) {
+	long published;
+
+	(void) arg;
+
+	s_eng_plays *plays = malloc((1 + ENG_DEPTH_MAX) * sizeof(s_eng_plays));
+
+	if (plays == NULL) {
+		log_exit_str("Unable to allocate memory!");
+	}
+
+	s_eng_plays *replies = &plays[1];
+
+	memset(&_stats, 0, sizeof(s_eng_stats));
+
+	eng_rank(&_pos, _dice_1, _dice_2, plays, &_stats);
+
+	hint_publish(plays, 0, plays->num, plays->num);
+
+	published = lt_now_us();
+
+	//
+	// A single play has no alternative, so there is nothing to search.
+	//
+	int num = plays->num > 1 ? plays->num : 0;
+
+	_stats.candidates = num;
+
+	for (int depth = 1; depth <= ENG_DEPTH_MAX && num > 0; depth++) {
+
+		if (depth > 1) {
+			num = lu_min(num, HINT_NUM);
+		}
+
+		if (!hint_iteration(plays, depth, num, replies, &published)) {
+			break;
+		}
+	}
+
+	_done = _stats.depth == ENG_DEPTH_MAX || num == 0;
+
+	free(plays);
+}
+
+/******************************************************************************
+ * The function stops the task, if it is running.
+ *****************************************************************************/
+
+static void hint_stop() {
+
+	if (!_running) {
+		return;
+	}
+
+	tp_group_cancel(&_group);
+
+	tp_group_wait(&_group);
+
+	_running = false;
+
+	if (!_done) {
+		_stat_cancelled++;
+	}
+
+	_stat_nodes += _stats.nodes;
+}
+
+/******************************************************************************
+ * The function starts the ranking of the plays for the position and the
+ * dices of the status. The box is shown with the next tick.
+ *****************************************************************************/
+
+void hint_start(const s_status *status, const s_fieldset *fieldset) {
+
+	hint_cancel();
+
+	eng_pos_init(&_pos, fieldset, status->turn);
+
+	_turn = status->turn;
+
+	_dice_1 = status->dices.dice[0].value;
+	_dice_2 = status->dices.dice[1].value;
+
+	//
+	// The ranking is shown, after the first version is published.
+	//
+	_shown.num = 0;
+	_shown_version = atomic_load(&_version);
+
+	_active = true;
+	_dirty = true;
+
+	tp_group_init(&_group);
+
+	tp_spawn(&_group, &_task, hint_worker, NULL);
+
+	_running = true;
+
+	_stat_hints++;
+
+	log_debug("Hint: %d-%d", _dice_1, _dice_2);
+}
+
+/******************************************************************************
+ * The function cancels the ranking and removes the box from the board.
+ *****************************************************************************/
+
+void hint_cancel() {
+
+	hint_stop();
+
+	if (!_active) {
+		return;
+	}
+
+	_active = false;
+	_dirty = false;
+
+	s_tarr_del(_board->hl, _box_dim, _box_pos);
+
+	s_board_print_area(_board, _box_pos, _box_dim);
+
+	s_board_mark(_board);
+}
+
+/******************************************************************************
+ * The function stops the task. It is called with the exit callback, which
+ * can be called from a worker with log_exit(). In this case the task cannot
+ * be joined.
+ *****************************************************************************/
+
+void hint_free() {
+
+	if (tp_is_worker()) {
+		return;
+	}
+
+	hint_stop();
+}
+
+/******************************************************************************
+ * The function returns true if the box is shown.
+ *****************************************************************************/
+
+bool hint_is_active() {
+	return _active;
+}
+
+/******************************************************************************
+ * The function is called if the highlight layer of the board was deleted.
+ * The box is redrawn with the next tick.
+ *****************************************************************************/
+
+void hint_reset() {
+
+	if (_active) {
+		_dirty = true;
+	}
+}
+
+/******************************************************************************
+ * The function writes a line of the box, which is cut at the width of the
+ * box.
+ *****************************************************************************/
+
+static void hint_line(const int row, char *line) {
+
+	line[HINT_COLS] = '\0';
+
+	s_tarr_set_str(_board->hl, (s_point ) { _box_pos.row + row, _box_pos.col }, line, _color_fg, _color_bg);
+}
+
+/******************************************************************************
+ * The function draws the box with the plays on the highlight layer.
+ *****************************************************************************/
+
+static void hint_draw() {
+	char line[HINT_LINE_SIZE];
+	char notation[HINT_LINE_SIZE];
+
+	_stat_redraws++;
+
+	s_tarr_set_area(_board->hl, _box_dim, _box_pos, (s_tchar ) { L' ', _color_fg, _color_bg });
+
+	if (_shown.num == 0) {
+		snprintf(line, sizeof(line), " Hints %d-%d  ranking...", _dice_1, _dice_2);
+
+	} else {
+		snprintf(line, sizeof(line), " Hints %d-%d  ply %d  %d/%d", _dice_1, _dice_2, _shown.depth, _shown.searched, _shown.total);
+	}
+
+	hint_line(0, line);
+
+	for (int i = 0; i < _shown.num; i++) {
+
+		eng_play_str(&_pos, _dice_1, _dice_2, &_shown.play[i], notation, sizeof(notation));
+
+		//
+		// The plays after the searched plays have the depth of the previous
+		// iteration.
+		//
+		const int depth = i < _shown.searched ? _shown.depth : lu_max(0, _shown.depth - 1);
+
+		snprintf(line, sizeof(line), " %d %-21.21s %+7.1f %d", i + 1, notation, _shown.play[i].eval, depth);
+
+		hint_line(1 + i, line);
+	}
+
+	snprintf(line, sizeof(line), " 1-%d: play  h: close", HINT_NUM);
+
+	hint_line(HINT_ROWS - 1, line);
+
+	s_board_print_area(_board, _box_pos, _box_dim);
+
+	s_board_mark(_board);
+}
+
+/******************************************************************************
+ * The function is called from the main loop. The hint is cancelled, if the
+ * player or the dices changed. The box is redrawn, if the worker published
+ * a new version or the highlight layer was deleted. The function returns
+ * true if the box changed.
+ *****************************************************************************/
+
+bool hint_tick(const s_status *status) {
+
+	if (!_active) {
+		return false;
+	}
+
+	if (status->turn != _turn || status->dices.dice[0].value != _dice_1 || status->dices.dice[1].value != _dice_2) {
+		hint_cancel();
+		return true;
+	}
+
+	const int version = atomic_load(&_version);
+
+	if (version != _shown_version) {
+
+		pthread_mutex_lock(&_mutex);
+
+		_shown = _result;
+
+		pthread_mutex_unlock(&_mutex);
+
+		_shown_version = version;
+		_dirty = true;
+	}
+
+	if (!_dirty) {
+		return false;
+	}
+
+	hint_draw();
+
+	_dirty = false;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function returns the play with the index from the box. The function
+ * returns false if the box has no such play.
+ *****************************************************************************/
+
+bool hint_get(const int idx, s_eng_play *play) {
+
+	if (!_active || idx < 0 || idx >= _shown.num) {
+		return false;
+	}
+
+	*play = _shown.play[idx];
+
+	_stat_selected++;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function logs the statistics of the hints.
+ *****************************************************************************/
+
+void hint_log_stats() {
+
+	log_debug("hints: %ld cancelled: %ld nodes: %ld redraws: %ld selected: %ld", _stat_hints, _stat_cancelled, _stat_nodes, _stat_redraws, _stat_selected);
+}
@@ -0,0 +1,328 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/******************************************************************************
+ * The source file implements the hover highlighting. The legal moves for the
+ * active dice are computed once for each dice state and cached. A hover only
+ * stores the field under the mouse, so a burst of motion events is cheap. The
+ * highlight layer is redrawn with the next tick, but not more often than the
+ * frame rate allows.
+ *
+ * A mark is a strip with the width of a point on the border of the board,
+ * next to the field.
+ *****************************************************************************/
+
+#include <string.h>
+
+#include "lib_logging.h"
+#include "lib_time.h"
+#include "lib_utils.h"
+#include "lib_color.h"
+#include "bg_defs.h"
+#include "rules.h"
+#include "s_theme.h"
+#include "s_board_areas.h"
+#include "hover.h"
+
+/******************************************************************************
+ * The maximum number of moves: one for each point and one for the bar.
+ *****************************************************************************/
+
+#define HOVER_MOVES_MAX (POINTS_NUM + 1)
+
+typedef struct {
+
+	s_field_id src;
+
+	s_field_id dst;
+
+} s_hover_mv;
+
+/******************************************************************************
+ * The key of the cache is the dice state. Each move changes the dice state,
+ * so a cached entry is valid as long as the key is the same.
+ *****************************************************************************/
+
+typedef struct {
+
+	e_owner turn;
+
+	e_player_phase player_phase[2];
+
+	s_dices dices;
+
+} s_hover_key;
+
+static s_hover_key _key;
+
+static bool _key_valid = false;
+
+static s_hover_mv _moves[HOVER_MOVES_MAX];
+
+static int _moves_num = 0;
+
+/******************************************************************************
+ * The state of the highlighting: the board, the colors of the marks, the
+ * field under the mouse and the marks that are on the highlight layer.
+ *****************************************************************************/
+
+static s_board *_board = NULL;
+
+static short _color_src;
+
+static short _color_dst;
+
+static s_field_id _hover = { .type = E_FIELD_NONE, .idx = FIELD_NONE_IDX };
+
+static s_field_id _marks[HOVER_MOVES_MAX + 1];
+
+static int _marks_num = 0;
+
+static bool _dirty = false;
+
+/******************************************************************************
+ * The frame pacing: the milliseconds for a frame and the earliest time for
+ * the next redraw.
+ *****************************************************************************/
+
+static int _frame_ms;
+
+static long _next_redraw = 0;
+
+//
+// The statistics: the number of hover events, the number of redraws and the
+// number of computations of the moves.
+//
+static long _stat_events = 0;
+
+static long _stat_redraws = 0;
+
+static long _stat_computes = 0;
+
+/******************************************************************************
+ * The function initializes the highlighting for a board.
+ *****************************************************************************/
+
+void hover_init(s_board *board, const s_game_cfg *game_cfg) {
+
+	_board = board;
+
+	_color_src = s_theme_color_create(game_cfg->clr_hl_src);
+
+	_color_dst = s_theme_color_create(game_cfg->clr_hl_dst);
+
+	_frame_ms = game_cfg->anim_fps > 0 ? 1000 / game_cfg->anim_fps : 0;
+
+	hover_reset();
+}
+
+/******************************************************************************
+ * The function sets the field under the mouse. The highlight layer is updated
+ * with the next tick.
+ *****************************************************************************/
+
+void hover_set(const s_field_id field_id) {
+
+	_stat_events++;
+
+	if (field_id.type == _hover.type && field_id.idx == _hover.idx) {
+		return;
+	}
+
+	_hover = field_id;
+
+	_dirty = true;
+}
+
+/******************************************************************************
+ * The function invalidates the cached moves and deletes the marks, for
+ * example if a new game starts. The board has to be printed afterwards.
+ *****************************************************************************/
+
+void hover_reset() {
+
+	s_tarr_set(_board->hl, S_TCHAR_UNUSED);
+
+	_key_valid = false;
+
+	_marks_num = 0;
+
+	_dirty = true;
+}
+
+/******************************************************************************
+ * The function computes the moves that are possible with the active dice.
+ *****************************************************************************/
+
+static void hover_moves_compute(const s_status *status, s_fieldset *fieldset) {
+
+	_stat_computes++;
+
+	_moves_num = 0;
+
+	//
+	// Without an active dice, there is nothing to move.
+	//
+	if (s_status_is_end(status) || s_status_need_confirm(status)) {
+		return;
+	}
+
+	for (int i = 0; i < HOVER_MOVES_MAX; i++) {
+
+		const s_field_id id = i < POINTS_NUM ? (s_field_id ) { .type = E_FIELD_POINTS, .idx = i } : (s_field_id ) { .type = E_FIELD_BAR, .idx = status->turn };
+
+		const s_field *field_src = rules_get_field_src(status, fieldset, id);
+		if (field_src == NULL) {
+			continue;
+		}
+
+		const s_field *field_dst = rules_can_mv(status, fieldset, field_src);
+		if (field_dst == NULL) {
+			continue;
+		}
+
+		_moves[_moves_num].src = field_src->id;
+		_moves[_moves_num].dst = field_dst->id;
+		_moves_num++;
+	}
+
+	log_debug("Moves: %d", _moves_num);
+}
+
+/******************************************************************************
+ * The function writes or deletes the mark of a field on the highlight layer
+ * and prints the area. A color of COLOR_UNDEF deletes the mark.
+ *****************************************************************************/
+
+static void hover_mark(const s_field_id field_id, const short color) {
+
+	const s_pos pos = s_board_areas_get_field(field_id);
+
+	const s_point mark_pos = { .row = pos.is_upper ? pos.pos.row - 1 : pos.pos.row + 1, .col = pos.pos.col };
+
+	const s_point mark_dim = { .row = 1, .col = POINTS_COL };
+
+	if (color == COLOR_UNDEF) {
+		s_tarr_del(_board->hl, mark_dim, mark_pos);
+
+	} else {
+		s_tarr_set_area(_board->hl, mark_dim, mark_pos, (s_tchar ) { EMPTY, color, color });
+	}
+
+	s_board_print_area(_board, mark_pos, mark_dim);
+}
+
+/******************************************************************************
+ * The function redraws the marks: the old marks are deleted and the sources
+ * of the moves and the destination of the hovered source are marked.
+ *****************************************************************************/
+
+static void hover_redraw() {
+
+	_stat_redraws++;
+
+	for (int i = 0; i < _marks_num; i++) {
+		hover_mark(_marks[i], COLOR_UNDEF);
+	}
+
+	_marks_num = 0;
+
+	for (int i = 0; i < _moves_num; i++) {
+
+		hover_mark(_moves[i].src, _color_src);
+
+		_marks[_marks_num++] = _moves[i].src;
+
+		if (_moves[i].src.type == _hover.type && _moves[i].src.idx == _hover.idx) {
+
+			hover_mark(_moves[i].dst, _color_dst);
+
+			_marks[_marks_num++] = _moves[i].dst;
+		}
+	}
+
+	s_board_mark(_board);
+}
+
+/******************************************************************************
+ * The function is called from the main loop. The moves are computed if the
+ * dice state changed and the marks are redrawn if something changed and the
+ * frame rate allows it. The function returns true if the marks were redrawn.
+ *****************************************************************************/
+
+bool hover_tick(const s_status *status, s_fieldset *fieldset) {
+
+	const s_hover_key key = { .turn = status->turn, .player_phase = { status->player_phase[0], status->player_phase[1] }, .dices = status->dices };
+
+	if (!_key_valid || memcmp(&key, &_key, sizeof(s_hover_key)) != 0) {
+
+		hover_moves_compute(status, fieldset);
+
+		_key = key;
+		_key_valid = true;
+		_dirty = true;
+	}
+
+	if (!_dirty) {
+		return false;
+	}
+
+	const long now = lt_now_ms();
+
+	if (now < _next_redraw) {
+		return false;
+	}
+
+	hover_redraw();
+
+	_dirty = false;
+
+	_next_redraw = now + _frame_ms;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function returns the number of milliseconds until the next redraw is
+ * due or -1 if nothing changed.
+ *****************************************************************************/
+
+int hover_timeout() {
+
+	if (!_dirty) {
+		return -1;
+	}
+
+	return (int) lu_max(_next_redraw - lt_now_ms(), 0);
+}
+
+/******************************************************************************
+ * The function logs the statistics of the highlighting.
+ *****************************************************************************/
+
+void hover_log_stats() {
+
+	log_debug("events: %ld redraws: %ld computes: %ld", _stat_events, _stat_redraws, _stat_computes);
+}
@@ -0,0 +1,243 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/******************************************************************************
+ * The source file implements the input layer. The first event is read with a
+ * timeout and the pending events are read without blocking afterwards. A
+ * mouse motion, that is followed by another mouse motion, is dropped, so a
+ * burst of motions results in a single motion.
+ *
+ * Each event gets the epoch of the state of the game. If a click changes the
+ * state, the epoch is incremented and the clicks that were read before are
+ * stale, because they refer to the old state.
+ *
+ * The latency is the time between reading an event and the next rendering
+ * after the event was processed.
+ *****************************************************************************/
+
+#include "lib_logging.h"
+#include "lib_time.h"
+#include "lib_utils.h"
+#include "input.h"
+
+/******************************************************************************
+ * The epoch of the state of the game.
+ *****************************************************************************/
+
+static unsigned long _epoch = 0;
+
+/******************************************************************************
+ * The read time of the oldest processed event, that is not rendered (-1 if
+ * there is none).
+ *****************************************************************************/
+
+static long _pending = -1;
+
+//
+// The statistics: the events, the collapsed motions, the stale clicks and the
+// latencies in microseconds.
+//
+static long _stat_events = 0;
+
+static long _stat_collapsed = 0;
+
+static long _stat_stale = 0;
+
+static long _stat_renders = 0;
+
+static long _stat_latency_sum = 0;
+
+static long _stat_latency_max = 0;
+
+/******************************************************************************
+ * The function initializes an event with a key and a mouse event (which can
+ * be NULL for keys). The event gets the current time and the current epoch.
+ *****************************************************************************/
+
+void input_event_init(s_input_event *event, const int key, const MEVENT *mouse) {
+
+	event->key = key;
+
+	if (mouse != NULL) {
+		event->mouse = *mouse;
+	}
+
+	event->time = lt_now_us();
+	event->epoch = _epoch;
+}
+
+/******************************************************************************
+ * The function reads an event. The function returns false if no event is
+ * available (the key is ERR) or the mouse event cannot be read.
+ *****************************************************************************/
+
+static bool input_read_event(s_input_event *event) {
+	MEVENT mouse;
+
+	event->key = wgetch(stdscr);
+
+	if (event->key == ERR) {
+		return false;
+	}
+
+	if (event->key == KEY_MOUSE && getmouse(&mouse) != OK) {
+		log_debug_str("Unable to get mouse event!");
+		return false;
+	}
+
+	input_event_init(event, event->key, event->key == KEY_MOUSE ? &mouse : NULL);
+
+	_stat_events++;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function collapses a batch of events. A motion replaces a directly
+ * preceding motion, all other events keep their order. The events are
+ * collapsed in place and the function returns the new number of events.
+ *
+ * (Unit tested)
+ *****************************************************************************/
+
+int input_collapse(s_input_event *events, const int num) {
+	int num_out = 0;
+
+	for (int i = 0; i < num; i++) {
+
+		if (num_out > 0 && input_is_motion(&events[i]) && input_is_motion(&events[num_out - 1])) {
+			events[num_out - 1] = events[i];
+
+		} else {
+			events[num_out++] = events[i];
+		}
+	}
+
+	return num_out;
+}
+
+/******************************************************************************
+ * The function reads the pending events. It waits for the first event with a
+ * timeout (-1 waits forever) and reads the remaining events without blocking.
+ * The events are collapsed afterwards. The function returns the number of
+ * events.
+ *****************************************************************************/
+
+int input_read(s_input_event *events, const int timeout) {
+	int num = 0;
+
+	wtimeout(stdscr, timeout);
+
+	while (num < INPUT_EVENTS_MAX) {
+
+		if (input_read_event(&events[num])) {
+			num++;
+
+		} else if (events[num].key == ERR) {
+			break;
+		}
+
+		//
+		// A mouse event that cannot be read does not end the reading.
+		//
+		wtimeout(stdscr, 0);
+	}
+
+	const int collapsed = input_collapse(events, num);
+
+	_stat_collapsed += num - collapsed;
+
+	return collapsed;
+}
+
+/******************************************************************************
+ * The function returns true if an event is a click that was read before the
+ * state of the game changed.
+ *****************************************************************************/
+
+bool input_is_stale(const s_input_event *event) {
+
+	if (!input_is_click(event) || event->epoch == _epoch) {
+		return false;
+	}
+
+	log_debug("Stale click: %d/%d", event->mouse.y, event->mouse.x);
+
+	_stat_stale++;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function is called if the state of the game changed. The clicks that
+ * were read before are stale.
+ *****************************************************************************/
+
+void input_state_changed() {
+	_epoch++;
+}
+
+/******************************************************************************
+ * The function is called if an event was processed. The latency is measured
+ * with the next rendering.
+ *****************************************************************************/
+
+void input_processed(const s_input_event *event) {
+
+	if (_pending < 0 || event->time < _pending) {
+		_pending = event->time;
+	}
+}
+
+/******************************************************************************
+ * The function is called after the rendering. It updates the latency of the
+ * processed events.
+ *****************************************************************************/
+
+void input_rendered() {
+
+	if (_pending < 0) {
+		return;
+	}
+
+	const long latency = lt_now_us() - _pending;
+
+	_stat_renders++;
+	_stat_latency_sum += latency;
+	_stat_latency_max = lu_max(_stat_latency_max, latency);
+
+	_pending = -1;
+}
+
+/******************************************************************************
+ * The function logs the statistics of the input.
+ *****************************************************************************/
+
+void input_log_stats() {
+
+	log_debug("events: %ld collapsed: %ld stale: %ld", _stat_events, _stat_collapsed, _stat_stale);
+
+	log_debug("latency (us) renders: %ld avg: %ld max: %ld", _stat_renders, _stat_renders > 0 ? _stat_latency_sum / _stat_renders : 0, _stat_latency_max);
+}
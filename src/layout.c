@@ -22,10 +22,14 @@
  * SOFTWARE.
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "lib_s_point.h"
 #include "lib_curses.h"
 #include "lib_utils.h"
 #include "lib_logging.h"
+#include "lib_frame.h"
 
 /******************************************************************************
  * The layout has 3 windows. One window for the board and one window for the
@@ -38,6 +42,27 @@ static WINDOW *_win_board = NULL;
 
 static WINDOW *_win_dice = NULL;
 
+//
+// If a color pair was recycled, the cells that use it show the new colors of
+// the pair until they are printed again. The rows of the board window and
+// the dice window, that have such cells, are marked. The taken rows are a
+// copy of the marks, that is printed by the caller, while new marks are set.
+//
+static bool _repaint = false;
+
+static bool *_repaint_rows = NULL;
+
+static bool *_repaint_taken = NULL;
+
+static bool _repaint_dice = false;
+
+//
+// The performance overlay is an optional window in the upper left corner of
+// the terminal. It is not derived, so it can be deleted without touching the
+// game window.
+//
+static WINDOW *_win_perf = NULL;
+
 /******************************************************************************
  *
  *****************************************************************************/
@@ -70,6 +95,13 @@ void layout_init(const s_point dim_board, const s_point dim_dice) {
 	}
 
 	log_debug("win dice: %d/%d", dim_dice.row, dim_dice.col);
+
+	_repaint_rows = calloc(dim_board.row, sizeof(bool));
+	_repaint_taken = calloc(dim_board.row, sizeof(bool));
+
+	if (_repaint_rows == NULL || _repaint_taken == NULL) {
+		log_exit_str("Unable to allocate memory!");
+	}
 }
 
 /******************************************************************************
@@ -78,11 +110,99 @@ void layout_init(const s_point dim_board, const s_point dim_dice) {
 
 void layout_free() {
 
+	lc_win_del(_win_perf);
+
 	lc_win_del(_win_dice);
 
 	lc_win_del(_win_board);
 
 	lc_win_del(_win_game);
+
+	free(_repaint_rows);
+	_repaint_rows = NULL;
+
+	free(_repaint_taken);
+	_repaint_taken = NULL;
+}
+
+/******************************************************************************
+ * The function creates or deletes the window of the performance overlay. If
+ * the window is deleted, the windows below are marked, so the area is
+ * restored with the next frame flush.
+ *****************************************************************************/
+
+void layout_perf_show(const s_point dim, const bool show) {
+
+	if (show == (_win_perf != NULL)) {
+		return;
+	}
+
+	if (show) {
+
+		if ((_win_perf = newwin(dim.row, dim.col, 0, 0)) == NULL) {
+			log_exit("Unable to create win dim: %d/%d", dim.row, dim.col);
+		}
+
+		return;
+	}
+
+	lc_win_del(_win_perf);
+	_win_perf = NULL;
+
+	touchwin(stdscr);
+	lf_win_mark(stdscr);
+
+	touchwin(_win_game);
+	lf_win_mark(_win_game);
+}
+
+/******************************************************************************
+ * The function is called if a color pair was recycled. It marks the rows of
+ * the board window and the dice window, that use the color pair. No color
+ * pairs are requested here, the rows are printed again from their sources
+ * before the frame is flushed.
+ *****************************************************************************/
+
+void layout_evict_pair(const short cp, const short fg, const short bg) {
+
+	const int rows = lc_win_pair_rows(_win_board, cp, _repaint_rows);
+
+	const bool dice = lc_win_pair_rows(_win_dice, cp, NULL) > 0;
+
+	if (rows > 0 || dice) {
+		log_debug("Repaint for color pair: %d fg: %d bg: %d rows: %d dice: %d", cp, fg, bg, rows, dice);
+
+		_repaint_dice = _repaint_dice || dice;
+		_repaint = true;
+	}
+}
+
+/******************************************************************************
+ * The function returns true if rows have to be printed again, because a
+ * color pair was recycled. The rows of the board window are returned with an
+ * array, which has an element for each row, and the flag, whether the dice
+ * window has to be printed. The marks are reset, so the printing of the rows
+ * can set new marks.
+ *****************************************************************************/
+
+bool layout_take_repaint(const bool **rows_board, bool *dice) {
+
+	if (!_repaint) {
+		return false;
+	}
+
+	const int num = getmaxy(_win_board);
+
+	memcpy(_repaint_taken, _repaint_rows, num * sizeof(bool));
+	memset(_repaint_rows, 0, num * sizeof(bool));
+
+	*rows_board = _repaint_taken;
+	*dice = _repaint_dice;
+
+	_repaint_dice = false;
+	_repaint = false;
+
+	return true;
 }
 
 /******************************************************************************
@@ -101,6 +221,15 @@ WINDOW* layout_win_dice() {
 	return _win_dice;
 }
 
+/******************************************************************************
+ * Simple getter function. The window of the performance overlay is NULL, if
+ * the overlay is not shown.
+ *****************************************************************************/
+
+WINDOW* layout_win_perf() {
+	return _win_perf;
+}
+
 /******************************************************************************
  * Simple getter function.
  *****************************************************************************/
@@ -0,0 +1,156 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+
+#include "lib_logging.h"
+#include "lib_arena.h"
+
+/******************************************************************************
+ * The offset of the data of a block. The block header is padded, so the data
+ * is aligned.
+ *****************************************************************************/
+
+#define LA_BLOCK_HEADER la_align_up(sizeof(s_arena_block))
+
+/******************************************************************************
+ * The function creates an arena. The block size is the size of the blocks,
+ * that are allocated if the arena needs more memory. The first block is
+ * allocated with the first allocation.
+ *****************************************************************************/
+
+s_arena* la_new(const size_t block_size) {
+
+	s_arena *arena = malloc(sizeof(s_arena));
+	if (arena == NULL) {
+		log_exit_str("Unable to allocate memory!");
+	}
+
+	arena->head = NULL;
+	arena->block_size = la_align_up(block_size);
+	arena->num_allocs = 0;
+	arena->num_blocks = 0;
+
+	return arena;
+}
+
+/******************************************************************************
+ * The function allocates a new block with a given size.
+ *****************************************************************************/
+
+static s_arena_block* la_block_new(s_arena *arena, const size_t size) {
+
+	s_arena_block *block = aligned_alloc(LA_ALIGN, LA_BLOCK_HEADER + size);
+	if (block == NULL) {
+		log_exit_str("Unable to allocate memory!");
+	}
+
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+
+	arena->num_blocks++;
+
+	log_debug("New block with size: %zu blocks: %d", size, arena->num_blocks);
+
+	return block;
+}
+
+/******************************************************************************
+ * The function allocates memory from the arena. The memory is aligned to
+ * LA_ALIGN bytes and is valid until the arena is freed.
+ *****************************************************************************/
+
+void* la_alloc(s_arena *arena, const size_t size) {
+	s_arena_block *block;
+
+	const size_t size_aligned = la_align_up(size);
+
+	arena->num_allocs++;
+
+	//
+	// An allocation that is larger than the block size gets its own block,
+	// which is added behind the head. So the free memory of the head can
+	// still be used.
+	//
+	if (size_aligned > arena->block_size) {
+		block = la_block_new(arena, size_aligned);
+
+		if (arena->head == NULL) {
+			arena->head = block;
+		} else {
+			block->next = arena->head->next;
+			arena->head->next = block;
+		}
+
+		block->used = size_aligned;
+
+		return (char*) block + LA_BLOCK_HEADER;
+	}
+
+	//
+	// If the head is full, a new block is the new head.
+	//
+	if (arena->head == NULL || arena->head->used + size_aligned > arena->head->size) {
+		block = la_block_new(arena, arena->block_size);
+		block->next = arena->head;
+		arena->head = block;
+	}
+
+	block = arena->head;
+
+	void *ptr = (char*) block + LA_BLOCK_HEADER + block->used;
+
+	block->used += size_aligned;
+
+	return ptr;
+}
+
+/******************************************************************************
+ * The function frees the arena with all of its blocks. The pointer is set to
+ * NULL to mark it as freed.
+ *****************************************************************************/
+
+void la_free(s_arena **arena) {
+
+	if (*arena == NULL) {
+		log_debug_str("Arena already freed!");
+		return;
+	}
+
+	log_debug("Allocations: %d blocks: %d", (*arena)->num_allocs, (*arena)->num_blocks);
+
+	s_arena_block *block = (*arena)->head;
+	s_arena_block *next;
+
+	while (block != NULL) {
+		next = block->next;
+		free(block);
+		block = next;
+	}
+
+	free(*arena);
+
+	*arena = NULL;
+}
@@ -23,16 +23,14 @@
  */
 
 #include "lib_logging.h"
+#include "lib_color.h"
 
+#include <stdbool.h>
 #include <ncurses.h>
 
-#ifdef DEBUG
-#include <search.h>
-#endif
-
 /*******************************************************************************
  * The definition of the color struct, which consists of a red, green and blue
- * value and a color id.
+ * value, the (quantized) key of the color and a color id.
  ******************************************************************************/
 
 typedef struct {
@@ -41,17 +39,20 @@ typedef struct {
 	short green;
 	short blue;
 
+	unsigned int key;
+
 	short color;
 
 } s_color;
 
 /*******************************************************************************
- * We define an array for the registered colors.
+ * We define an array for the registered colors. The size of the array is an
+ * upper limit, the number of colors that are used is limited by the budget.
  ******************************************************************************/
 
-#define _COLOR_MAX 128
+#define _COLOR_MAX 1024
 
-static size_t _color_num = 0;
+static int _color_num = 0;
 
 static s_color _color_array[_COLOR_MAX];
 
@@ -60,6 +61,62 @@ static s_color _color_array[_COLOR_MAX];
 //
 #define _COLOR_START 8
 
+//
+// The red, green and blue values of the curses default colors (0-7).
+//
+static const short _color_default[_COLOR_START][3] = {
+
+{ 0, 0, 0 }, { 680, 0, 0 }, { 0, 680, 0 }, { 680, 680, 0 },
+
+{ 0, 0, 680 }, { 680, 0, 680 }, { 0, 680, 680 }, { 680, 680, 680 } };
+
+/*******************************************************************************
+ * The registered colors are interned with an open addressing hash table. The
+ * table maps the key of a color to the index of the color in the array. The
+ * table stores the index + 1, so 0 marks an empty slot. The size is a power
+ * of two and twice the size of the array, so there is always an empty slot.
+ ******************************************************************************/
+
+#define _HASH_BITS 11
+
+#define _HASH_SIZE (1 << _HASH_BITS)
+
+static short _hash_table[_HASH_SIZE];
+
+/*******************************************************************************
+ * The configuration of the colors. The budget is the number of colors that can
+ * be created. A configured budget of 0 means that the budget is taken from the
+ * terminal (COLORS). It is resolved with the first color that is created,
+ * because COLORS is set by start_color(). The tolerance is the size of the
+ * quantization buckets for the red, green and blue values. Colors in the same
+ * bucket share a color id. A tolerance of 0 or 1 means no quantization.
+ ******************************************************************************/
+
+static int _budget_cfg = 0;
+
+static int _budget = -1;
+
+static short _tolerance = 0;
+
+/*******************************************************************************
+ * Statistics about the interning: the number of requests, the number of
+ * requests that reused a color and the number of requests that were mapped to
+ * the nearest color, because the budget was exhausted.
+ ******************************************************************************/
+
+static long _stat_requests = 0;
+
+static long _stat_hits = 0;
+
+static long _stat_nearest = 0;
+
+/*******************************************************************************
+ * In headless mode, the colors are only registered and not initialized with
+ * curses.
+ ******************************************************************************/
+
+static bool _headless = false;
+
 /*******************************************************************************
  * The macro logs the given color.
  ******************************************************************************/
@@ -67,57 +124,159 @@ static s_color _color_array[_COLOR_MAX];
 #define log_color(c) log_debug("color: %d r: %d g: %d b: %d",(c)->color, (c)->red, (c)->green, (c)->blue);
 
 /*******************************************************************************
- * The function compares two color structs by the red, green and blue value. The
- * function is only used in DEBUG mode, to ensure that a color combination is
- * allocated only once.
+ * The macro quantizes a red, green or blue value with the tolerance.
  ******************************************************************************/
 
-#ifdef DEBUG
+#define col_quantize(v) (_tolerance > 1 ? ((v) + _tolerance / 2) / _tolerance : (v))
 
-static int col_color_comp(const void *ptr1, const void *ptr2) {
+/*******************************************************************************
+ * The function computes the key of a color from the quantized red, green and
+ * blue values. Each of the values is between 0 and 1000, so the key is unique.
+ ******************************************************************************/
 
-	const s_color *color1 = (s_color*) ptr1;
-	const s_color *color2 = (s_color*) ptr2;
+static unsigned int col_color_key(const short r, const short g, const short b) {
+	return ((unsigned int) col_quantize(r) * 1001u + (unsigned int) col_quantize(g)) * 1001u + (unsigned int) col_quantize(b);
+}
 
-	int result;
+/*******************************************************************************
+ * The function returns the start slot of a key in the hash table (Fibonacci
+ * hashing).
+ ******************************************************************************/
 
-	//
-	// First compare the red value, then the green and the blue value.
-	//
-	if (color1->red != color2->red) {
-		result = color1->red - color2->red;
+static unsigned int col_hash_slot(const unsigned int key) {
+	return (unsigned int) ((key * 2654435761u) >> (32 - _HASH_BITS)) & (_HASH_SIZE - 1);
+}
+
+/*******************************************************************************
+ * The function initializes the color module with a budget and a tolerance. It
+ * removes all registered colors, so it has to be called before colors are
+ * created. A budget of 0 means that the budget is taken from the terminal.
+ ******************************************************************************/
+
+void col_init(const int budget, const short tolerance) {
+
+	log_debug("budget: %d tolerance: %d", budget, tolerance);
+
+	_budget_cfg = budget;
+	_budget = -1;
 
-	} else if (color1->green != color2->green) {
-		result = color1->green - color2->green;
+	_tolerance = tolerance;
 
-	} else {
-		result = color1->blue - color2->blue;
+	_color_num = 0;
+
+	for (int i = 0; i < _HASH_SIZE; i++) {
+		_hash_table[i] = 0;
 	}
 
-	log_color(color1);
+	_stat_requests = 0;
+	_stat_hits = 0;
+	_stat_nearest = 0;
+}
+
+/*******************************************************************************
+ * The function resolves the budget. If the budget is not configured, it is
+ * taken from the number of colors of the terminal, without the default colors.
+ * In headless mode there is no terminal, so the array size is used. The budget
+ * is always limited by the array size.
+ ******************************************************************************/
 
-	log_color(color2);
+static int col_budget_resolve() {
 
-	log_debug("result: %d", result);
+	int budget = _budget_cfg;
 
-	return result;
+	if (budget <= 0) {
+		budget = _headless ? _COLOR_MAX : COLORS - _COLOR_START;
+	}
+
+	if (budget <= 0) {
+		log_exit("Terminal has not enough colors: %d", COLORS);
+	}
+
+	if (budget > _COLOR_MAX) {
+		budget = _COLOR_MAX;
+	}
+
+	log_debug("Color budget: %d (terminal: %d)", budget, COLORS);
+
+	return budget;
 }
 
-#endif
+/*******************************************************************************
+ * The function returns the registered color, which is nearest to the given
+ * red, green and blue values. The distance is the euclidean distance in rgb.
+ * The function is only called if the budget is exhausted, so a linear search
+ * is ok.
+ ******************************************************************************/
+
+static const s_color* col_color_nearest(const short r, const short g, const short b) {
+
+	const s_color *result = NULL;
+	long dist_min = -1;
+
+	for (int i = 0; i < _color_num; i++) {
+
+		const s_color *col_ptr = &_color_array[i];
+
+		const long dr = col_ptr->red - r;
+		const long dg = col_ptr->green - g;
+		const long db = col_ptr->blue - b;
+
+		const long dist = dr * dr + dg * dg + db * db;
+
+		if (dist_min < 0 || dist < dist_min) {
+			dist_min = dist;
+			result = col_ptr;
+		}
+	}
+
+	return result;
+}
 
 /*******************************************************************************
  * The function creates a color by its red, green and blue value. Each value has
- * to be between 0 and 1000. The function returns the color id. The color is
- * registered in an array. Currently there is no use for the registered colors.
+ * to be between 0 and 1000. The function returns the color id. The colors are
+ * interned, so a color that is already registered (with respect to the
+ * tolerance) is reused. If the budget is exhausted, the nearest registered
+ * color is returned.
  ******************************************************************************/
 
 short col_color_create(const short r, const short g, const short b) {
 
+	_stat_requests++;
+
+	if (_budget < 0) {
+		_budget = col_budget_resolve();
+	}
+
 	//
-	// Ensure that there is space for an other s_color_pair.
+	// Search the key in the hash table with linear probing.
 	//
-	if (_color_num == _COLOR_MAX) {
-		log_exit_str("Too many colors!");
+	const unsigned int key = col_color_key(r, g, b);
+
+	unsigned int slot = col_hash_slot(key);
+
+	while (_hash_table[slot] != 0) {
+
+		const s_color *col_ptr = &_color_array[_hash_table[slot] - 1];
+
+		if (col_ptr->key == key) {
+			_stat_hits++;
+			return col_ptr->color;
+		}
+
+		slot = (slot + 1) & (_HASH_SIZE - 1);
+	}
+
+	//
+	// If the budget is exhausted, we use the nearest color.
+	//
+	if (_color_num == _budget) {
+		const s_color *col_ptr = col_color_nearest(r, g, b);
+
+		log_debug("Budget exhausted r: %d g: %d b: %d => %d", r, g, b, col_ptr->color);
+
+		_stat_nearest++;
+		return col_ptr->color;
 	}
 
 	//
@@ -128,33 +287,198 @@ short col_color_create(const short r, const short g, const short b) {
 	col_ptr->red = r;
 	col_ptr->green = g;
 	col_ptr->blue = b;
+	col_ptr->key = key;
 	col_ptr->color = _color_num + _COLOR_START;
 
-#ifdef DEBUG
-
-	//
-	// In DEBUG mode we ensure that the same color is not registered. A linear
-	// search should be ok in DEBUG mode.
-	//
-	if (lfind(col_ptr, _color_array, &_color_num, sizeof(s_color), col_color_comp) != NULL) {
-		log_exit("Color already defined: %d r: %d g: %d b: %d", col_ptr->color, col_ptr->red, col_ptr->green, col_ptr->blue);
-	}
-
-#endif
-
 	//
 	// Initialize the color.
 	//
-	if (init_color(col_ptr->color, col_ptr->red, col_ptr->green, col_ptr->blue)) {
+	if (!_headless && init_color(col_ptr->color, col_ptr->red, col_ptr->green, col_ptr->blue)) {
 		log_exit_str("Unable to create color!");
 	}
 
 	log_color(col_ptr);
 
 	//
-	// Update the number of colors
+	// Update the number of colors and register the color in the hash table.
 	//
 	_color_num++;
 
+	_hash_table[slot] = _color_num;
+
 	return col_ptr->color;
 }
+
+/*******************************************************************************
+ * The function sets the headless mode. In headless mode, nothing is rendered
+ * with curses, so there is no need to initialize the colors.
+ ******************************************************************************/
+
+void col_set_headless(const bool headless) {
+	_headless = headless;
+}
+
+/*******************************************************************************
+ * The function gets the red, green and blue value of a color, which is either
+ * a curses default color or a registered color. The values are between 0 and
+ * 1000. The function returns false if the color is not known.
+ ******************************************************************************/
+
+bool col_color_rgb(const short color, short *r, short *g, short *b) {
+
+	if (color >= 0 && color < _COLOR_START) {
+		*r = _color_default[color][0];
+		*g = _color_default[color][1];
+		*b = _color_default[color][2];
+		return true;
+	}
+
+	const int idx = color - _COLOR_START;
+
+	if (idx < 0 || idx >= _color_num) {
+		return false;
+	}
+
+	*r = _color_array[idx].red;
+	*g = _color_array[idx].green;
+	*b = _color_array[idx].blue;
+
+	return true;
+}
+
+/*******************************************************************************
+ * The function returns the index of the nearest level of the 6x6x6 color cube
+ * of the 256 color palette for a value (0-255). The levels are: 0, 95, 135,
+ * 175, 215, 255.
+ ******************************************************************************/
+
+static int col_cube_idx(const int value) {
+
+	if (value < 48) {
+		return 0;
+	}
+
+	if (value < 115) {
+		return 1;
+	}
+
+	return (value - 35) / 40;
+}
+
+#define col_cube_value(i) ((i) == 0 ? 0 : (i) * 40 + 55)
+
+/*******************************************************************************
+ * The function returns the nearest color of the 256 color palette for a
+ * color. The nearest color is either from the color cube (16-231) or from the
+ * grayscale ramp (232-255). The curses default colors are unchanged. The
+ * function returns COLOR_UNDEF if the color is not known.
+ ******************************************************************************/
+
+short col_color_256(const short color) {
+	short r, g, b;
+
+	if (color >= 0 && color < _COLOR_START) {
+		return color;
+	}
+
+	if (!col_color_rgb(color, &r, &g, &b)) {
+		return COLOR_UNDEF;
+	}
+
+	//
+	// Scale the values to 0-255.
+	//
+	const int r8 = r * 255 / 1000;
+	const int g8 = g * 255 / 1000;
+	const int b8 = b * 255 / 1000;
+
+	const int ri = col_cube_idx(r8);
+	const int gi = col_cube_idx(g8);
+	const int bi = col_cube_idx(b8);
+
+	const int dr = r8 - col_cube_value(ri);
+	const int dg = g8 - col_cube_value(gi);
+	const int db = b8 - col_cube_value(bi);
+
+	//
+	// The grayscale ramp has the values: 8, 18, ..., 238
+	//
+	const int avg = (r8 + g8 + b8) / 3;
+	const int gray_idx = avg < 8 ? 0 : avg > 238 ? 23 : (avg - 8 + 5) / 10;
+	const int gray = gray_idx * 10 + 8;
+
+	const int dist_cube = dr * dr + dg * dg + db * db;
+	const int dist_gray = (r8 - gray) * (r8 - gray) + (g8 - gray) * (g8 - gray) + (b8 - gray) * (b8 - gray);
+
+	if (dist_gray < dist_cube) {
+		return 232 + gray_idx;
+	}
+
+	return 16 + 36 * ri + 6 * gi + bi;
+}
+
+/*******************************************************************************
+ * The function returns the number of registered colors.
+ ******************************************************************************/
+
+int col_color_num() {
+	return _color_num;
+}
+
+/*******************************************************************************
+ * The function writes the red, green and blue values of the registered colors
+ * to a stream, in the order of the color ids. The function returns false on
+ * errors.
+ ******************************************************************************/
+
+bool col_write(FILE *stream) {
+
+	if (fwrite(&_color_num, sizeof(int), 1, stream) != 1) {
+		return false;
+	}
+
+	for (int i = 0; i < _color_num; i++) {
+		if (fwrite(&_color_array[i], sizeof(s_color), 1, stream) != 1) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*******************************************************************************
+ * The function reads colors from a stream and creates them, so they get the
+ * same color ids. This has to be called before other colors are created. The
+ * function returns false on errors.
+ ******************************************************************************/
+
+bool col_read(FILE *stream) {
+	s_color color;
+	int num;
+
+	if (fread(&num, sizeof(int), 1, stream) != 1 || num < 0 || num > _COLOR_MAX) {
+		return false;
+	}
+
+	for (int i = 0; i < num; i++) {
+
+		if (fread(&color, sizeof(s_color), 1, stream) != 1) {
+			return false;
+		}
+
+		if (col_color_create(color.red, color.green, color.blue) != color.color) {
+			log_debug("Color id differs: %d", color.color);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*******************************************************************************
+ * The function logs the statistics of the color interning.
+ ******************************************************************************/
+
+void col_log_stats() {
+	log_debug("colors: %d budget: %d requests: %ld hits: %ld nearest: %ld", _color_num, _budget, _stat_requests, _stat_hits, _stat_nearest);
+}
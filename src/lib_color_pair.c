@@ -23,12 +23,16 @@
  */
 
 #include "lib_logging.h"
+#include "lib_perf.h"
+#include "lib_color_pair.h"
 
+#include <string.h>
 #include <ncurses.h>
 
 /*******************************************************************************
  * The definition of the color pair struct contains a foreground and a
- * background color and an id for the color pair.
+ * background color, an id for the color pair and the frame in which the color
+ * pair was used the last time.
  ******************************************************************************/
 
 typedef struct {
@@ -37,13 +41,17 @@ typedef struct {
 	short bg;
 	short cp;
 
+	long last_used;
+
 } s_color_pair;
 
 /*******************************************************************************
- * We define an array for the registered colors pairs.
+ * We define an array for the registered colors pairs. The color pairs are a
+ * bounded cache. The number of color pairs is limited by the budget. If the
+ * budget is exhausted, the least recently used color pair is recycled.
  ******************************************************************************/
 
-#define CP_MAX 128
+#define CP_MAX 1024
 
 static size_t _cp_num = 0;
 
@@ -56,6 +64,35 @@ static s_color_pair _cp_array[CP_MAX];
 
 static bool _is_sorted = false;
 
+/*******************************************************************************
+ * The configured budget (0 means that the budget is taken from COLOR_PAIRS)
+ * and the resolved budget (-1 means not resolved).
+ ******************************************************************************/
+
+static int _budget_cfg = 0;
+
+static int _budget = -1;
+
+/*******************************************************************************
+ * The current frame, which is used to find the least recently used pair.
+ ******************************************************************************/
+
+static long _frame = 0;
+
+/*******************************************************************************
+ * The function that is called if a color pair is recycled. The cells that use
+ * the color pair show the new colors, so they have to be printed again from
+ * their sources. The function must not request color pairs itself.
+ ******************************************************************************/
+
+static void (*_evict_fct)(const short cp, const short fg, const short bg) = NULL;
+
+/*******************************************************************************
+ * The statistics of the color pairs.
+ ******************************************************************************/
+
+static s_cp_stats _stats = { 0 };
+
 /*******************************************************************************
  * The macro logs the given color pair.
  ******************************************************************************/
@@ -105,31 +142,153 @@ static void cp_color_pair_sort() {
 	_is_sorted = true;
 }
 
+/*******************************************************************************
+ * The function initializes the color pairs with a budget. It removes all
+ * registered color pairs. A budget of 0 means that the budget is taken from
+ * the terminal (COLOR_PAIRS).
+ ******************************************************************************/
+
+void cp_init(const int budget) {
+
+	log_debug("budget: %d", budget);
+
+	_budget_cfg = budget;
+	_budget = -1;
+
+	_cp_num = 0;
+	_is_sorted = false;
+
+	_frame = 0;
+
+	_stats = (s_cp_stats ) { 0 };
+}
+
+/*******************************************************************************
+ * The function resolves the budget. If the budget is not configured, it is
+ * taken from the terminal, without the reserved pairs. Without a terminal the
+ * array size is used. The budget is always limited by the array size.
+ ******************************************************************************/
+
+static int cp_budget_resolve() {
+
+	int budget = _budget_cfg;
+
+	if (budget <= 0) {
+		budget = COLOR_PAIRS > CP_START ? COLOR_PAIRS - CP_START : CP_MAX;
+	}
+
+	if (budget > CP_MAX) {
+		budget = CP_MAX;
+	}
+
+	log_debug("Color pair budget: %d (terminal: %d)", budget, COLOR_PAIRS);
+
+	return budget;
+}
+
+/*******************************************************************************
+ * The function sets the function that is called if a color pair is recycled.
+ ******************************************************************************/
+
+void cp_set_evict_fct(void (*evict_fct)(const short cp, const short fg, const short bg)) {
+	_evict_fct = evict_fct;
+}
+
+/*******************************************************************************
+ * The function is called at the end of a frame. Color pairs that were used in
+ * the current frame are recycled last.
+ ******************************************************************************/
+
+void cp_frame_next() {
+	_frame++;
+}
+
+/*******************************************************************************
+ * The function returns the least recently used color pair, which is recycled.
+ * Color pairs that are used in the current frame are not recycled, which
+ * includes the pairs that were just created. If all color pairs are used in
+ * the current frame, the function returns NULL.
+ ******************************************************************************/
+
+static s_color_pair* cp_color_pair_lru() {
+
+	s_color_pair *result = NULL;
+
+	for (size_t i = 0; i < _cp_num; i++) {
+
+		if (_cp_array[i].last_used >= _frame) {
+			continue;
+		}
+
+		if (result == NULL || _cp_array[i].last_used < result->last_used) {
+			result = &_cp_array[i];
+		}
+	}
+
+	return result;
+}
+
 /*******************************************************************************
  * The function adds a color pair to the array. The array is not sorted. If you
  * want to add more than one color pair, you can do this without sorting the
- * array every time.
+ * array every time. If the budget is exhausted, the least recently used color
+ * pair is recycled and the cells that use it are invalidated. If the frame
+ * needs more color pairs than the budget, the default color pair 0 is
+ * returned.
  *
  * (Unit tested)
  ******************************************************************************/
 
 short cp_color_pair_add(const short fg, const short bg) {
 
-	//
-	// Ensure that there is space for an other s_color_pair.
-	//
-	if (_cp_num == CP_MAX) {
-		log_exit_str("Too many pairs!");
+	if (_budget < 0) {
+		_budget = cp_budget_resolve();
 	}
 
+	s_color_pair *cp_ptr;
+
+	short evict_fg = 0, evict_bg = 0;
+
+	const bool evict = (int) _cp_num == _budget;
+
 	//
-	// Set the array data
+	// If the budget is exhausted, we recycle the least recently used pair.
+	// Otherwise we use the next free element of the array.
 	//
-	s_color_pair *cp_ptr = &_cp_array[_cp_num];
+	if (evict) {
+		cp_ptr = cp_color_pair_lru();
+
+		if (cp_ptr == NULL) {
+
+			//
+			// The cells are shown with the default colors, which is worth a
+			// warning, but only once. The overflows are counted.
+			//
+			if (_stats.overflows == 0) {
+				log_warn("All %d color pairs used in frame: %ld - using the default pair (fg: %d bg: %d)", _budget, _frame, fg, bg);
+			}
+
+			_stats.overflows++;
+			return 0;
+		}
+
+		evict_fg = cp_ptr->fg;
+		evict_bg = cp_ptr->bg;
+
+		log_debug("Recycle color pair: %d fg: %d bg: %d", cp_ptr->cp, evict_fg, evict_bg);
+
+		_stats.evictions++;
+
+	} else {
+		cp_ptr = &_cp_array[_cp_num];
+		cp_ptr->cp = _cp_num + CP_START;
+
+		_cp_num++;
+	}
 
 	cp_ptr->fg = fg;
 	cp_ptr->bg = bg;
-	cp_ptr->cp = _cp_num + CP_START;
+	cp_ptr->last_used = _frame;
 
 	if (init_pair(cp_ptr->cp, cp_ptr->fg, cp_ptr->bg)) {
 		log_exit("Unable to create color pair: %d fg: %d bg: %d", cp_ptr->cp, cp_ptr->fg, cp_ptr->bg);
@@ -137,17 +296,26 @@ short cp_color_pair_add(const short fg, const short bg) {
 
 	log_color_pair(cp_ptr);
 
-	//
-	// Update the number of pairs
-	//
-	_cp_num++;
+	_stats.adds++;
 
 	//
 	// If we added a new element, the array is sorted.
 	//
 	_is_sorted = false;
 
-	return cp_ptr->cp;
+	//
+	// The pointer is not valid after sorting, so we copy the id.
+	//
+	const short cp = cp_ptr->cp;
+
+	//
+	// Invalidate the cells that use the recycled pair with its old colors.
+	//
+	if (evict && _evict_fct != NULL) {
+		(*_evict_fct)(cp, evict_fg, evict_bg);
+	}
+
+	return cp;
 }
 
 /*******************************************************************************
@@ -160,7 +328,11 @@ short cp_color_pair_add(const short fg, const short bg) {
 
 short cp_color_pair_get(const short fg, const short bg) {
 
-	log_debug("Search fg: %d bg: %d", fg, bg);
+	pf_count(PF_COLOR_PAIR_GET);
+
+	log_trace("Search fg: %d bg: %d", fg, bg);
+
+	_stats.requests++;
 
 	if (!_is_sorted) {
 		cp_color_pair_sort();
@@ -174,13 +346,15 @@ short cp_color_pair_get(const short fg, const short bg) {
 	//
 	// Do the searching.
 	//
-	const s_color_pair *result = bsearch(&key, _cp_array, _cp_num, sizeof(s_color_pair), col_color_pair_comp);
+	s_color_pair *result = bsearch(&key, _cp_array, _cp_num, sizeof(s_color_pair), col_color_pair_comp);
 
 	//
 	// If the color pair was found, we can return the id.
 	//
 	if (result != NULL) {
-		log_color_pair(result);
+		log_trace("color pair: %d fg: %d bg: %d", result->cp, result->fg, result->bg);
+		result->last_used = _frame;
+		_stats.hits++;
 		return result->cp;
 	}
 
@@ -190,3 +364,103 @@ short cp_color_pair_get(const short fg, const short bg) {
 	//
 	return cp_color_pair_add(fg, bg);
 }
+
+/*******************************************************************************
+ * The comparison function for qsort, which compares two s_color_pair by their
+ * id.
+ ******************************************************************************/
+
+static int cp_color_pair_comp_id(const void *ptr1, const void *ptr2) {
+	return ((s_color_pair*) ptr1)->cp - ((s_color_pair*) ptr2)->cp;
+}
+
+/*******************************************************************************
+ * The function writes the foreground and background colors of the color
+ * pairs to a stream, in the order of the color pair ids. The function returns
+ * false on errors.
+ ******************************************************************************/
+
+bool cp_write(FILE *stream) {
+	s_color_pair pairs[CP_MAX];
+
+	memcpy(pairs, _cp_array, _cp_num * sizeof(s_color_pair));
+
+	qsort(pairs, _cp_num, sizeof(s_color_pair), cp_color_pair_comp_id);
+
+	return fwrite(&_cp_num, sizeof(size_t), 1, stream) == 1 && fwrite(pairs, sizeof(s_color_pair), _cp_num, stream) == _cp_num;
+}
+
+/*******************************************************************************
+ * The function reads color pairs from a stream and creates them, so they get
+ * the same color pair ids. This has to be called before other color pairs are
+ * created. The function returns false on errors.
+ ******************************************************************************/
+
+bool cp_read(FILE *stream) {
+	s_color_pair pair;
+	size_t num;
+
+	if (fread(&num, sizeof(size_t), 1, stream) != 1 || num > CP_MAX) {
+		return false;
+	}
+
+	for (size_t i = 0; i < num; i++) {
+
+		if (fread(&pair, sizeof(s_color_pair), 1, stream) != 1) {
+			return false;
+		}
+
+		if (cp_color_pair_add(pair.fg, pair.bg) != pair.cp) {
+			log_debug("Color pair id differs: %d", pair.cp);
+			return false;
+		}
+	}
+
+	//
+	// The color pairs from the stream are not used yet, so they can be
+	// recycled in the current frame.
+	//
+	for (size_t i = 0; i < _cp_num; i++) {
+		_cp_array[i].last_used = _frame - 1;
+	}
+
+	return true;
+}
+
+/*******************************************************************************
+ * The function returns the number of color pairs.
+ ******************************************************************************/
+
+int cp_color_pair_num() {
+	return (int) _cp_num;
+}
+
+/*******************************************************************************
+ * The function returns the budget of the color pairs, which is the limit of
+ * the pairs in use.
+ ******************************************************************************/
+
+int cp_color_pair_budget() {
+
+	if (_budget < 0) {
+		_budget = cp_budget_resolve();
+	}
+
+	return _budget;
+}
+
+/*******************************************************************************
+ * The function copies the statistics of the color pairs.
+ ******************************************************************************/
+
+void cp_stats(s_cp_stats *stats) {
+	*stats = _stats;
+}
+
+/*******************************************************************************
+ * The function logs the statistics of the color pairs.
+ ******************************************************************************/
+
+void cp_log_stats() {
+	log_debug("pairs: %ld budget: %d requests: %ld hits: %ld adds: %ld evictions: %ld overflows: %ld", _cp_num, _budget, _stats.requests, _stats.hits, _stats.adds, _stats.evictions, _stats.overflows);
+}
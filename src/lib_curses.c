@@ -28,6 +28,7 @@
 #include "lib_logging.h"
 #include "lib_string.h"
 #include "lib_utils.h"
+#include "lib_color_pair.h"
 
 /******************************************************************************
  * The function initializes the main features of ncurses. It does not start
@@ -185,6 +186,53 @@ void lc_win_del(WINDOW *win) {
 	}
 }
 
+/******************************************************************************
+ * The function marks the rows of the window, that have a cell with a color
+ * pair. It is called if a color pair was recycled, to find the rows that have
+ * to be printed again. The array has an element for each row of the window,
+ * the elements of the other rows are not changed. The function returns the
+ * number of marked rows. If the array is NULL, the function only checks
+ * whether the color pair is used and stops with the first row.
+ *****************************************************************************/
+
+int lc_win_pair_rows(WINDOW *win, const short cp, bool *rows) {
+	cchar_t cchar;
+	wchar_t wch[CCHARW_MAX];
+	attr_t attrs;
+	short pair;
+	int num = 0;
+
+	//
+	// Ensure that the window is initialized.
+	//
+	if (win == NULL) {
+		return 0;
+	}
+
+	for (int row = 0; row < getmaxy(win); row++) {
+		for (int col = 0; col < getmaxx(win); col++) {
+
+			if (mvwin_wch(win, row, col, &cchar) == ERR || getcchar(&cchar, wch, &attrs, &pair, NULL) == ERR) {
+				log_exit("Unable to get cell: %d/%d", row, col);
+			}
+
+			if (pair != cp) {
+				continue;
+			}
+
+			if (rows == NULL) {
+				return 1;
+			}
+
+			rows[row] = true;
+			num++;
+			break;
+		}
+	}
+
+	return num;
+}
+
 /******************************************************************************
  * The function refreshes a window. It is a simple wrapper with error handling.
  *****************************************************************************/
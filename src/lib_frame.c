@@ -0,0 +1,138 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "lib_logging.h"
+#include "lib_perf.h"
+#include "lib_frame.h"
+#include "lib_color_pair.h"
+
+/******************************************************************************
+ * The flag is set if at least one window was marked since the last flush.
+ *****************************************************************************/
+
+static bool _dirty = false;
+
+/******************************************************************************
+ * The statistics of the compositor.
+ *****************************************************************************/
+
+static s_frame_stats _stats = { .frames = 0, .flushes = 0, .marks = 0 };
+
+/******************************************************************************
+ * An optional function, that presents content which is not rendered by
+ * curses, after the windows were written to the terminal.
+ *****************************************************************************/
+
+static void (*_present_fct)() = NULL;
+
+/******************************************************************************
+ * The function marks a window as changed. The window is copied to the virtual
+ * screen, but nothing is written to the terminal.
+ *****************************************************************************/
+
+void lf_win_mark(WINDOW *win) {
+
+	//
+	// Ensure that the window is initialized.
+	//
+	if (win == NULL) {
+		return;
+	}
+
+	if (wnoutrefresh(win) == ERR) {
+		log_exit_str("Unable to mark window!");
+	}
+
+	_stats.marks++;
+
+	_dirty = true;
+}
+
+/******************************************************************************
+ * The function marks the frame as changed, without a window. This is used for
+ * content, which is presented with the present function.
+ *****************************************************************************/
+
+void lf_frame_mark() {
+	_dirty = true;
+}
+
+/******************************************************************************
+ * The function sets the function, that is called on each flush of a changed
+ * frame, after doupdate().
+ *****************************************************************************/
+
+void lf_frame_set_present(void (*present_fct)()) {
+	_present_fct = present_fct;
+}
+
+/******************************************************************************
+ * The function finishes a frame. If windows were marked, the changes are
+ * written to the terminal with a single doupdate() call.
+ *****************************************************************************/
+
+void lf_frame_flush() {
+
+	pf_scope(PF_FRAME_FLUSH);
+
+	_stats.frames++;
+
+	//
+	// Color pairs that are used in the next frame are newer than the color
+	// pairs of this frame.
+	//
+	cp_frame_next();
+
+	if (!_dirty) {
+		return;
+	}
+
+	if (doupdate() == ERR) {
+		log_exit_str("Unable to update the screen!");
+	}
+
+	if (_present_fct != NULL) {
+		(*_present_fct)();
+	}
+
+	_stats.flushes++;
+
+	_dirty = false;
+}
+
+/******************************************************************************
+ * The function copies the statistics of the compositor.
+ *****************************************************************************/
+
+void lf_frame_stats(s_frame_stats *stats) {
+	*stats = _stats;
+}
+
+/******************************************************************************
+ * The function logs the statistics of the compositor.
+ *****************************************************************************/
+
+void lf_frame_log_stats() {
+	log_debug("frames: %ld flushes: %ld marks: %ld", _stats.frames, _stats.flushes, _stats.marks);
+}
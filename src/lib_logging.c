@@ -22,10 +22,734 @@
  * SOFTWARE.
  */
 
+#include <pthread.h>
 #include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <wchar.h>
 
 #include "lib_logging.h"
 
+/******************************************************************************
+ * The default and the maximum number of records of a ring, the flush interval
+ * of the background thread in milliseconds and the size of a formatted line
+ * and the output buffer. A record has about 280 bytes, so a ring with the
+ * default size has about 280 KB. The game writes less than 1000 records in a
+ * flush interval, even with the debug level.
+ *****************************************************************************/
+
+#define LOG_RING_SIZE 1024
+
+#define LOG_RING_MAX (1024 * 1024)
+
+#define LOG_FLUSH_MS 20
+
+#define LOG_LINE_SIZE 1024
+
+#define LOG_OUT_SIZE (64 * 1024)
+
+/******************************************************************************
+ * The ring of a thread is a single producer, single consumer queue. The head
+ * is only written by the thread, the tail only by the thread, that flushes
+ * the records. If the ring is full, the record is dropped and counted.
+ *****************************************************************************/
+
+typedef struct s_log_ring {
+
+	_Alignas(64) atomic_ulong head;
+
+	_Alignas(64) atomic_ulong tail;
+
+	atomic_long dropped;
+
+	struct s_log_ring *next;
+
+	s_log_rec rec[];
+
+} s_log_ring;
+
+//
+// The number of records of each ring, which can be set with the environment
+// variable BAGA_LOG_RING. It is read before the first ring is created.
+//
+static unsigned long _ring_size = LOG_RING_SIZE;
+
+//
+// The list of the rings of all threads. A ring is added with the first
+// record of a thread and is never removed.
+//
+static _Atomic(s_log_ring *) _rings = NULL;
+
+static _Thread_local s_log_ring *_ring = NULL;
+
+/******************************************************************************
+ * The flag for the synchronous mode and the background thread. The mutex
+ * serializes the flushes and the output buffer.
+ *****************************************************************************/
+
+static atomic_bool _sync = false;
+
+static pthread_t _thread;
+
+static bool _running = false;
+
+static atomic_bool _stop = false;
+
+static pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static char _out[LOG_OUT_SIZE];
+
+//
+// The names of the levels, which are used in the environment variable and
+// in the output.
+//
+static const char *_level_env[] = { "trace", "debug", "info", "warn", "off" };
+
+static const char *_level_str[] = { "TRACE", "DEBUG", "INFO", "WARN" };
+
+/******************************************************************************
+ * The runtime levels: the minimum level and the configured levels of the
+ * modules. The modules are added to the list, with their first log call, so
+ * their masks can be updated. The list and the levels are protected by the
+ * mutex.
+ *****************************************************************************/
+
+#define LOG_MODULES_MAX 32
+
+#define LOG_MODULE_NAME_SIZE 32
+
+typedef struct {
+
+	char name[LOG_MODULE_NAME_SIZE];
+
+	int level;
+
+} s_log_module_cfg;
+
+static pthread_mutex_t _module_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int _level = LOG_LEVEL_DEBUG;
+
+static s_log_module_cfg _module_cfg[LOG_MODULES_MAX];
+
+static int _module_cfg_num = 0;
+
+static s_log_module *_modules = NULL;
+
+/******************************************************************************
+ * The functions convert the arguments of a log call. A NULL string is stored
+ * as a pointer, which is printed as "(null)".
+ *****************************************************************************/
+
+s_log_arg log_arg_int(const long long value) {
+	return (s_log_arg ) { .type = LOG_ARG_INT, .i = value };
+}
+
+s_log_arg log_arg_dbl(const double value) {
+	return (s_log_arg ) { .type = LOG_ARG_DBL, .d = value };
+}
+
+s_log_arg log_arg_str(const char *value) {
+	return (s_log_arg ) { .type = value == NULL ? LOG_ARG_PTR : LOG_ARG_STR, .s = value };
+}
+
+s_log_arg log_arg_ptr(const void *value) {
+	return (s_log_arg ) { .type = LOG_ARG_PTR, .p = value };
+}
+
+/******************************************************************************
+ * The function initializes a record. The strings are copied to the record,
+ * so the record does not depend on buffers of the caller. A long string is
+ * cut.
+ *****************************************************************************/
+
+void log_rec_init(s_log_rec *rec, const s_log_site *site, const int num, const s_log_arg *arg) {
+	struct timespec ts;
+	size_t used = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	rec->site = site;
+	rec->time = ts.tv_sec * 1000000000L + ts.tv_nsec;
+	rec->num = num < LOG_ARGS_MAX ? num : LOG_ARGS_MAX;
+
+	//
+	// The last byte is an empty string for the strings, that do not fit.
+	//
+	rec->str[LOG_STR_SIZE - 1] = '\0';
+
+	for (int i = 0; i < rec->num; i++) {
+
+		rec->arg[i] = arg[i];
+
+		if (arg[i].type != LOG_ARG_STR) {
+			continue;
+		}
+
+		if (used >= LOG_STR_SIZE - 1) {
+			rec->arg[i].i = LOG_STR_SIZE - 1;
+			continue;
+		}
+
+		const size_t len = strnlen(arg[i].s, LOG_STR_SIZE - 2 - used);
+
+		memcpy(&rec->str[used], arg[i].s, len);
+		rec->str[used + len] = '\0';
+
+		rec->arg[i].i = (long long) used;
+
+		used += len + 1;
+	}
+}
+
+/******************************************************************************
+ * The function appends a formatted value to a buffer. It returns the new
+ * length, which is less than the size of the buffer.
+ *****************************************************************************/
+
+static size_t log_append(char *buf, const size_t size, const size_t len, const char *fmt, ...) {
+	va_list argp;
+
+	va_start(argp, fmt);
+
+	const int result = vsnprintf(buf + len, size - len, fmt, argp);
+
+	va_end(argp);
+
+	if (result < 0) {
+		return len;
+	}
+
+	return len + (size_t) result >= size ? size - 1 : len + (size_t) result;
+}
+
+/******************************************************************************
+ * The function formats an argument with a conversion specification. The
+ * specification contains the length modifier of the call site, so the value
+ * is casted to the type of the argument of the call.
+ *****************************************************************************/
+
+static size_t log_format_arg(const s_log_rec *rec, const s_log_arg *arg, const char *spec, const char *mod, const char conv, char *buf, const size_t size, size_t len) {
+
+	const long long i = arg->type == LOG_ARG_DBL ? (long long) arg->d : arg->i;
+
+	const double d = arg->type == LOG_ARG_DBL ? arg->d : (double) arg->i;
+
+	switch (conv) {
+
+	case 'd':
+	case 'i':
+		if (strcmp(mod, "ll") == 0) {
+			return log_append(buf, size, len, spec, i);
+		} else if (strcmp(mod, "l") == 0 || strcmp(mod, "z") == 0 || strcmp(mod, "j") == 0 || strcmp(mod, "t") == 0) {
+			return log_append(buf, size, len, spec, (long ) i);
+		}
+		return log_append(buf, size, len, spec, (int ) i);
+
+	case 'u':
+	case 'x':
+	case 'X':
+	case 'o':
+		if (strcmp(mod, "ll") == 0) {
+			return log_append(buf, size, len, spec, (unsigned long long ) i);
+		} else if (strcmp(mod, "l") == 0 || strcmp(mod, "z") == 0 || strcmp(mod, "j") == 0 || strcmp(mod, "t") == 0) {
+			return log_append(buf, size, len, spec, (unsigned long ) i);
+		}
+		return log_append(buf, size, len, spec, (unsigned int ) i);
+
+	case 'c':
+		if (strcmp(mod, "l") == 0) {
+			return log_append(buf, size, len, spec, (wint_t ) i);
+		}
+		return log_append(buf, size, len, spec, (int ) i);
+
+	case 'f':
+	case 'F':
+	case 'e':
+	case 'E':
+	case 'g':
+	case 'G':
+	case 'a':
+	case 'A':
+		if (strcmp(mod, "L") == 0) {
+			return log_append(buf, size, len, spec, (long double ) d);
+		}
+		return log_append(buf, size, len, spec, d);
+
+	case 's':
+		if (arg->type == LOG_ARG_STR && mod[0] == '\0') {
+			return log_append(buf, size, len, spec, &rec->str[arg->i]);
+		}
+		return log_append(buf, size, len, "%s", "(null)");
+
+	case 'p':
+		return log_append(buf, size, len, spec, arg->type == LOG_ARG_PTR ? arg->p : NULL);
+
+	default:
+		return log_append(buf, size, len, "%s", spec);
+	}
+}
+
+/******************************************************************************
+ * The function formats a record to a line with the level, the call site, the
+ * message and a newline. The function returns the length of the line. If the
+ * buffer is too small, the line is cut.
+ *****************************************************************************/
+
+size_t log_rec_format(const s_log_rec *rec, char *buf, const size_t size) {
+	char spec[32];
+	char mod[3];
+	int idx = 0;
+
+	const s_log_site *site = rec->site;
+
+	size_t len = log_append(buf, size, 0, "%s %s:%d:%s() ", _level_str[site->level], site->file, site->line, site->func);
+
+	for (const char *ptr = site->fmt; *ptr != '\0' && len < size - 1;) {
+
+		if (*ptr != '%') {
+			buf[len++] = *ptr++;
+			continue;
+		}
+
+		if (ptr[1] == '%') {
+			buf[len++] = '%';
+			ptr += 2;
+			continue;
+		}
+
+		//
+		// Copy the flags, the width and the precision.
+		//
+		const char *start = ptr++;
+
+		ptr += strspn(ptr, "-+ #0");
+		ptr += strspn(ptr, "0123456789");
+
+		if (*ptr == '.') {
+			ptr++;
+			ptr += strspn(ptr, "0123456789");
+		}
+
+		const size_t mod_len = strspn(ptr, "hlzjtL");
+
+		if (mod_len > 2 || ptr[mod_len] == '\0' || (size_t) (ptr + mod_len - start) + 2 > sizeof(spec)) {
+			break;
+		}
+
+		memcpy(mod, ptr, mod_len);
+		mod[mod_len] = '\0';
+
+		ptr += mod_len;
+
+		const char conv = *ptr++;
+
+		memcpy(spec, start, ptr - start);
+		spec[ptr - start] = '\0';
+
+		if (idx >= rec->num) {
+			break;
+		}
+
+		len = log_format_arg(rec, &rec->arg[idx++], spec, mod, conv, buf, size, len);
+	}
+
+	if (len < size - 1) {
+		buf[len++] = '\n';
+	} else {
+		buf[size - 2] = '\n';
+		len = size - 1;
+	}
+
+	buf[len] = '\0';
+
+	return len;
+}
+
+/******************************************************************************
+ * The function creates the ring of the current thread and adds it to the
+ * list of rings. The function returns NULL, if the memory is not available.
+ *****************************************************************************/
+
+static s_log_ring* log_ring_new() {
+
+	s_log_ring *ring = calloc(1, sizeof(s_log_ring) + _ring_size * sizeof(s_log_rec));
+
+	if (ring == NULL) {
+		return NULL;
+	}
+
+	ring->next = atomic_load(&_rings);
+
+	while (!atomic_compare_exchange_weak(&_rings, &ring->next, ring)) {
+	}
+
+	return ring;
+}
+
+/******************************************************************************
+ * The function writes a record to the ring of the current thread. In the
+ * synchronous mode or if no ring is available, the record is formatted and
+ * written immediately.
+ *****************************************************************************/
+
+void log_record(const s_log_site *site, const int num, const s_log_arg *arg) {
+	s_log_rec rec;
+	char line[LOG_LINE_SIZE];
+
+	if (_ring == NULL && !atomic_load_explicit(&_sync, memory_order_relaxed)) {
+		_ring = log_ring_new();
+	}
+
+	if (_ring == NULL || atomic_load_explicit(&_sync, memory_order_relaxed)) {
+
+		log_rec_init(&rec, site, num, arg);
+
+		//
+		// A %lc conversion can write a null character, so the line is written
+		// with its length.
+		//
+		fwrite(line, 1, log_rec_format(&rec, line, LOG_LINE_SIZE), stderr);
+		return;
+	}
+
+	const unsigned long head = atomic_load_explicit(&_ring->head, memory_order_relaxed);
+
+	if (head - atomic_load_explicit(&_ring->tail, memory_order_acquire) >= _ring_size) {
+		atomic_fetch_add_explicit(&_ring->dropped, 1, memory_order_relaxed);
+		return;
+	}
+
+	log_rec_init(&_ring->rec[head % _ring_size], site, num, arg);
+
+	atomic_store_explicit(&_ring->head, head + 1, memory_order_release);
+}
+
+/******************************************************************************
+ * The function formats the records of all rings and writes them to stderr.
+ * The records of the different threads are merged by their time.
+ *****************************************************************************/
+
+void log_flush() {
+	size_t len = 0;
+
+	pthread_mutex_lock(&_mutex);
+
+	for (s_log_ring *ring = atomic_load(&_rings); ring != NULL; ring = ring->next) {
+
+		const long dropped = atomic_exchange(&ring->dropped, 0);
+
+		if (dropped > 0) {
+			len = log_append(_out, LOG_OUT_SIZE, len, "WARN Dropped log records: %ld\n", dropped);
+		}
+	}
+
+	for (;;) {
+		s_log_ring *next = NULL;
+		unsigned long next_tail = 0;
+
+		for (s_log_ring *ring = atomic_load(&_rings); ring != NULL; ring = ring->next) {
+
+			const unsigned long tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+			if (tail == atomic_load_explicit(&ring->head, memory_order_acquire)) {
+				continue;
+			}
+
+			if (next == NULL || ring->rec[tail % _ring_size].time < next->rec[next_tail % _ring_size].time) {
+				next = ring;
+				next_tail = tail;
+			}
+		}
+
+		if (next == NULL) {
+			break;
+		}
+
+		if (len + LOG_LINE_SIZE > LOG_OUT_SIZE) {
+			fwrite(_out, 1, len, stderr);
+			len = 0;
+		}
+
+		len += log_rec_format(&next->rec[next_tail % _ring_size], &_out[len], LOG_LINE_SIZE);
+
+		atomic_store_explicit(&next->tail, next_tail + 1, memory_order_release);
+	}
+
+	if (len > 0) {
+		fwrite(_out, 1, len, stderr);
+		fflush(stderr);
+	}
+
+	pthread_mutex_unlock(&_mutex);
+}
+
+/******************************************************************************
+ * The function is the background thread, which flushes the records until it
+ * is stopped.
+ *****************************************************************************/
+
+static void* log_worker(void *arg) {
+	(void) arg;
+
+	const struct timespec ts = { .tv_sec = 0, .tv_nsec = LOG_FLUSH_MS * 1000000L };
+
+	while (!atomic_load(&_stop)) {
+
+		nanosleep(&ts, NULL);
+
+		log_flush();
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ * The function checks if a module has a name. The name of a module is the
+ * name of the source file without the directory and the extension.
+ *****************************************************************************/
+
+static bool log_module_is(const s_log_module *module, const char *name) {
+
+	const char *base = strrchr(module->file, '/');
+
+	base = base == NULL ? module->file : base + 1;
+
+	const size_t len = strcspn(base, ".");
+
+	return strlen(name) == len && strncmp(base, name, len) == 0;
+}
+
+/******************************************************************************
+ * The function sets the mask of a module from its configured level or from
+ * the minimum level. It is called with the mutex locked.
+ *****************************************************************************/
+
+static void log_module_update(s_log_module *module) {
+
+	for (int i = 0; i < _module_cfg_num; i++) {
+
+		if (log_module_is(module, _module_cfg[i].name)) {
+			module->own = true;
+			atomic_store(&module->mask, log_mask(_module_cfg[i].level));
+			return;
+		}
+	}
+
+	module->own = false;
+	atomic_store(&module->mask, log_mask(_level));
+}
+
+/******************************************************************************
+ * The function is called with the first log call of a module. It resolves
+ * the mask of the module and adds the module to the list. The function
+ * returns 1 if the level is enabled for the module.
+ *****************************************************************************/
+
+int log_module_init(s_log_module *module, const int level) {
+
+	pthread_mutex_lock(&_module_mutex);
+
+	if (atomic_load(&module->mask) == LOG_MASK_UNRESOLVED) {
+
+		log_module_update(module);
+
+		module->next = _modules;
+		_modules = module;
+	}
+
+	pthread_mutex_unlock(&_module_mutex);
+
+	return (atomic_load(&module->mask) >> level) & 1;
+}
+
+/******************************************************************************
+ * The function sets the minimum level of the records. It is used by the
+ * modules without a configured level.
+ *****************************************************************************/
+
+void log_set_level(const int level) {
+
+	pthread_mutex_lock(&_module_mutex);
+
+	_level = level;
+
+	for (s_log_module *module = _modules; module != NULL; module = module->next) {
+
+		if (!module->own) {
+			atomic_store(&module->mask, log_mask(_level));
+		}
+	}
+
+	pthread_mutex_unlock(&_module_mutex);
+}
+
+/******************************************************************************
+ * The function sets the level of a module. If too many modules are
+ * configured, the level is ignored.
+ *****************************************************************************/
+
+void log_set_module(const char *name, const int level) {
+	int idx;
+
+	pthread_mutex_lock(&_module_mutex);
+
+	for (idx = 0; idx < _module_cfg_num; idx++) {
+
+		if (strcmp(_module_cfg[idx].name, name) == 0) {
+			break;
+		}
+	}
+
+	if (idx < LOG_MODULES_MAX) {
+
+		snprintf(_module_cfg[idx].name, LOG_MODULE_NAME_SIZE, "%s", name);
+
+		_module_cfg[idx].level = level;
+
+		if (idx == _module_cfg_num) {
+			_module_cfg_num++;
+		}
+
+		for (s_log_module *module = _modules; module != NULL; module = module->next) {
+			log_module_update(module);
+		}
+	}
+
+	pthread_mutex_unlock(&_module_mutex);
+}
+
+/******************************************************************************
+ * The function returns the level for a name from the environment. An
+ * unknown name is an error.
+ *****************************************************************************/
+
+static int log_level_parse(const char *name) {
+
+	for (int i = LOG_LEVEL_TRACE; i <= LOG_LEVEL_OFF; i++) {
+
+		if (strcmp(name, _level_env[i]) == 0) {
+			return i;
+		}
+	}
+
+	log_exit("Unknown log level: %s", name);
+}
+
+/******************************************************************************
+ * The function sets the levels of the modules from a list of the form:
+ * "name=level,name=level".
+ *****************************************************************************/
+
+static void log_modules_parse(const char *modules) {
+	char buf[LOG_MODULES_MAX * LOG_MODULE_NAME_SIZE];
+	char *save;
+
+	snprintf(buf, sizeof(buf), "%s", modules);
+
+	for (char *token = strtok_r(buf, ",", &save); token != NULL; token = strtok_r(NULL, ",", &save)) {
+
+		char *level = strchr(token, '=');
+
+		if (level == NULL) {
+			log_exit("Missing log level: %s", token);
+		}
+
+		*level++ = '\0';
+
+		log_set_module(token, log_level_parse(level));
+	}
+}
+
+/******************************************************************************
+ * The function returns the number of records of a ring from the environment.
+ * A value, that is not a number or is out of range, is an error.
+ *****************************************************************************/
+
+static unsigned long log_ring_size_parse(const char *value) {
+	char *end;
+
+	const long size = strtol(value, &end, 10);
+
+	if (*value == '\0' || *end != '\0' || size <= 0 || size > LOG_RING_MAX) {
+		log_exit("Invalid log ring size: %s (max: %d)", value, LOG_RING_MAX);
+	}
+
+	return (unsigned long) size;
+}
+
+/******************************************************************************
+ * The function reads the configuration from the environment and starts the
+ * background thread. The remaining records are flushed at exit. The
+ * function has to be called before log_atexit(), so the records of the exit
+ * callback are flushed.
+ *****************************************************************************/
+
+void log_init() {
+
+	const char *level = getenv("BAGA_LOG_LEVEL");
+
+	if (level != NULL) {
+		log_set_level(log_level_parse(level));
+	}
+
+	const char *modules = getenv("BAGA_LOG_MODULES");
+
+	if (modules != NULL) {
+		log_modules_parse(modules);
+	}
+
+	const char *ring = getenv("BAGA_LOG_RING");
+
+	if (ring != NULL) {
+		_ring_size = log_ring_size_parse(ring);
+	}
+
+	const char *sync = getenv("BAGA_LOG_SYNC");
+
+	atomic_store(&_sync, sync != NULL && strcmp(sync, "1") == 0);
+
+	if (atexit(log_free) != 0) {
+		log_exit_str("Unable to register exit function!");
+	}
+
+	if (atomic_load(&_sync)) {
+		return;
+	}
+
+	atomic_store(&_stop, false);
+
+	const int result = pthread_create(&_thread, NULL, log_worker, NULL);
+
+	if (result != 0) {
+		log_exit("Unable to create thread: %s", strerror(result));
+	}
+
+	_running = true;
+}
+
+/******************************************************************************
+ * The function stops the background thread and flushes the records. The
+ * records, that are written afterwards, are written immediately.
+ *****************************************************************************/
+
+void log_free() {
+
+	if (_running) {
+
+		atomic_store(&_stop, true);
+
+		pthread_join(_thread, NULL);
+
+		_running = false;
+	}
+
+	atomic_store(&_sync, true);
+
+	log_flush();
+}
+
 /******************************************************************************
  * Error handling with ncurses has special challenges. If ncurses is active
  * printing to stdout or stderr is not visible. To do a proper error handling
@@ -101,6 +825,11 @@ void log_fatal(FILE *stream, const char *fmt, ...) {
 	//
 	log_atexit_wrapper();
 
+	//
+	// Write the records before the error message.
+	//
+	log_flush();
+
 	//
 	// Print the error message.
 	//
@@ -0,0 +1,198 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+
+#include "lib_logging.h"
+#include "lib_time.h"
+#include "lib_perf.h"
+
+/******************************************************************************
+ * The list of the counters of all threads. A struct is added with the first
+ * counter of a thread and lives until the end of the program, because the
+ * totals include the finished threads.
+ *****************************************************************************/
+
+static _Atomic(s_pf_thread *) _threads = NULL;
+
+_Thread_local s_pf_thread *_pf_thread = NULL;
+
+//
+// The flag is set by a signal handler, so it has to be lock free.
+//
+static atomic_bool _dump = false;
+
+/******************************************************************************
+ * The function creates the counters of the current thread and adds them to
+ * the list.
+ *****************************************************************************/
+
+s_pf_thread* pf_thread_new() {
+
+	s_pf_thread *thread = calloc(1, sizeof(s_pf_thread));
+
+	if (thread == NULL) {
+		log_exit_str("Unable to allocate memory!");
+	}
+
+	thread->next = atomic_load(&_threads);
+
+	while (!atomic_compare_exchange_weak(&_threads, &thread->next, thread)) {
+	}
+
+	_pf_thread = thread;
+
+	return thread;
+}
+
+/******************************************************************************
+ * The function starts a scoped timer.
+ *****************************************************************************/
+
+s_pf_scope pf_scope_start(const e_pf_id id) {
+	return (s_pf_scope ) { .id = id, .start = lt_now_ns() };
+}
+
+/******************************************************************************
+ * The function is called at the end of the scope. It adds the call and the
+ * time to the counter of the current thread.
+ *****************************************************************************/
+
+void pf_scope_end(const s_pf_scope *scope) {
+
+	const long ns = lt_now_ns() - scope->start;
+
+	s_pf_thread *thread = pf_thread();
+
+	pf_add(thread->count[scope->id], 1);
+
+	pf_add(thread->ns[scope->id], ns);
+}
+
+/******************************************************************************
+ * The function returns a string representation of the counter id.
+ *****************************************************************************/
+
+const char* e_pf_id_str(const e_pf_id id) {
+
+	switch (id) {
+
+	case PF_RULES_CAN_MV:
+		return "rules_can_mv";
+
+	case PF_RULES_UPDATE_PHASE:
+		return "rules_update_phase";
+
+	case PF_CANVAS_PRINT:
+		return "canvas_print";
+
+	case PF_COLOR_PAIR_GET:
+		return "color_pair_get";
+
+	case PF_FRAME_FLUSH:
+		return "frame_flush";
+
+	case PF_ANIM_RENDER:
+		return "anim_render";
+
+	case PF_CONTROLS_PRINT:
+		return "controls_print";
+
+	case PF_CANVAS_CELLS:
+		return "canvas_cells";
+
+	case PF_TERM_BYTES:
+		return "term_bytes";
+
+	case PF_ENG_NODES:
+		return "eng_nodes";
+
+	case PF_ENG_CACHE_HITS:
+		return "eng_cache_hits";
+
+	default:
+		log_exit("Unknown id: %d", id)
+		;
+	}
+}
+
+/******************************************************************************
+ * The function computes the totals over all threads. The values are read
+ * without a lock, so the totals of a running program are snapshots.
+ *****************************************************************************/
+
+void pf_stats(s_pf_stats *stats) {
+
+	*stats = (s_pf_stats ) { 0 };
+
+	for (s_pf_thread *thread = atomic_load(&_threads); thread != NULL; thread = thread->next) {
+
+		for (int id = 0; id < PF_NUM; id++) {
+			stats->count[id] += atomic_load_explicit(&thread->count[id], memory_order_relaxed);
+			stats->ns[id] += atomic_load_explicit(&thread->ns[id], memory_order_relaxed);
+		}
+	}
+}
+
+/******************************************************************************
+ * The function requests a dump of the counters. It is async-signal-safe and
+ * can be called from a signal handler.
+ *****************************************************************************/
+
+void pf_request_dump() {
+	atomic_store(&_dump, true);
+}
+
+/******************************************************************************
+ * The function returns and resets the request for a dump.
+ *****************************************************************************/
+
+bool pf_is_dump_requested() {
+	return atomic_exchange(&_dump, false);
+}
+
+/******************************************************************************
+ * The function logs the totals of the counters. Counters without a timer
+ * have no time and their count is not necessarily a number of calls.
+ *****************************************************************************/
+
+void pf_log_stats() {
+	s_pf_stats stats;
+
+	pf_stats(&stats);
+
+	for (int id = 0; id < PF_NUM; id++) {
+
+		if (stats.count[id] == 0) {
+			continue;
+		}
+
+		if (stats.ns[id] == 0) {
+			log_info("%-18s count: %ld", e_pf_id_str(id), stats.count[id]);
+			continue;
+		}
+
+		log_info("%-18s calls: %ld total: %.3f ms avg: %.3f us", e_pf_id_str(id), stats.count[id], stats.ns[id] / 1e6, stats.ns[id] / 1e3 / stats.count[id]);
+	}
+}
@@ -0,0 +1,603 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/******************************************************************************
+ * The source file implements the work-stealing thread pool. The deques of
+ * the workers follow: "Correct and Efficient Work-Stealing for Weak Memory
+ * Models" (Lê, Pop, Cohen, Zappa Nardelli). The deques have a fixed size. If
+ * the deque of a worker is full, the task is queued in the shared queue.
+ *
+ * Idle workers sleep on a condition, which is signaled if a task is queued.
+ * A worker, that waits for a group, executes other tasks in the meantime, so
+ * nested groups do not block the workers. A thread, that is not a worker,
+ * sleeps until the group is done.
+ *****************************************************************************/
+
+//
+// The flag is necessary for pthread_setaffinity_np().
+//
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "lib_logging.h"
+#include "lib_string.h"
+#include "lib_pool.h"
+
+/******************************************************************************
+ * The worker with its deque. The top is modified by the thieves, the bottom
+ * only by the owner, so both are on their own cache line.
+ *****************************************************************************/
+
+typedef struct {
+
+	pthread_t thread;
+
+	_Alignas(64) atomic_long top;
+
+	_Alignas(64) atomic_long bottom;
+
+	_Atomic(s_tp_task *) buf[TP_DEQUE_SIZE];
+
+	//
+	// The statistics, which are written by the worker.
+	//
+	atomic_long tasks;
+
+	atomic_long steals;
+
+	atomic_long depth_max;
+
+	//
+	// The next victim of the worker.
+	//
+	int victim;
+
+} s_tp_worker;
+
+static s_tp_worker _workers[TP_WORKERS_MAX];
+
+static int _workers_num = 0;
+
+static bool _pin = false;
+
+//
+// The index of the worker of the current thread (-1 if the thread is not a
+// worker).
+//
+static _Thread_local int _worker_idx = -1;
+
+/******************************************************************************
+ * The mutex protects the shared queue and the shutdown flag. The work
+ * condition is signaled if a task is queued, the done condition if a group
+ * is done. The number of queued tasks is the sum of the tasks in the deques
+ * and the shared queue.
+ *****************************************************************************/
+
+static pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_cond_t _work_cond = PTHREAD_COND_INITIALIZER;
+
+static pthread_cond_t _done_cond = PTHREAD_COND_INITIALIZER;
+
+static s_tp_task *_queue_head = NULL;
+
+static s_tp_task *_queue_tail = NULL;
+
+static bool _shutdown = false;
+
+static atomic_int _queued = 0;
+
+//
+// The number of tasks, that were queued in the shared queue.
+//
+static long _stat_shared = 0;
+
+/******************************************************************************
+ * The function pushes a task to the bottom of the deque. It is only called by
+ * the owner. The function returns false if the deque is full.
+ *****************************************************************************/
+
+static bool tp_push(s_tp_worker *worker, s_tp_task *task) {
+
+	const long bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed);
+	const long top = atomic_load_explicit(&worker->top, memory_order_acquire);
+
+	if (bottom - top >= TP_DEQUE_SIZE) {
+		return false;
+	}
+
+	atomic_store_explicit(&worker->buf[bottom % TP_DEQUE_SIZE], task, memory_order_relaxed);
+
+	atomic_thread_fence(memory_order_release);
+
+	atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+
+	if (bottom + 1 - top > atomic_load_explicit(&worker->depth_max, memory_order_relaxed)) {
+		atomic_store_explicit(&worker->depth_max, bottom + 1 - top, memory_order_relaxed);
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * The function takes a task from the bottom of the deque. It is only called
+ * by the owner. The function returns NULL if the deque is empty.
+ *****************************************************************************/
+
+static s_tp_task* tp_take(s_tp_worker *worker) {
+	s_tp_task *task = NULL;
+
+	const long bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed) - 1;
+
+	atomic_store_explicit(&worker->bottom, bottom, memory_order_relaxed);
+
+	atomic_thread_fence(memory_order_seq_cst);
+
+	long top = atomic_load_explicit(&worker->top, memory_order_relaxed);
+
+	if (top <= bottom) {
+
+		task = atomic_load_explicit(&worker->buf[bottom % TP_DEQUE_SIZE], memory_order_relaxed);
+
+		//
+		// The last task: the owner races with the thieves.
+		//
+		if (top == bottom) {
+
+			if (!atomic_compare_exchange_strong_explicit(&worker->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+				task = NULL;
+			}
+
+			atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+		}
+
+	} else {
+		atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+	}
+
+	return task;
+}
+
+/******************************************************************************
+ * The function steals a task from the top of the deque of an other worker.
+ * The function returns NULL if the deque is empty or an other thread was
+ * faster. In the second case the retry flag is set.
+ *****************************************************************************/
+
+static s_tp_task* tp_steal(s_tp_worker *worker, bool *retry) {
+
+	long top = atomic_load_explicit(&worker->top, memory_order_acquire);
+
+	atomic_thread_fence(memory_order_seq_cst);
+
+	const long bottom = atomic_load_explicit(&worker->bottom, memory_order_acquire);
+
+	if (top >= bottom) {
+		return NULL;
+	}
+
+	s_tp_task *task = atomic_load_explicit(&worker->buf[top % TP_DEQUE_SIZE], memory_order_relaxed);
+
+	if (!atomic_compare_exchange_strong_explicit(&worker->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+		*retry = true;
+		return NULL;
+	}
+
+	return task;
+}
+
+/******************************************************************************
+ * The function removes the first task from the shared queue. The function
+ * returns NULL if the queue is empty.
+ *****************************************************************************/
+
+static s_tp_task* tp_queue_pop() {
+
+	pthread_mutex_lock(&_mutex);
+
+	s_tp_task *task = _queue_head;
+
+	if (task != NULL) {
+
+		_queue_head = task->next;
+
+		if (_queue_head == NULL) {
+			_queue_tail = NULL;
+		}
+	}
+
+	pthread_mutex_unlock(&_mutex);
+
+	return task;
+}
+
+/******************************************************************************
+ * The function looks for a task for a worker: first the deque of the worker,
+ * then the shared queue and then the deques of the other workers. The
+ * function returns NULL if no task was found.
+ *****************************************************************************/
+
+static s_tp_task* tp_find(const int idx) {
+	s_tp_worker *worker = &_workers[idx];
+	s_tp_task *task;
+	bool retry;
+
+	if ((task = tp_take(worker)) != NULL || (task = tp_queue_pop()) != NULL) {
+		atomic_fetch_sub(&_queued, 1);
+		return task;
+	}
+
+	do {
+		retry = false;
+
+		for (int i = 0; i < _workers_num - 1; i++) {
+
+			worker->victim = (worker->victim + 1) % _workers_num;
+
+			if (worker->victim == idx) {
+				worker->victim = (worker->victim + 1) % _workers_num;
+			}
+
+			if ((task = tp_steal(&_workers[worker->victim], &retry)) != NULL) {
+
+				atomic_fetch_sub(&_queued, 1);
+
+				atomic_fetch_add_explicit(&worker->steals, 1, memory_order_relaxed);
+
+				return task;
+			}
+		}
+
+	} while (retry);
+
+	return NULL;
+}
+
+/******************************************************************************
+ * The function executes a task and signals the waiting threads, if the group
+ * is done. The group cannot be used after the last task is finished, because
+ * the waiting thread may release it.
+ *****************************************************************************/
+
+static void tp_run(const int idx, s_tp_task *task) {
+
+	task->fct(task->arg);
+
+	if (idx >= 0) {
+		atomic_fetch_add_explicit(&_workers[idx].tasks, 1, memory_order_relaxed);
+	}
+
+	if (atomic_fetch_sub(&task->group->pending, 1) == 1) {
+
+		pthread_mutex_lock(&_mutex);
+
+		pthread_cond_broadcast(&_done_cond);
+
+		pthread_mutex_unlock(&_mutex);
+	}
+}
+
+/******************************************************************************
+ * The function pins the worker to a core. The first core is left for the ui
+ * thread. An error is not fatal, the worker runs unpinned.
+ *****************************************************************************/
+
+static void tp_pin(const int idx) {
+	cpu_set_t set;
+
+	const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (cores < 2) {
+		return;
+	}
+
+	CPU_ZERO(&set);
+	CPU_SET((idx + 1) % cores, &set);
+
+	const int result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+
+	if (result != 0) {
+		log_warn("Unable to pin worker: %d - %s", idx, strerror(result));
+	}
+}
+
+/******************************************************************************
+ * The function is the main loop of a worker. It executes tasks until the
+ * pool is shut down.
+ *****************************************************************************/
+
+static void* tp_worker(void *arg) {
+	s_tp_task *task;
+
+	_worker_idx = (int) (intptr_t) arg;
+
+	if (_pin) {
+		tp_pin(_worker_idx);
+	}
+
+	for (;;) {
+
+		if ((task = tp_find(_worker_idx)) != NULL) {
+			tp_run(_worker_idx, task);
+			continue;
+		}
+
+		pthread_mutex_lock(&_mutex);
+
+		while (!_shutdown && atomic_load(&_queued) <= 0) {
+			pthread_cond_wait(&_work_cond, &_mutex);
+		}
+
+		const bool stop = _shutdown && atomic_load(&_queued) <= 0;
+
+		pthread_mutex_unlock(&_mutex);
+
+		if (stop) {
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ * The function starts the workers. If the pin flag is set, each worker is
+ * pinned to a core.
+ *****************************************************************************/
+
+void tp_init(const int workers, const bool pin) {
+
+	if (workers < 1 || workers > TP_WORKERS_MAX) {
+		log_exit("Invalid number of workers: %d", workers);
+	}
+
+	_pin = pin;
+	_shutdown = false;
+
+	for (int i = 0; i < workers; i++) {
+
+		s_tp_worker *worker = &_workers[i];
+
+		atomic_store(&worker->top, 0);
+		atomic_store(&worker->bottom, 0);
+		atomic_store(&worker->tasks, 0);
+		atomic_store(&worker->steals, 0);
+		atomic_store(&worker->depth_max, 0);
+
+		worker->victim = i;
+	}
+
+	//
+	// The number is set before the workers start, because they steal from
+	// each other.
+	//
+	_workers_num = workers;
+
+	for (int i = 0; i < workers; i++) {
+
+		const int result = pthread_create(&_workers[i].thread, NULL, tp_worker, (void*) (intptr_t) i);
+
+		if (result != 0) {
+			log_exit("Unable to create thread: %s", strerror(result));
+		}
+	}
+
+	log_info("Workers: %d pinned: %s", workers, ls_bool_str(pin));
+}
+
+/******************************************************************************
+ * The function stops the workers, after the queued tasks are done. It is
+ * called with the exit callback, which can be called from a worker with
+ * log_exit(). In this case the threads cannot be joined.
+ *****************************************************************************/
+
+void tp_free() {
+
+	if (_worker_idx >= 0 || _workers_num == 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&_mutex);
+
+	_shutdown = true;
+
+	pthread_cond_broadcast(&_work_cond);
+
+	pthread_mutex_unlock(&_mutex);
+
+	for (int i = 0; i < _workers_num; i++) {
+		pthread_join(_workers[i].thread, NULL);
+	}
+
+	_workers_num = 0;
+}
+
+/******************************************************************************
+ * The function returns the number of workers.
+ *****************************************************************************/
+
+int tp_workers() {
+	return _workers_num;
+}
+
+/******************************************************************************
+ * The function checks if the current thread is a worker.
+ *****************************************************************************/
+
+bool tp_is_worker() {
+	return _worker_idx >= 0;
+}
+
+/******************************************************************************
+ * The function initializes a group without tasks.
+ *****************************************************************************/
+
+void tp_group_init(s_tp_group *group) {
+
+	atomic_store(&group->pending, 0);
+
+	atomic_store(&group->cancel, false);
+}
+
+/******************************************************************************
+ * The function spawns a task in a group. On a worker, the task is pushed to
+ * its deque, otherwise it is queued in the shared queue. Without workers, the
+ * task is executed immediately.
+ *****************************************************************************/
+
+void tp_spawn(s_tp_group *group, s_tp_task *task, void (*fct)(void *arg), void *arg) {
+
+	task->fct = fct;
+	task->arg = arg;
+	task->group = group;
+	task->next = NULL;
+
+	atomic_fetch_add(&group->pending, 1);
+
+	if (_workers_num == 0) {
+		tp_run(-1, task);
+		return;
+	}
+
+	const bool pushed = _worker_idx >= 0 && tp_push(&_workers[_worker_idx], task);
+
+	pthread_mutex_lock(&_mutex);
+
+	if (!pushed) {
+
+		if (_queue_tail == NULL) {
+			_queue_head = task;
+		} else {
+			_queue_tail->next = task;
+		}
+
+		_queue_tail = task;
+
+		_stat_shared++;
+	}
+
+	atomic_fetch_add(&_queued, 1);
+
+	pthread_cond_signal(&_work_cond);
+
+	pthread_mutex_unlock(&_mutex);
+}
+
+/******************************************************************************
+ * The function sets the cancel flag of the group. The tasks stop at their
+ * next check of the flag.
+ *****************************************************************************/
+
+void tp_group_cancel(s_tp_group *group) {
+
+	atomic_store(&group->cancel, true);
+}
+
+/******************************************************************************
+ * The function checks the cancel flag of the group.
+ *****************************************************************************/
+
+bool tp_group_is_cancelled(s_tp_group *group) {
+
+	return atomic_load(&group->cancel);
+}
+
+/******************************************************************************
+ * The function checks if all tasks of the group are done.
+ *****************************************************************************/
+
+bool tp_group_is_done(s_tp_group *group) {
+
+	return atomic_load(&group->pending) == 0;
+}
+
+/******************************************************************************
+ * The function waits until all tasks of the group are done. A worker
+ * executes other tasks while it waits.
+ *****************************************************************************/
+
+void tp_group_wait(s_tp_group *group) {
+	s_tp_task *task;
+
+	if (_worker_idx >= 0) {
+
+		while (atomic_load(&group->pending) > 0) {
+
+			if ((task = tp_find(_worker_idx)) != NULL) {
+				tp_run(_worker_idx, task);
+			} else {
+				sched_yield();
+			}
+		}
+
+		return;
+	}
+
+	pthread_mutex_lock(&_mutex);
+
+	while (atomic_load(&group->pending) > 0) {
+		pthread_cond_wait(&_done_cond, &_mutex);
+	}
+
+	pthread_mutex_unlock(&_mutex);
+}
+
+/******************************************************************************
+ * The function copies the statistics of a worker. The values are read while
+ * the worker is running, so they are a snapshot.
+ *****************************************************************************/
+
+void tp_stats(const int idx, s_tp_stats *stats) {
+
+	s_tp_worker *worker = &_workers[idx];
+
+	const long depth = atomic_load_explicit(&worker->bottom, memory_order_relaxed) - atomic_load_explicit(&worker->top, memory_order_relaxed);
+
+	stats->tasks = atomic_load_explicit(&worker->tasks, memory_order_relaxed);
+	stats->steals = atomic_load_explicit(&worker->steals, memory_order_relaxed);
+	stats->depth = depth > 0 ? depth : 0;
+	stats->depth_max = atomic_load_explicit(&worker->depth_max, memory_order_relaxed);
+}
+
+/******************************************************************************
+ * The function logs the statistics of the workers.
+ *****************************************************************************/
+
+void tp_log_stats() {
+	s_tp_stats stats;
+
+	for (int i = 0; i < _workers_num; i++) {
+
+		tp_stats(i, &stats);
+
+		log_debug("worker: %d tasks: %ld steals: %ld depth max: %ld", i, stats.tasks, stats.steals, stats.depth_max);
+	}
+
+	log_debug("shared queue: %ld", _stat_shared);
+}
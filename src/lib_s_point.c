@@ -33,7 +33,7 @@ int s_point_dist(const s_point from, const s_point to) {
 
 	const int result = abs(from.row - to.row) + abs(from.col - to.col);
 
-	log_debug("from: %d/%d to: %d/%d result: %d", from.row, from.col, to.row, to.col, result);
+	log_trace("from: %d/%d to: %d/%d result: %d", from.row, from.col, to.row, to.col, result);
 
 	return result;
 }
@@ -0,0 +1,75 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <time.h>
+
+#include "lib_logging.h"
+#include "lib_time.h"
+
+/******************************************************************************
+ * The function returns the current time of the monotonic clock in
+ * milliseconds. The starting point of the clock is not defined, so the value
+ * can only be used to compute time differences.
+ *****************************************************************************/
+
+long lt_now_ms() {
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+		log_exit_str("Unable to get the time!");
+	}
+
+	return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
+}
+
+/******************************************************************************
+ * The function returns the current time of the monotonic clock in
+ * microseconds.
+ *****************************************************************************/
+
+long lt_now_us() {
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+		log_exit_str("Unable to get the time!");
+	}
+
+	return ts.tv_sec * 1000000L + ts.tv_nsec / 1000L;
+}
+
+/******************************************************************************
+ * The function returns the current time of the monotonic clock in
+ * nanoseconds. It is used to measure short durations.
+ *****************************************************************************/
+
+long lt_now_ns() {
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+		log_exit_str("Unable to get the time!");
+	}
+
+	return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
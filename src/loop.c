@@ -0,0 +1,206 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/******************************************************************************
+ * The source file implements the event loop. It waits with poll() for three
+ * file descriptors:
+ *
+ * stdin:   the terminal input, which is read by curses.
+ * timerfd: the timer for the next animation frame or redraw.
+ * eventfd: a counter, that background workers increment, if a result is
+ *          available. It is the only function that can be called from other
+ *          threads.
+ *
+ * So the main loop does not busy wait and wakes up exactly when something
+ * has to be done.
+ *****************************************************************************/
+
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include "lib_logging.h"
+#include "loop.h"
+
+/******************************************************************************
+ * The indices of the file descriptors in the poll array.
+ *****************************************************************************/
+
+#define LOOP_IDX_INPUT  0
+
+#define LOOP_IDX_TIMER  1
+
+#define LOOP_IDX_WORKER 2
+
+#define LOOP_FDS_NUM    3
+
+static struct pollfd _fds[LOOP_FDS_NUM];
+
+//
+// The statistics: the number of wake ups for each source.
+//
+static long _stat_waits = 0;
+
+static long _stat_inputs = 0;
+
+static long _stat_timers = 0;
+
+static long _stat_workers = 0;
+
+/******************************************************************************
+ * The function creates the timer and the worker file descriptors.
+ *****************************************************************************/
+
+void loop_init() {
+
+	const int fd_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (fd_timer < 0) {
+		log_exit_str("Unable to create timer!");
+	}
+
+	const int fd_worker = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (fd_worker < 0) {
+		log_exit_str("Unable to create eventfd!");
+	}
+
+	_fds[LOOP_IDX_INPUT] = (struct pollfd ) { .fd = STDIN_FILENO, .events = POLLIN };
+	_fds[LOOP_IDX_TIMER] = (struct pollfd ) { .fd = fd_timer, .events = POLLIN };
+	_fds[LOOP_IDX_WORKER] = (struct pollfd ) { .fd = fd_worker, .events = POLLIN };
+}
+
+/******************************************************************************
+ * The function closes the file descriptors.
+ *****************************************************************************/
+
+void loop_free() {
+
+	for (int i = LOOP_IDX_TIMER; i < LOOP_FDS_NUM; i++) {
+
+		if (_fds[i].fd > 0) {
+			close(_fds[i].fd);
+			_fds[i].fd = -1;
+		}
+	}
+}
+
+/******************************************************************************
+ * The function sets the timer, which expires after a number of milliseconds.
+ * A negative value disarms the timer.
+ *****************************************************************************/
+
+void loop_set_timer(const int timeout_ms) {
+	struct itimerspec spec = { 0 };
+
+	//
+	// A zero value disarms the timer, so an expired time is set to 1ns.
+	//
+	if (timeout_ms >= 0) {
+		spec.it_value.tv_sec = timeout_ms / 1000;
+		spec.it_value.tv_nsec = (timeout_ms % 1000) * 1000000L + 1;
+	}
+
+	if (timerfd_settime(_fds[LOOP_IDX_TIMER].fd, 0, &spec, NULL) != 0) {
+		log_exit_str("Unable to set timer!");
+	}
+}
+
+/******************************************************************************
+ * The function reads a counter from a file descriptor, which resets the
+ * timerfd or the eventfd.
+ *****************************************************************************/
+
+static void loop_read_counter(const int fd) {
+	uint64_t counter;
+
+	if (read(fd, &counter, sizeof(counter)) < 0 && errno != EAGAIN) {
+		log_exit_str("Unable to read counter!");
+	}
+}
+
+/******************************************************************************
+ * The function waits until one of the sources is ready and returns a bit
+ * mask with the ready sources. An interrupt (for example SIGWINCH on resize)
+ * is reported as input, so curses can process it.
+ *****************************************************************************/
+
+int loop_wait() {
+	int ready = 0;
+
+	_stat_waits++;
+
+	if (poll(_fds, LOOP_FDS_NUM, -1) < 0) {
+
+		if (errno != EINTR) {
+			log_exit_str("Unable to poll!");
+		}
+
+		_stat_inputs++;
+		return LOOP_INPUT;
+	}
+
+	if (_fds[LOOP_IDX_INPUT].revents & (POLLIN | POLLHUP | POLLERR)) {
+		_stat_inputs++;
+		ready |= LOOP_INPUT;
+	}
+
+	if (_fds[LOOP_IDX_TIMER].revents & POLLIN) {
+		loop_read_counter(_fds[LOOP_IDX_TIMER].fd);
+		_stat_timers++;
+		ready |= LOOP_TIMER;
+	}
+
+	if (_fds[LOOP_IDX_WORKER].revents & POLLIN) {
+		loop_read_counter(_fds[LOOP_IDX_WORKER].fd);
+		_stat_workers++;
+		ready |= LOOP_WORKER;
+	}
+
+	return ready;
+}
+
+/******************************************************************************
+ * The function wakes up the loop. It is called from worker threads, if a
+ * result is available.
+ *****************************************************************************/
+
+void loop_wake() {
+	const uint64_t one = 1;
+
+	if (write(_fds[LOOP_IDX_WORKER].fd, &one, sizeof(one)) < 0) {
+		log_exit_str("Unable to wake up the loop!");
+	}
+}
+
+/******************************************************************************
+ * The function logs the statistics of the loop.
+ *****************************************************************************/
+
+void loop_log_stats() {
+
+	log_debug("waits: %ld input: %ld timer: %ld worker: %ld", _stat_waits, _stat_inputs, _stat_timers, _stat_workers);
+}
@@ -24,9 +24,10 @@
 
 #include "s_fieldset.h"
 #include "lib_logging.h"
+#include "lib_perf.h"
 #include "lib_utils.h"
 #include "lib_curses.h"
-#include "s_color_def.h"
+#include "s_theme.h"
 #include "s_area.h"
 #include "s_tmpl_points.h"
 #include "s_tmpl_checker.h"
@@ -36,17 +37,26 @@
 #include "s_board.h"
 #include "e_owner.h"
 #include "rules.h"
+#include "anim.h"
+#include "hover.h"
+#include "hint.h"
 
 // todo: comment, file, ...
 
 #define TRAVEL_ROW POINTS_ROW + 2
 
 /******************************************************************************
- * The s_board struct with the foreground and background arrays and the window.
+ * The s_board struct with the foreground and background arrays and the canvas.
  *****************************************************************************/
 
 static s_board _board;
 
+/******************************************************************************
+ * The callback function that renders the frames of the animation.
+ *****************************************************************************/
+
+static void nc_board_anim_render(const s_anim_job *job, const int idx);
+
 /******************************************************************************
  * The function initializes the background of the board.
  *****************************************************************************/
@@ -58,7 +68,7 @@ static void nc_board_init_bg(const s_game_cfg *game_cfg, s_tarr *board_bg, const
 	//
 	short color_bar_bg[board_areas->board_dim.row];
 
-	s_color_def_gradient(color_bar_bg, board_areas->board_dim.row, game_cfg->clr_board_start, game_cfg->clr_board_end);
+	s_theme_gradient(color_bar_bg, board_areas->board_dim.row, game_cfg->clr_board_start, game_cfg->clr_board_end);
 
 	s_tarr_set_gradient(board_bg, EMPTY, 0, color_bar_bg);
 
@@ -73,7 +83,7 @@ static void nc_board_init_bg(const s_game_cfg *game_cfg, s_tarr *board_bg, const
 	//
 	short color_board_bg[board_areas->board_outer.dim.row];
 
-	s_color_def_gradient(color_board_bg, board_areas->board_outer.dim.row, game_cfg->clr_outer_inner_start, game_cfg->clr_outer_inner_end);
+	s_theme_gradient(color_board_bg, board_areas->board_outer.dim.row, game_cfg->clr_outer_inner_start, game_cfg->clr_outer_inner_end);
 
 	s_tarr_set_bg(board_bg, board_areas->board_outer.pos, board_areas->board_outer.dim, color_board_bg, false);
 
@@ -84,13 +94,13 @@ static void nc_board_init_bg(const s_game_cfg *game_cfg, s_tarr *board_bg, const
  * The function allocates the resources for the board.
  *****************************************************************************/
 
-static void nc_board_alloc(WINDOW *win, const s_game_cfg *game_cfg, const s_point board_dim) {
+static void nc_board_alloc(const s_canvas *canvas, const s_game_cfg *game_cfg, const s_point board_dim) {
 
 	log_debug_str("Allocating resources!");
 
-	s_board_init(win, &_board, board_dim);
+	s_board_init(canvas, &_board, board_dim);
 
-	s_tmpl_checker_create(game_cfg);
+	s_tmpl_checker_create(game_cfg, _board.arena);
 }
 
 /******************************************************************************
@@ -101,25 +111,36 @@ void nc_board_free() {
 
 	log_debug_str("Freeing resources!");
 
-	s_board_free(&_board);
-
+	//
+	// The templates are from the arena of the board, so they are freed first.
+	//
 	s_tmpl_checker_free();
+
+	s_board_free(&_board);
 }
 
 /******************************************************************************
  * The function initializes the board.
  *****************************************************************************/
 
-void nc_board_init(WINDOW *win, const s_game_cfg *game_cfg, const s_board_areas *board_areas) {
+void nc_board_init(const s_canvas *canvas, const s_game_cfg *game_cfg, const s_board_areas *board_areas) {
+
+	nc_board_alloc(canvas, game_cfg, board_areas->board_dim);
+
+	anim_init(game_cfg->anim_fps, game_cfg->anim_step_ms, nc_board_anim_render);
+
+	anim_set_keyframes(game_cfg->low_bw);
+
+	hover_init(&_board, game_cfg);
 
-	nc_board_alloc(win, game_cfg, board_areas->board_dim);
+	hint_init(&_board, game_cfg);
 
 	nc_board_init_bg(game_cfg, _board.bg, board_areas);
 
 	//
 	// Add points to the board
 	//
-	s_tmpl_point_create(game_cfg);
+	s_tmpl_point_create(game_cfg, _board.arena);
 
 	s_tmpl_point_add_2_tarr(_board.bg, s_board_areas_get_points());
 
@@ -205,11 +226,24 @@ void nc_board_points_add_checker(s_fieldset *fieldset) {
 
 void nc_board_reset(s_fieldset *fieldset) {
 
+	//
+	// Drop the pending animations, the board is set from the fieldset.
+	//
+	anim_clear();
+
 	//
 	// Delete the current foreground.
 	//
 	s_tarr_set(_board.fg, S_TCHAR_UNUSED);
 
+	//
+	// Delete the highlights, the moves are computed again and the hints are
+	// redrawn.
+	//
+	hover_reset();
+
+	hint_reset();
+
 	//
 	// Add the checker to the (empty) foreground.
 	//
@@ -222,136 +256,235 @@ void nc_board_reset(s_fieldset *fieldset) {
 }
 
 /******************************************************************************
- * The function prints the board window.
+ * The function prints the rows of the board window, that are marked in the
+ * array. The array has an element for each row of the board.
  *****************************************************************************/
 
-void nc_board_print_win() {
+void nc_board_print_rows(const bool *rows) {
+	bool printed = false;
 
-	s_tarr_print_area(_board.win, _board.fg, _board.bg, (s_point ) { 0, 0 }, _board.fg->dim);
+	for (int row = 0; row < _board.fg->dim.row; row++) {
 
-	//
-	// Move the cursor to a save place and do the refreshing. If the cursor
-	// is not moved a flickering can occur. (I am not sure if this is necessary
-	// for this game, but I had trouble with it in the past)
-	//
-	if (wmove(_board.win, 0, 0) == ERR) {
-		log_exit_str("Unable to move the cursor!");
+		if (rows[row]) {
+			s_board_print_area(&_board, (s_point ) { row, 0 }, (s_point ) { 1, _board.fg->dim.col });
+			printed = true;
+		}
 	}
 
-	s_board_win_refresh(&_board, false);
+	if (printed) {
+		s_board_mark(&_board);
+	}
 }
 
 /******************************************************************************
- *
+ * The function prints the board window.
  *****************************************************************************/
 
-static void travler_move(const s_board *board, const s_pos *checker_from, const int num_from, const s_pos *checker_to, const int num_to, const e_owner owner) {
-	s_area area;
+void nc_board_print_win() {
+
+	s_board_print_area(&_board, (s_point ) { 0, 0 }, _board.fg->dim);
 
-	const s_tarr *tmpl = s_tmpl_checker_get_travler(owner);
+	s_board_mark(&_board);
+}
+
+/******************************************************************************
+ * The function adds the frames to a job, that move the traveler in a line
+ * from its current position to a target position. It is assumed that this is
+ * a horizontal or vertical movement. This means the rows or columns of the
+ * current position have to be the same.
+ *****************************************************************************/
 
-	s_point tmpl_pos;
+static void nc_board_job_line(s_anim_job *job, s_anim_frame *frame, const s_point target) {
 
 	//
-	// Phase 1
+	// Ensure that calling to this function is necessary. If the traveler moves
+	// from the top to the bottom half, there may be no horizontal movement
+	// necessary,
 	//
-	area = s_point_layout_ext_area(checker_from);
+	if (s_point_same(&frame->trv_pos, &target)) {
+		log_debug_str("The traveler is already at the target position.");
+		return;
+	}
 
-	if (num_from <= CHECK_DIS_FULL) {
+#ifdef DEBUG
 
-		//
-		// Write the decreased checkers (uncompressed)
-		//
-		s_board_points_add_checkers_pos(board, *checker_from, owner, num_from - 1, E_UNCOMP);
+	//
+	// Ensure that we do not go over the target. This means a simple distance
+	// between the traveler position and the target position should be smaller
+	// every time.
+	//
+	int dist = s_point_dist(frame->trv_pos, target);
+#endif
 
-		//
-		// Add the traveler
-		//
-		tmpl_pos = s_point_layout_pos_full(checker_from, E_UNCOMP, lu_min(num_from, CHECK_DIS_FULL));
-		s_tarr_cp(board->fg, tmpl, tmpl_pos);
+	const s_point dir = direction_to(frame->trv_pos, target);
 
-		s_tarr_print_area(board->win, board->fg, board->bg, area.pos, area.dim);
+	while (!s_point_same(&frame->trv_pos, &target)) {
 
-	} else {
+		direction_mov_to(&frame->trv_pos, dir);
 
-		//
-		// Write the decreased checkers (compressed)
-		//
-		s_board_points_add_checkers_pos(board, *checker_from, owner, num_from - 1, E_COMP);
+#ifdef DEBUG
 
 		//
-		// Add the traveler
+		// Compare the current and the last distances to ensure that the
+		// current will be smaller.
 		//
-		tmpl_pos = s_point_layout_pos_full(checker_from, E_COMP, CHECK_DIS_FULL + 1);
-		s_tarr_cp(board->fg, tmpl, tmpl_pos);
+		dist = s_point_smaller_dist(frame->trv_pos, target, dist);
+#endif
+
+		anim_job_add_frame(job, frame);
+	}
+}
+
+/******************************************************************************
+ * The function creates an animation job for a checker, that moves from a
+ * source to a destination field. The job starts with the traveler leaving the
+ * source field, which may be compressed. Then the traveler walks to the
+ * destination field and arrives there.
+ *****************************************************************************/
+
+static void nc_board_job_create(const s_pos *checker_from, const int num_from, const s_pos *checker_to, const int num_to, const e_owner owner) {
+
+	s_anim_job *job = anim_job_new();
 
-		s_tarr_print_area(board->win, board->fg, board->bg, area.pos, area.dim);
+	job->pos_src = *checker_from;
+	job->pos_dst = *checker_to;
+	job->owner = owner;
 
-		s_board_win_refresh(board, true);
+	job->initial = (s_anim_frame ) { .src = { num_from, E_UNCOMP }, .dst = { num_to, E_UNCOMP }, .has_trv = false };
 
-		s_board_trv_del(board, tmpl, tmpl_pos);
+	s_anim_frame frame = job->initial;
+	frame.has_trv = true;
+
+	//
+	// Phase: departure
+	//
+	if (num_from <= CHECK_DIS_FULL) {
 
 		//
-		// Move the traveler
+		// The decreased checkers (uncompressed) with the traveler.
 		//
-		s_board_trv_mv_to(board, tmpl, &tmpl_pos, checker_from->is_upper ? E_DIR_DOWN : E_DIR_UP);
+		frame.src = (s_anim_stack ) { num_from - 1, E_UNCOMP };
+		frame.trv_pos = s_point_layout_pos_full(checker_from, E_UNCOMP, num_from);
+		anim_job_add_frame(job, &frame);
+
+	} else {
 
 		//
-		// Write the decreased checkers (uncompressed)
+		// The decreased checkers (compressed) with the traveler.
 		//
-		s_board_points_add_checkers_pos(board, *checker_from, owner, num_from - 1, E_UNCOMP);
+		frame.src = (s_anim_stack ) { num_from - 1, E_COMP };
+		frame.trv_pos = s_point_layout_pos_full(checker_from, E_COMP, CHECK_DIS_FULL + 1);
+		anim_job_add_frame(job, &frame);
 
-		s_tarr_print_area(board->win, board->fg, board->bg, area.pos, area.dim);
+		//
+		// Move the traveler and show the decreased checkers (uncompressed)
+		//
+		direction_mov_to(&frame.trv_pos, direction_get(checker_from->is_upper ? E_DIR_DOWN : E_DIR_UP));
+		frame.src.compressed = E_UNCOMP;
+		anim_job_add_frame(job, &frame);
 	}
 
-	s_board_win_refresh(board, true);
-
-	s_board_trv_del(board, tmpl, tmpl_pos);
-
 	//
 	// Phase: walk the line
 	//
-	s_board_trv_mv_line(board, tmpl, &tmpl_pos, (s_point ) { .row = TRAVEL_ROW, .col = tmpl_pos.col });
+	nc_board_job_line(job, &frame, (s_point ) { .row = TRAVEL_ROW, .col = frame.trv_pos.col });
 
-	s_board_trv_mv_line(board, tmpl, &tmpl_pos, (s_point ) { .row = TRAVEL_ROW, .col = checker_to->pos.col });
+	nc_board_job_line(job, &frame, (s_point ) { .row = TRAVEL_ROW, .col = checker_to->pos.col });
 
-	const s_point last_pos = s_point_layout_pos_full(checker_to, E_UNCOMP, lu_min(num_to + 1, CHECK_DIS_FULL + 1));
-	s_board_trv_mv_line(board, tmpl, &tmpl_pos, (s_point ) { .row = last_pos.row, .col = last_pos.col });
+	nc_board_job_line(job, &frame, s_point_layout_pos_full(checker_to, E_UNCOMP, lu_min(num_to + 1, CHECK_DIS_FULL + 1)));
 
 	//
 	// Phase: arrival
 	//
-	area = s_point_layout_ext_area(checker_to);
-
-	if (num_to < CHECK_DIS_FULL) {
+	if (num_to >= CHECK_DIS_FULL) {
 
 		//
-		// Write the increased checker, which overwrites the traveler, so it
-		// does not have to be deleted.
+		// The traveler moves onto the compressed checkers.
 		//
-		s_board_points_add_checkers_pos(board, *checker_to, owner, num_to + 1, E_UNCOMP);
-		s_tarr_print_area(board->win, board->fg, board->bg, area.pos, area.dim);
+		direction_mov_to(&frame.trv_pos, direction_get(checker_to->is_upper ? E_DIR_UP : E_DIR_DOWN));
+		frame.dst = (s_anim_stack ) { num_to, E_COMP };
+		anim_job_add_frame(job, &frame);
+	}
 
-	} else {
+	//
+	// The increased checkers replace the traveler.
+	//
+	frame.has_trv = false;
+	frame.dst = (s_anim_stack ) { num_to + 1, E_UNCOMP };
+	anim_job_add_frame(job, &frame);
 
-		s_board_trv_del(board, tmpl, tmpl_pos);
-		s_board_trv_mv_to(board, tmpl, &tmpl_pos, checker_to->is_upper ? E_DIR_UP : E_DIR_DOWN);
+	anim_job_start(job);
+}
 
-		s_board_points_add_checkers_pos(board, *checker_to, owner, num_to, E_COMP);
-		s_tarr_print_area(board->win, board->fg, board->bg, area.pos, area.dim);
+/******************************************************************************
+ * The function checks whether the area of the traveler at a given position
+ * overlaps with an area.
+ *****************************************************************************/
 
-		//
-		// Do pause
-		//
-		s_board_win_refresh(board, true);
+static bool nc_board_trv_overlaps(const s_area *area, const s_point trv_pos) {
+
+	return trv_pos.row < area->pos.row + area->dim.row && area->pos.row < trv_pos.row + CHECKER_ROW &&
 
-		s_board_trv_del(board, tmpl, tmpl_pos);
+	trv_pos.col < area->pos.col + area->dim.col && area->pos.col < trv_pos.col + CHECKER_COL;
+}
+
+/******************************************************************************
+ * The function updates the checkers of a field on the board, if the state
+ * changed or if the last traveler was deleted on the field area.
+ *****************************************************************************/
 
-		s_board_points_add_checkers_pos(board, *checker_to, owner, num_to + 1, E_UNCOMP);
-		s_tarr_print_area(board->win, board->fg, board->bg, area.pos, area.dim);
+static void nc_board_stack_update(const s_pos *pos, const s_anim_stack *prev, const s_anim_stack *cur, const s_anim_frame *frame_prev, const e_owner owner) {
+
+	const s_area area = s_point_layout_ext_area(pos);
+
+	if (prev->num == cur->num && prev->compressed == cur->compressed && !(frame_prev->has_trv && nc_board_trv_overlaps(&area, frame_prev->trv_pos))) {
+		return;
 	}
 
-	s_board_win_refresh(board, true);
+	s_tarr_del(_board.fg, area.dim, area.pos);
+
+	s_board_points_add_checkers_pos(&_board, *pos, owner, cur->num, cur->compressed);
+
+	s_board_print_area(&_board, area.pos, area.dim);
+}
+
+/******************************************************************************
+ * The function is the callback for the animation. It renders a frame of a
+ * job, starting with the last rendered frame, which may not be the previous
+ * frame.
+ *****************************************************************************/
+
+static void nc_board_anim_render(const s_anim_job *job, const int idx) {
+
+	pf_scope(PF_ANIM_RENDER);
+
+	const s_anim_frame *prev = job->frame_idx < 0 ? &job->initial : &job->frames[job->frame_idx];
+	const s_anim_frame *cur = &job->frames[idx];
+
+	const s_tarr *tmpl = s_tmpl_checker_get_travler(job->owner);
+
+	//
+	// Delete the traveler at its last position.
+	//
+	if (prev->has_trv) {
+		s_board_trv_del(&_board, tmpl, prev->trv_pos);
+	}
+
+	//
+	// Update the checkers of the source and destination field.
+	//
+	nc_board_stack_update(&job->pos_src, &prev->src, &cur->src, prev, job->owner);
+
+	nc_board_stack_update(&job->pos_dst, &prev->dst, &cur->dst, prev, job->owner);
+
+	//
+	// Add the traveler at its current position.
+	//
+	if (cur->has_trv) {
+		s_board_trv_print(&_board, tmpl, cur->trv_pos);
+	}
+
+	s_board_mark(&_board);
 }
 
 /******************************************************************************
@@ -367,9 +500,9 @@ static void traveler_mv(s_field *field_src, s_field *field_dst) {
 	const s_pos pos_to = s_board_areas_get_checker(field_dst->id);
 
 	//
-	// Move the checker on the board (animation).
+	// Create the animation of the move on the board.
 	//
-	travler_move(&_board, &pos_from, field_src->num, &pos_to, field_dst->num, field_src->owner);
+	nc_board_job_create(&pos_from, field_src->num, &pos_to, field_dst->num, field_src->owner);
 
 	//
 	// Move the checker on the game.
@@ -378,17 +511,18 @@ static void traveler_mv(s_field *field_src, s_field *field_dst) {
 }
 
 /******************************************************************************
- * The function is called with the s_field_id from a mouse event.
+ * The function is called with the s_field_id from a mouse event. It returns
+ * true if a checker was moved.
  *****************************************************************************/
 // TODO: working state
-void nc_board_process(s_status *status, s_fieldset *fieldset, const s_field_id id) {
+bool nc_board_process(s_status *status, s_fieldset *fieldset, const s_field_id id) {
 
 	//
 	// If the game ended, there is nothing to do.
 	//
 	if (s_status_is_end(status)) {
 		log_debug_str("Game ended!");
-		return;
+		return false;
 	}
 
 	//
@@ -396,7 +530,7 @@ void nc_board_process(s_status *status, s_fieldset *fieldset, const s_field_id i
 	//
 	s_field *field_src = rules_get_field_src(status, fieldset, id);
 	if (field_src == NULL) {
-		return;
+		return false;
 	}
 
 	//
@@ -405,7 +539,7 @@ void nc_board_process(s_status *status, s_fieldset *fieldset, const s_field_id i
 	s_field *field_dst = rules_can_mv(status, fieldset, field_src);
 	if (field_dst == NULL) {
 		log_debug_str("No target field found");
-		return;
+		return false;
 	}
 
 	//
@@ -423,4 +557,6 @@ void nc_board_process(s_status *status, s_fieldset *fieldset, const s_field_id i
 	rules_update_phase(status, fieldset);
 
 	s_status_next_dice(status);
+
+	return true;
 }
@@ -0,0 +1,240 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/******************************************************************************
+ * The source file implements the performance overlay. The values are the
+ * differences of the counters between two updates, so they show the current
+ * state and not the average of the session. The counters are read without a
+ * lock and the overlay is updated a few times per second, so it does not
+ * disturb the measurements.
+ *
+ * The frame time is the time to print the canvases and to write the frame to
+ * the terminal. The bytes are only known for the direct output, curses does
+ * not report them.
+ *****************************************************************************/
+
+#include "lib_logging.h"
+#include "lib_time.h"
+#include "lib_perf.h"
+#include "lib_utils.h"
+#include "lib_frame.h"
+#include "lib_color_pair.h"
+#include "layout.h"
+#include "overlay.h"
+
+/******************************************************************************
+ * The interval of the updates and the dimension of the window with the
+ * border.
+ *****************************************************************************/
+
+#define OVERLAY_UPDATE_MS 250
+
+#define OVERLAY_LINES 7
+
+static const s_point _dim = { .row = OVERLAY_LINES + 2, .col = 34 };
+
+/******************************************************************************
+ * The counters of the last update and the time of the next update.
+ *****************************************************************************/
+
+static s_pf_stats _pf_last;
+
+static s_frame_stats _frame_last;
+
+static long _time_last = 0;
+
+static long _next_update = 0;
+
+//
+// The flag is set if the bytes are counted, which is the case for the direct
+// output.
+//
+static bool _bytes = false;
+
+static bool _shown = false;
+
+/******************************************************************************
+ * The function initializes the overlay, which is not shown.
+ *****************************************************************************/
+
+void overlay_init(const bool bytes) {
+
+	_bytes = bytes;
+
+	_shown = false;
+}
+
+/******************************************************************************
+ * The function shows or hides the overlay and returns true if the overlay is
+ * shown. The counters are read, so the first update shows the values since
+ * the overlay was shown.
+ *****************************************************************************/
+
+bool overlay_toggle() {
+
+	_shown = !_shown;
+
+	log_debug("Overlay shown: %d", _shown);
+
+	layout_perf_show(_dim, _shown);
+
+	if (_shown) {
+
+		pf_stats(&_pf_last);
+
+		lf_frame_stats(&_frame_last);
+
+		_time_last = lt_now_ms();
+
+		_next_update = _time_last;
+	}
+
+	return _shown;
+}
+
+/******************************************************************************
+ * The function computes the quotient of two differences or returns -1 if the
+ * divisor is zero.
+ *****************************************************************************/
+
+static double overlay_rate(const double value, const double divisor) {
+	return divisor > 0 ? value / divisor : -1;
+}
+
+/******************************************************************************
+ * The function prints a line with a label and a value with a unit. Unknown
+ * values, which are negative, are printed as a dash.
+ *****************************************************************************/
+
+static void overlay_line(WINDOW *win, const int row, const char *label, const char *fmt, const double value, const char *unit) {
+
+	mvwprintw(win, row, 1, "%-8s", label);
+
+	if (value < 0) {
+		wprintw(win, " %10s %-5s", "-", "");
+
+	} else {
+		wprintw(win, fmt, value);
+		wprintw(win, " %-5s", unit);
+	}
+}
+
+/******************************************************************************
+ * The function updates the overlay, if it is shown and the update is due. It
+ * returns true if the window was updated.
+ *****************************************************************************/
+
+bool overlay_tick() {
+
+	if (!_shown) {
+		return false;
+	}
+
+	const long now = lt_now_ms();
+
+	if (now < _next_update) {
+		return false;
+	}
+
+	_next_update = now + OVERLAY_UPDATE_MS;
+
+	s_pf_stats pf;
+	pf_stats(&pf);
+
+	s_frame_stats frame;
+	lf_frame_stats(&frame);
+
+	s_cp_stats cp;
+	cp_stats(&cp);
+
+	const double secs = (now - _time_last) / 1000.0;
+
+	const long flushes = frame.flushes - _frame_last.flushes;
+
+	const long ns = pf.ns[PF_CANVAS_PRINT] - _pf_last.ns[PF_CANVAS_PRINT] + pf.ns[PF_FRAME_FLUSH] - _pf_last.ns[PF_FRAME_FLUSH];
+
+	const long cells = pf.count[PF_CANVAS_CELLS] - _pf_last.count[PF_CANVAS_CELLS];
+
+	const long bytes = pf.count[PF_TERM_BYTES] - _pf_last.count[PF_TERM_BYTES];
+
+	const long nodes = pf.count[PF_ENG_NODES] - _pf_last.count[PF_ENG_NODES];
+
+	const long hits = pf.count[PF_ENG_CACHE_HITS] - _pf_last.count[PF_ENG_CACHE_HITS];
+
+	//
+	// Without the counters, only the values of the compositor and the color
+	// pairs are known.
+	//
+#ifdef PERF
+	const bool perf = true;
+#else
+	const bool perf = false;
+#endif
+
+	WINDOW *win = layout_win_perf();
+
+	werase(win);
+
+	box(win, 0, 0);
+
+	mvwprintw(win, 0, 2, " perf ");
+
+	overlay_line(win, 1, "frame", " %10.3f", perf ? overlay_rate(ns / 1e6, flushes) : -1, "ms");
+
+	overlay_line(win, 2, "fps", " %10.1f", overlay_rate(flushes, secs), "");
+
+	overlay_line(win, 3, "cells", " %10.0f", perf ? overlay_rate(cells, flushes) : -1, "/frm");
+
+	overlay_line(win, 4, "bytes", " %10.0f", perf && _bytes ? overlay_rate(bytes, flushes) : -1, "/frm");
+
+	mvwprintw(win, 5, 1, "%-8s %5d/%-5d ovf %ld", "pairs", cp_color_pair_num(), cp_color_pair_budget(), cp.overflows);
+
+	overlay_line(win, 6, "nodes", " %10.0f", perf ? overlay_rate(nodes, secs) : -1, "/s");
+
+	overlay_line(win, 7, "cache", " %10.1f", perf ? overlay_rate(100.0 * hits, nodes) : -1, "%");
+
+	lf_win_mark(win);
+
+	_pf_last = pf;
+
+	_frame_last = frame;
+
+	_time_last = now;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function returns the number of milliseconds until the next update is
+ * due or -1 if the overlay is not shown.
+ *****************************************************************************/
+
+int overlay_timeout() {
+
+	if (!_shown) {
+		return -1;
+	}
+
+	return (int) lu_max(_next_update - lt_now_ms(), 0);
+}
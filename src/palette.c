@@ -0,0 +1,300 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/******************************************************************************
+ * The source file implements a cache for the resolved palette. The cache file
+ * contains the theme table, the colors and the color pairs. It is keyed by a
+ * hash of the color definitions of the game configuration, the terminal type
+ * and the color settings. If the cache file exists, the theme table is read
+ * and only the init_color() and init_pair() calls are replayed. Nothing has
+ * to be parsed or computed.
+ *
+ * The cache file is small, so it is read with a single read of the stream
+ * buffer.
+ *****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "lib_logging.h"
+#include "lib_color.h"
+#include "lib_color_pair.h"
+#include "s_theme.h"
+#include "palette.h"
+
+/******************************************************************************
+ * The header of the cache file. The version has to be incremented if the
+ * format of the file or of the stored structs changes.
+ *****************************************************************************/
+
+#define PALETTE_MAGIC 0x70676162
+
+#define PALETTE_VERSION 1
+
+typedef struct {
+
+	unsigned int magic;
+
+	unsigned int version;
+
+	unsigned long key;
+
+} s_palette_header;
+
+/******************************************************************************
+ * The state of the cache: the key, the path of the cache file and the number
+ * of colors and color pairs that were read. If nothing was added, the cache
+ * file is not written again.
+ *****************************************************************************/
+
+static unsigned long _key = 0;
+
+static char _path[PATH_MAX] = "";
+
+static int _num_colors = -1;
+
+static int _num_pairs = -1;
+
+/******************************************************************************
+ * The functions compute a FNV-1a hash of a string or a number.
+ *****************************************************************************/
+
+#define PALETTE_FNV_OFFSET 14695981039346656037UL
+
+#define PALETTE_FNV_PRIME 1099511628211UL
+
+static unsigned long palette_hash_str(unsigned long hash, const char *str) {
+
+	for (const char *ptr = str; *ptr != '\0'; ptr++) {
+		hash = (hash ^ (unsigned char) *ptr) * PALETTE_FNV_PRIME;
+	}
+
+	//
+	// Add a separator, so "ab" + "c" differs from "a" + "bc"
+	//
+	return (hash ^ 0xff) * PALETTE_FNV_PRIME;
+}
+
+static unsigned long palette_hash_int(unsigned long hash, const int value) {
+	char buf[16];
+
+	snprintf(buf, sizeof(buf), "%d", value);
+
+	return palette_hash_str(hash, buf);
+}
+
+/******************************************************************************
+ * The function computes the key of the palette.
+ *****************************************************************************/
+
+static unsigned long palette_key(const s_game_cfg *game_cfg, const bool direct) {
+	const char *colors[GAME_CFG_COLORS_NUM];
+
+	unsigned long hash = PALETTE_FNV_OFFSET;
+
+	s_game_cfg_colors(game_cfg, colors);
+
+	for (int i = 0; i < GAME_CFG_COLORS_NUM; i++) {
+		hash = palette_hash_str(hash, colors[i]);
+	}
+
+	const char *term = getenv("TERM");
+
+	hash = palette_hash_str(hash, term != NULL ? term : "");
+
+	hash = palette_hash_int(hash, direct);
+	hash = palette_hash_int(hash, game_cfg->clr_budget);
+	hash = palette_hash_int(hash, game_cfg->clr_tolerance);
+	hash = palette_hash_int(hash, game_cfg->clr_pair_budget);
+
+	hash = palette_hash_int(hash, game_cfg->low_bw ? game_cfg->low_bw_bands : 0);
+
+	return hash;
+}
+
+/******************************************************************************
+ * The function creates a directory, if it does not exist.
+ *****************************************************************************/
+
+static bool palette_mkdir(const char *dir) {
+
+	if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+		log_debug("Unable to create dir: %s - %s", dir, strerror(errno));
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * The function sets the path of the cache file. The directory is
+ * $XDG_CACHE_HOME/baga or $HOME/.cache/baga. The function returns false if
+ * no directory can be determined.
+ *****************************************************************************/
+
+static bool palette_path(const unsigned long key) {
+	char dir[PATH_MAX];
+
+	const char *cache = getenv("XDG_CACHE_HOME");
+
+	if (cache != NULL && cache[0] != '\0') {
+		snprintf(dir, PATH_MAX, "%s/baga", cache);
+
+	} else {
+		const char *home = getenv("HOME");
+
+		if (home == NULL || home[0] == '\0') {
+			return false;
+		}
+
+		snprintf(dir, PATH_MAX, "%s/.cache/baga", home);
+	}
+
+	if (snprintf(_path, PATH_MAX, "%s/palette-%016lx.bin", dir, key) >= PATH_MAX) {
+		_path[0] = '\0';
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * The function reads the palette from the cache file. The colors and the
+ * color pairs have to be initialized (col_init(), cp_init()) before and no
+ * colors may be created. If the cache file does not exist or is not valid,
+ * the function returns false and the theme is compiled instead.
+ *****************************************************************************/
+
+bool palette_load(const s_game_cfg *game_cfg, const bool direct) {
+	s_palette_header header;
+
+	_key = palette_key(game_cfg, direct);
+
+	if (!palette_path(_key)) {
+		s_theme_compile(game_cfg);
+		return false;
+	}
+
+	FILE *stream = fopen(_path, "r");
+
+	if (stream == NULL) {
+		log_debug("No palette cache: %s", _path);
+		s_theme_compile(game_cfg);
+		return false;
+	}
+
+	const bool result = fread(&header, sizeof(s_palette_header), 1, stream) == 1 &&
+
+	header.magic == PALETTE_MAGIC && header.version == PALETTE_VERSION && header.key == _key &&
+
+	s_theme_read(stream) && col_read(stream) && cp_read(stream);
+
+	fclose(stream);
+
+	//
+	// If the cache file is not valid, we start from the scratch.
+	//
+	if (!result) {
+		log_debug("Invalid palette cache: %s", _path);
+
+		col_init(game_cfg->clr_budget, game_cfg->clr_tolerance);
+		cp_init(game_cfg->clr_pair_budget);
+
+		s_theme_compile(game_cfg);
+		return false;
+	}
+
+	_num_colors = col_color_num();
+	_num_pairs = cp_color_pair_num();
+
+	log_debug("Palette cache: %s colors: %d pairs: %d", _path, _num_colors, _num_pairs);
+
+	return true;
+}
+
+/******************************************************************************
+ * The function writes the palette to the cache file, if something was added
+ * since it was read. The file is written to a temp file, which is renamed, so
+ * a concurrent session never reads a partial file. Errors are only logged,
+ * because the cache is optional.
+ *****************************************************************************/
+
+void palette_save() {
+	char tmp[PATH_MAX + 16];
+
+	if (_path[0] == '\0') {
+		return;
+	}
+
+	if (_num_colors == col_color_num() && _num_pairs == cp_color_pair_num()) {
+		log_debug_str("Palette cache is up to date.");
+		return;
+	}
+
+	//
+	// Create the directory with its parent ($HOME/.cache).
+	//
+	char *sep = strrchr(_path, '/');
+	*sep = '\0';
+
+	char *parent = strrchr(_path, '/');
+	*parent = '\0';
+
+	const bool dirs = palette_mkdir(_path);
+
+	*parent = '/';
+
+	const bool dir = dirs && palette_mkdir(_path);
+
+	*sep = '/';
+
+	if (!dir) {
+		return;
+	}
+
+	snprintf(tmp, sizeof(tmp), "%s.%d", _path, (int) getpid());
+
+	FILE *stream = fopen(tmp, "w");
+
+	if (stream == NULL) {
+		log_debug("Unable to open: %s - %s", tmp, strerror(errno));
+		return;
+	}
+
+	const s_palette_header header = { .magic = PALETTE_MAGIC, .version = PALETTE_VERSION, .key = _key };
+
+	const bool result = fwrite(&header, sizeof(s_palette_header), 1, stream) == 1 && s_theme_write(stream) && col_write(stream) && cp_write(stream);
+
+	if (fclose(stream) != 0 || !result || rename(tmp, _path) != 0) {
+		log_debug("Unable to write: %s", _path);
+		remove(tmp);
+		return;
+	}
+
+	log_debug("Palette cache written: %s", _path);
+}
@@ -30,6 +30,7 @@
 
 #include "bg_defs.h"
 #include "lib_logging.h"
+#include "lib_perf.h"
 #include "rules.h"
 
 /******************************************************************************
@@ -61,7 +62,7 @@ int rules_min_rel_idx(const s_status *status, const s_fieldset *fieldset) {
 		// We stop as we find the first checker.
 		//
 		if (field->num > 0 && field->owner == status->turn) {
-			log_debug("Owner: %s relative: %d absolute: %d", e_owner_str(status->turn), idx_abs, idx_rel);
+			log_trace("Owner: %s relative: %d absolute: %d", e_owner_str(status->turn), idx_abs, idx_rel);
 			return idx_rel;
 		}
 	}
@@ -77,6 +78,8 @@ int rules_min_rel_idx(const s_status *status, const s_fieldset *fieldset) {
 
 void rules_update_phase(s_status *status, const s_fieldset *fieldset) {
 
+	pf_scope(PF_RULES_UPDATE_PHASE);
+
 	//
 	// Check: E_PHASE_BEAR_OFF => E_PHASE_WIN
 	//
@@ -134,7 +137,7 @@ s_field* rules_get_field_src(const s_status *status, s_fieldset *fieldset, const
 	s_field_log(field_src, "Source field");
 #endif
 
-	log_debug("Phase: %s", e_player_phase_str(status->player_phase[status->turn]));
+	log_trace("Phase: %s", e_player_phase_str(status->player_phase[status->turn]));
 
 	//
 	// If there is no checker on the field, there is nothing to do.
@@ -213,6 +216,8 @@ static bool rules_is_dest_occupied(const s_field *field_src, const s_field *fiel
 
 s_field* rules_can_mv(const s_status *status, s_fieldset *fieldset, const s_field *field_src) {
 
+	pf_scope(PF_RULES_CAN_MV);
+
 #ifdef DEBUG
 
 	s_field_log(field_src, "Source to move.");
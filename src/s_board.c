@@ -23,25 +23,34 @@
  */
 
 #include "lib_logging.h"
-#include "lib_curses.h"
-#include "direction.h"
 #include "s_board.h"
 
-#define MS_SLEEP 40
+/******************************************************************************
+ * The size of the blocks of the arena, which is large enough for the arrays
+ * of the board and the templates.
+ *****************************************************************************/
+
+#define S_BOARD_ARENA_BLOCK (64 * 1024)
 
 /******************************************************************************
  * The function initializes the s_board struct.
  *****************************************************************************/
 
-void s_board_init(WINDOW *win, s_board *board, const s_point dim) {
+void s_board_init(const s_canvas *canvas, s_board *board, const s_point dim) {
 
 	log_debug_str("Allocating resource!");
 
-	board->bg = s_tarr_new(dim.row, dim.col);
+	board->arena = la_new(S_BOARD_ARENA_BLOCK);
+
+	board->bg = s_tarr_new_arena(board->arena, dim.row, dim.col);
+
+	board->fg = s_tarr_new_arena(board->arena, dim.row, dim.col);
+
+	board->hl = s_tarr_new_arena(board->arena, dim.row, dim.col);
 
-	board->fg = s_tarr_new(dim.row, dim.col);
+	s_tarr_set(board->hl, S_TCHAR_UNUSED);
 
-	board->win = win;
+	board->canvas = *canvas;
 }
 
 /******************************************************************************
@@ -52,27 +61,33 @@ void s_board_free(s_board *board) {
 
 	log_debug_str("Freeing resources!");
 
+	s_tarr_free(&board->hl);
+
 	s_tarr_free(&board->fg);
 
 	s_tarr_free(&board->bg);
+
+	la_free(&board->arena);
 }
 
 /******************************************************************************
- * The function does a refresh of the board window and if required it sleeps
- * for an animation.
+ * The function marks the board canvas as changed. The terminal is updated
+ * with the next frame flush.
  *****************************************************************************/
 
-void s_board_win_refresh(const s_board *board, const bool do_sleep) {
+void s_board_mark(const s_board *board) {
+
+	s_canvas_mark(&board->canvas);
+}
 
-	lc_win_refresh(board->win);
+/******************************************************************************
+ * The function prints an area of the board with all layers: the highlight
+ * overlay, the foreground and the background.
+ *****************************************************************************/
 
-	if (!do_sleep) {
-		return;
-	}
+void s_board_print_area(const s_board *board, const s_point pos, const s_point dim) {
 
-	if (napms(MS_SLEEP) != OK) {
-		log_exit_str("sleep failed!");
-	}
+	s_canvas_print_overlay(&board->canvas, board->hl, board->fg, board->bg, pos, dim);
 }
 
 /******************************************************************************
@@ -80,11 +95,11 @@ void s_board_win_refresh(const s_board *board, const bool do_sleep) {
  * prints the traveler area.
  *****************************************************************************/
 
-static void s_board_trv_print(const s_board *board, const s_tarr *tmpl, const s_point tmpl_pos) {
+void s_board_trv_print(const s_board *board, const s_tarr *tmpl, const s_point tmpl_pos) {
 
 	s_tarr_cp(board->fg, tmpl, tmpl_pos);
 
-	s_tarr_print_area(board->win, board->fg, board->bg, tmpl_pos, tmpl->dim);
+	s_board_print_area(board, tmpl_pos, tmpl->dim);
 }
 
 /******************************************************************************
@@ -96,85 +111,5 @@ void s_board_trv_del(const s_board *board, const s_tarr *tmpl, const s_point tmp
 
 	s_tarr_del(board->fg, tmpl->dim, tmpl_pos);
 
-	s_tarr_print_area(board->win, board->fg, board->bg, tmpl_pos, tmpl->dim);
-}
-
-/******************************************************************************
- * The function is called with the template of the checker and moves the
- * checker from a position to a target position. It is assumed that this is a
- * horizontal or vertical movement. This means the rows or columns of the
- * current position have to be the same.
- *****************************************************************************/
-
-void s_board_trv_mv_line(const s_board *board, const s_tarr *tmpl, s_point *tmpl_pos, const s_point target) {
-
-	//
-	// Ensure that calling to this function is necessary. If the traveler moves
-	// from the top to the bottom half, there may be no horizontal movement
-	// necessary,
-	//
-	if (s_point_same(tmpl_pos, &target)) {
-		log_debug_str("The traveler is already at the target position.");
-		return;
-	}
-
-#ifdef DEBUG
-
-	//
-	// Ensure that we do not go over the target. This means a simple distance
-	// between the traveler position and the target position should be smaller
-	// every time.
-	//
-	int dist = s_point_dist(*tmpl_pos, target);
-#endif
-
-	const s_point dir = direction_to(*tmpl_pos, target);
-
-	while (true) {
-
-		direction_mov_to(tmpl_pos, dir);
-
-#ifdef DEBUG
-
-		//
-		// Compare the current and the last distances to ensure that the
-		// current will be smaller.
-		//
-		dist = s_point_smaller_dist(*tmpl_pos, target, dist);
-#endif
-
-		log_debug("cur: %d/%d target: %d/%d", tmpl_pos->row, tmpl_pos->col, target.row, target.col);
-
-		//
-		// Copy the checker template to the position
-		//
-		s_board_trv_print(board, tmpl, *tmpl_pos);
-
-		s_board_win_refresh(board, true);
-
-		//
-		// Delete the checker template from the position
-		//
-		s_board_trv_del(board, tmpl, *tmpl_pos);
-
-		//
-		// If the current position is the target we are done. It is important
-		// that the traveler is deleted before we return.
-		//
-		if (s_point_same(tmpl_pos, &target)) {
-			log_debug_str("The traveler reached the target position.");
-			return;
-		}
-	}
-}
-
-/******************************************************************************
- * The function moves the checker in the given direction.
- *****************************************************************************/
-
-void s_board_trv_mv_to(const s_board *board, const s_tarr *tmpl, s_point *tmpl_pos, const e_dir dir) {
-
-	direction_mov_to(tmpl_pos, direction_get(dir));
-
-	s_tarr_cp(board->fg, tmpl, *tmpl_pos);
+	s_board_print_area(board, tmpl_pos, tmpl->dim);
 }
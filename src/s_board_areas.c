@@ -52,8 +52,25 @@
 
 #define BORDER_COL 2
 
+#define BOARD_HALF_ROW (2 * POINTS_ROW + CHECKER_ROW + 2 * BORDER_ROW)
+
+#define BOARD_HALF_COL (6 * POINTS_COL)
+
 s_board_areas _board_areas;
 
+/******************************************************************************
+ * The hit-test map contains the field for each cell of the board, so finding
+ * the field for a mouse position is a single lookup. The dimension is the
+ * dimension of the board: the outer and the inner board, the bar and the bear
+ * off area with the borders.
+ *****************************************************************************/
+
+#define TARGETS_ROW (2 * BORDER_ROW + BOARD_HALF_ROW)
+
+#define TARGETS_COL (2 * BOARD_HALF_COL + 2 * POINTS_COL + 3 * BORDER_COL)
+
+static s_field_id _targets[TARGETS_ROW][TARGETS_COL];
+
 /******************************************************************************
  * The positions of the point, bar bear off areas. This is the upper left
  * corner for upper areas and the lower left corner of lower areas.
@@ -169,8 +186,8 @@ static void s_board_areas_set_points(s_pos *pos_points, const s_area *area_board
 
 static void s_board_areas_areas_init(s_board_areas *board_areas) {
 
-	const int board_half_row = (2 * POINTS_ROW + CHECKER_ROW + 2 * BORDER_ROW);
-	const int board_half_col = (6 * POINTS_COL);
+	const int board_half_row = BOARD_HALF_ROW;
+	const int board_half_col = BOARD_HALF_COL;
 
 	//
 	// area: outer board
@@ -215,78 +232,6 @@ static void s_board_areas_areas_init(s_board_areas *board_areas) {
 	board_areas->board_dim.col = board_areas->bear_off.pos.col + board_areas->bear_off.dim.col + BORDER_COL;
 }
 
-/******************************************************************************
- * The function initializes the areas and the positions of the points on the
- * areas.
- *****************************************************************************/
-
-const s_board_areas* s_board_areas_init() {
-
-	//
-	// Initialize the areas
-	//
-	s_board_areas_areas_init(&_board_areas);
-
-	//
-	// Initialize the points and the areas for the checkers on the ares.
-	//
-	s_board_areas_set_bear_off(_pos_bear_off, &_board_areas.bear_off);
-
-	s_board_areas_set_bar(_pos_bar, &_board_areas.bar_inner);
-
-	s_board_areas_set_points(_pos_points, &_board_areas.board_outer, &_board_areas.board_inner);
-
-	return &_board_areas;
-}
-
-/******************************************************************************
- * TODO: not clear if this is the desired approach.
- *****************************************************************************/
-
-const s_pos* s_board_areas_get_points() {
-	return _pos_points;
-}
-
-/******************************************************************************
- * The function returns the position of a checker on a point / bar / bear off
- * area. The checker may be smaller than the containing area.
- *****************************************************************************/
-
-s_pos s_board_areas_get_checker(const s_field_id field_id) {
-	s_pos result;
-
-	switch (field_id.type) {
-
-	case E_FIELD_BAR:
-
-		result.pos.row = _pos_bar[field_id.idx].pos.row;
-		result.pos.col = _pos_bar[field_id.idx].pos.col + CHECKER_OFFSET_COL;
-		result.is_upper = _pos_bar[field_id.idx].is_upper;
-
-		return result;
-
-	case E_FIELD_BEAR_OFF:
-
-		result.pos.row = _pos_bear_off[field_id.idx].pos.row;
-		result.pos.col = _pos_bear_off[field_id.idx].pos.col + CHECKER_OFFSET_COL;
-		result.is_upper = _pos_bear_off[field_id.idx].is_upper;
-
-		return result;
-
-	case E_FIELD_POINTS:
-
-		result.pos.row = _pos_points[field_id.idx].pos.row;
-		result.pos.col = _pos_points[field_id.idx].pos.col + CHECKER_OFFSET_COL;
-		result.is_upper = _pos_points[field_id.idx].is_upper;
-
-		return result;
-
-	default:
-		log_exit("Unknown type: %d", field_id.type)
-		;
-	}
-}
-
 /******************************************************************************
  * The macro is called with an area and a point. The area has to be the inner
  * or the outer board and the point has to be inside.
@@ -307,11 +252,12 @@ s_pos s_board_areas_get_checker(const s_field_id field_id) {
 #define s_pos_get_point_idx(a,p) (((p).col - (a).pos.col) / 6)
 
 /******************************************************************************
- * The function is called with a mouse position and returns the field for this
- * position. This can be one of the points / bar / bear off.
+ * The function computes the field for a position on the board. This can be
+ * one of the points / bar / bear off. The function is used to fill the
+ * hit-test map.
  *****************************************************************************/
 
-void s_board_areas_mouse_target(const s_point mouse, s_field_id *field_id) {
+static void s_board_areas_target_compute(const s_point mouse, s_field_id *field_id) {
 
 	//
 	// Inner board
@@ -367,6 +313,120 @@ void s_board_areas_mouse_target(const s_point mouse, s_field_id *field_id) {
 	else {
 		s_field_id_set_none_ptr(field_id);
 	}
+}
+
+/******************************************************************************
+ * The function fills the hit-test map with the field of each cell of the
+ * board. It has to be called after the areas are initialized.
+ *****************************************************************************/
+
+static void s_board_areas_targets_init(const s_board_areas *board_areas) {
+
+	//
+	// Ensure that the map has the dimension of the board. The check is done
+	// once, so it is part of the release build.
+	//
+	if (board_areas->board_dim.row != TARGETS_ROW || board_areas->board_dim.col != TARGETS_COL) {
+		log_exit("Invalid dimension: %d/%d", board_areas->board_dim.row, board_areas->board_dim.col);
+	}
+
+	for (int row = 0; row < TARGETS_ROW; row++) {
+		for (int col = 0; col < TARGETS_COL; col++) {
+			s_board_areas_target_compute((s_point ) { .row = row, .col = col }, &_targets[row][col]);
+		}
+	}
+}
+
+/******************************************************************************
+ * The function initializes the areas and the positions of the points on the
+ * areas.
+ *****************************************************************************/
+
+const s_board_areas* s_board_areas_init() {
+
+	//
+	// Initialize the areas
+	//
+	s_board_areas_areas_init(&_board_areas);
+
+	//
+	// Initialize the points and the areas for the checkers on the ares.
+	//
+	s_board_areas_set_bear_off(_pos_bear_off, &_board_areas.bear_off);
+
+	s_board_areas_set_bar(_pos_bar, &_board_areas.bar_inner);
+
+	s_board_areas_set_points(_pos_points, &_board_areas.board_outer, &_board_areas.board_inner);
+
+	//
+	// Compute the field of each cell for the mouse targeting.
+	//
+	s_board_areas_targets_init(&_board_areas);
+
+	return &_board_areas;
+}
+
+/******************************************************************************
+ * TODO: not clear if this is the desired approach.
+ *****************************************************************************/
+
+const s_pos* s_board_areas_get_points() {
+	return _pos_points;
+}
+
+/******************************************************************************
+ * The function returns the position of a point / bar / bear off area. The
+ * area has the width of a point.
+ *****************************************************************************/
+
+s_pos s_board_areas_get_field(const s_field_id field_id) {
+
+	switch (field_id.type) {
+
+	case E_FIELD_BAR:
+		return _pos_bar[field_id.idx];
+
+	case E_FIELD_BEAR_OFF:
+		return _pos_bear_off[field_id.idx];
+
+	case E_FIELD_POINTS:
+		return _pos_points[field_id.idx];
+
+	default:
+		log_exit("Unknown type: %d", field_id.type)
+		;
+	}
+}
+
+/******************************************************************************
+ * The function returns the position of a checker on a point / bar / bear off
+ * area. The checker may be smaller than the containing area.
+ *****************************************************************************/
+
+s_pos s_board_areas_get_checker(const s_field_id field_id) {
+
+	s_pos result = s_board_areas_get_field(field_id);
+
+	result.pos.col += CHECKER_OFFSET_COL;
+
+	return result;
+}
+
+/******************************************************************************
+ * The function is called with a mouse position and returns the field for this
+ * position. This can be one of the points / bar / bear off. The field is read
+ * from the hit-test map, so the function is cheap enough to be called for
+ * each mouse motion.
+ *****************************************************************************/
+
+void s_board_areas_mouse_target(const s_point mouse, s_field_id *field_id) {
+
+	if (mouse.row < 0 || mouse.row >= TARGETS_ROW || mouse.col < 0 || mouse.col >= TARGETS_COL) {
+		s_field_id_set_none_ptr(field_id);
+
+	} else {
+		*field_id = _targets[mouse.row][mouse.col];
+	}
 
-	log_debug("mouse: %d/%d result: %d/%d", mouse.row, mouse.col, field_id->type, field_id->idx);
+	log_trace("mouse: %d/%d result: %d/%d", mouse.row, mouse.col, field_id->type, field_id->idx);
 }
@@ -0,0 +1,445 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "lib_logging.h"
+#include "lib_utils.h"
+#include "lib_perf.h"
+#include "lib_color.h"
+#include "lib_color_pair.h"
+#include "lib_frame.h"
+#include "s_canvas.h"
+
+/******************************************************************************
+ * The function initializes a canvas, that renders to a curses window.
+ *****************************************************************************/
+
+void s_canvas_init_curses(s_canvas *canvas, WINDOW *win) {
+
+	canvas->type = E_CANVAS_CURSES;
+	canvas->win = win;
+	canvas->cells = NULL;
+	canvas->pos = (s_point ) { 0, 0 };
+}
+
+/******************************************************************************
+ * The function initializes a headless canvas, that renders to an area of a
+ * cell buffer. The position is the upper left corner of the area.
+ *****************************************************************************/
+
+void s_canvas_init_cells(s_canvas *canvas, s_tarr *cells, const s_point pos) {
+
+	canvas->type = E_CANVAS_CELLS;
+	canvas->win = NULL;
+	canvas->cells = cells;
+	canvas->pos = pos;
+}
+
+/******************************************************************************
+ * The function marks the canvas as changed. For a curses canvas, the window is
+ * marked for the next frame flush. For a headless canvas, only the frame is
+ * marked, which is used if the cell buffer is presented on flush.
+ *****************************************************************************/
+
+void s_canvas_mark(const s_canvas *canvas) {
+
+	//
+	// A headless canvas has no window, but the frame has changed.
+	//
+	if (canvas->type != E_CANVAS_CURSES) {
+		lf_frame_mark();
+		return;
+	}
+
+	//
+	// Move the cursor to a save place. If the cursor is not moved a flickering
+	// can occur.
+	//
+	if (wmove(canvas->win, 0, 0) == ERR) {
+		log_exit_str("Unable to move the cursor!");
+	}
+
+	lf_win_mark(canvas->win);
+}
+
+/******************************************************************************
+ * The function writes an element of a s_tarr, given by its index, to the
+ * canvas at a given position.
+ *****************************************************************************/
+
+static void s_canvas_put(const s_canvas *canvas, const int row, const int col, const s_tarr *tarr, const int idx) {
+
+	pf_count(PF_CANVAS_CELLS);
+
+	if (canvas->type == E_CANVAS_CELLS) {
+
+#ifdef DEBUG
+
+		//
+		// Ensure that the position is inside the cell buffer.
+		//
+		if (canvas->pos.row + row >= canvas->cells->dim.row || canvas->pos.col + col >= canvas->cells->dim.col) {
+			log_exit("Position not inside: %d/%d", row, col);
+		}
+#endif
+
+		const int idx_cell = s_tarr_idx(canvas->cells, canvas->pos.row + row, canvas->pos.col + col);
+
+		canvas->cells->chr[idx_cell] = tarr->chr[idx];
+		canvas->cells->fg[idx_cell] = tarr->fg[idx];
+		canvas->cells->bg[idx_cell] = tarr->bg[idx];
+		return;
+	}
+
+	//
+	// Set the color pair with the t_char
+	//
+	const short cp = cp_color_pair_get(tarr->fg[idx], tarr->bg[idx]);
+	wattrset(canvas->win, COLOR_PAIR(cp));
+
+	mvwprintw(canvas->win, row, col, "%lc", tarr->chr[idx]);
+}
+
+/******************************************************************************
+ * The function prints the foreground at a given position. If the foreground is
+ * not defined we use the background.
+ *****************************************************************************/
+
+void s_canvas_print_area(const s_canvas *canvas, const s_tarr *ta_fg, const s_tarr *ta_bg, const s_point pos, const s_point dim) {
+
+	s_canvas_print_overlay(canvas, NULL, ta_fg, ta_bg, pos, dim);
+}
+
+/******************************************************************************
+ * The function prints an area with an overlay, the foreground and the
+ * background. The overlay has the highest priority and it is optional (NULL).
+ * An undefined cell of a layer is transparent.
+ *****************************************************************************/
+
+void s_canvas_print_overlay(const s_canvas *canvas, const s_tarr *ta_ov, const s_tarr *ta_fg, const s_tarr *ta_bg, const s_point pos, const s_point dim) {
+
+	pf_scope(PF_CANVAS_PRINT);
+
+	const int row_end = pos.row + dim.row;
+	const int col_end = pos.col + dim.col;
+
+#ifdef DEBUG
+
+	//
+	// Ensure that both have the same dimension.
+	//
+	if (ta_fg->dim.row != ta_bg->dim.row || ta_fg->dim.col != ta_bg->dim.col) {
+		log_exit_str("FG and BG dimensions differ!");
+	}
+
+	if (ta_ov != NULL && (ta_ov->dim.row != ta_bg->dim.row || ta_ov->dim.col != ta_bg->dim.col)) {
+		log_exit_str("Overlay and BG dimensions differ!");
+	}
+
+	//
+	// Ensure that the area is inside the fg / bg.
+	//
+	if (ta_fg->dim.row < row_end || ta_fg->dim.col < col_end) {
+		log_exit_str("Area not inside!");
+	}
+
+#endif
+
+	const s_tarr *tarr;
+	int idx;
+
+	for (int row = pos.row; row < row_end; row++) {
+		for (int col = pos.col; col < col_end; col++) {
+
+			//
+			// We first try the overlay and the foreground. If both are not
+			// defined we use the background. (All have the same dimension,
+			// so the index is the same)
+			//
+			idx = s_tarr_idx(ta_fg, row, col);
+
+			if (ta_ov != NULL && ta_ov->chr[idx] != TCHAR_CHR_UNUSED) {
+				tarr = ta_ov;
+
+			} else {
+				tarr = ta_fg->chr[idx] != TCHAR_CHR_UNUSED ? ta_fg : ta_bg;
+			}
+
+#ifdef DEBUG
+
+			//
+			// Ensure that the color pair is valid. Here we have a position.
+			//
+			if (!col_is_valid(tarr->fg[idx]) || !col_is_valid(tarr->bg[idx])) {
+				log_exit("Color: %d/%d at: %d/%d", tarr->fg[idx], tarr->bg[idx], row, col);
+			}
+#endif
+
+			s_canvas_put(canvas, row, col, tarr, idx);
+		}
+	}
+}
+
+/******************************************************************************
+ * The function simply print the s_tarr to the canvas at a given position.
+ *****************************************************************************/
+
+void s_canvas_print(const s_canvas *canvas, const s_tarr *tarr, const s_point pos) {
+
+	pf_scope(PF_CANVAS_PRINT);
+
+	for (int row = 0; row < tarr->dim.row; row++) {
+		for (int col = 0; col < tarr->dim.col; col++) {
+			s_canvas_put(canvas, pos.row + row, pos.col + col, tarr, s_tarr_idx(tarr, row, col));
+		}
+	}
+}
+
+/******************************************************************************
+ * The function writes blank with default colors / color pair to the canvas. It
+ * can be used to delete a s_tarr.
+ *****************************************************************************/
+
+void s_canvas_print_empty(const s_canvas *canvas, const s_point dim, const s_point pos) {
+
+	if (canvas->type == E_CANVAS_CELLS) {
+
+		s_tarr_set_area(canvas->cells, dim, (s_point ) { canvas->pos.row + pos.row, canvas->pos.col + pos.col }, S_TCHAR_EMPTY);
+
+		return;
+	}
+
+	wattrset(canvas->win, COLOR_PAIR(0));
+
+	for (int row = 0; row < dim.row; row++) {
+		for (int col = 0; col < dim.col; col++) {
+
+			mvwaddch(canvas->win, pos.row + row, pos.col + col, ' ');
+		}
+	}
+}
+
+/******************************************************************************
+ * The function appends the SGR parameters of a color to a buffer and returns
+ * the new length. Each parameter starts with a semicolon, which is skipped
+ * for the first parameter of the sequence. With the palette_256 flag, the
+ * colors are written as colors of the 256 color palette and the 16 base
+ * colors with their short parameters (example: 37 instead of 38;5;7).
+ *****************************************************************************/
+
+static int s_canvas_sgr_color(char *buf, const int len, const int sgr, const short color, const bool palette_256) {
+	short r, g, b;
+
+	if (!palette_256) {
+
+		if (!col_color_rgb(color, &r, &g, &b)) {
+			return len + sprintf(&buf[len], ";%d", sgr + 1);
+		}
+
+		return len + sprintf(&buf[len], ";%d;2;%d;%d;%d", sgr, r * 255 / 1000, g * 255 / 1000, b * 255 / 1000);
+	}
+
+	const short color_256 = col_color_256(color);
+
+	if (color_256 == COLOR_UNDEF) {
+		return len + sprintf(&buf[len], ";%d", sgr + 1);
+	}
+
+	//
+	// The sgr is 38 or 48, so the base colors are: 30-37 / 40-47 and the
+	// bright colors are: 90-97 / 100-107
+	//
+	if (color_256 < 8) {
+		return len + sprintf(&buf[len], ";%d", sgr - 8 + color_256);
+	}
+
+	if (color_256 < 16) {
+		return len + sprintf(&buf[len], ";%d", sgr + 52 + color_256 - 8);
+	}
+
+	return len + sprintf(&buf[len], ";%d;5;%d", sgr, color_256);
+}
+
+/******************************************************************************
+ * The function writes the SGR sequence of a color. The first parameter is 38
+ * for the foreground and 48 for the background. An undefined color is the
+ * default color of the terminal. The values of the colors are 0-1000, so they
+ * are scaled to 0-255.
+ *****************************************************************************/
+
+static size_t s_canvas_dump_color(FILE *stream, const int sgr, const short color) {
+	char buf[32];
+
+	s_canvas_sgr_color(buf, 0, sgr, color, false);
+
+	return fprintf(stream, "\033[%sm", &buf[1]);
+}
+
+/******************************************************************************
+ * The function writes a cell buffer to a stream and returns the number of
+ * bytes. Without the ansi flag, only the characters are written, which is
+ * used for golden snapshots. With the ansi flag, the colors are written as
+ * truecolor SGR sequences, which are only written if the color changes. The
+ * output can be written directly to a terminal.
+ *****************************************************************************/
+
+size_t s_canvas_dump(FILE *stream, const s_tarr *cells, const bool ansi) {
+	size_t bytes = 0;
+	short fg, bg;
+	int idx;
+
+	for (int row = 0; row < cells->dim.row; row++) {
+
+		//
+		// Each line starts with the default colors.
+		//
+		fg = COLOR_UNDEF;
+		bg = COLOR_UNDEF;
+
+		for (int col = 0; col < cells->dim.col; col++) {
+			idx = s_tarr_idx(cells, row, col);
+
+			if (ansi && cells->fg[idx] != fg) {
+				fg = cells->fg[idx];
+				bytes += s_canvas_dump_color(stream, 38, fg);
+			}
+
+			if (ansi && cells->bg[idx] != bg) {
+				bg = cells->bg[idx];
+				bytes += s_canvas_dump_color(stream, 48, bg);
+			}
+
+			bytes += fprintf(stream, "%lc", cells->chr[idx] != TCHAR_CHR_UNUSED ? cells->chr[idx] : L' ');
+		}
+
+		if (ansi) {
+			bytes += fprintf(stream, "\033[0m");
+		}
+
+		bytes += fprintf(stream, "\n");
+	}
+
+	return bytes;
+}
+
+/******************************************************************************
+ * The function writes the cells of a cell buffer, that differ from the
+ * previous cell buffer, directly to a terminal with truecolor SGR sequences.
+ * The cursor is only positioned if the changed cells are not adjacent and a
+ * color is only written if it differs from the color of the last written
+ * cell. The colors of a cell are written with one SGR sequence. The previous
+ * cell buffer is updated. The function returns the number of bytes. With the
+ * palette_256 flag, the colors are written as colors of the 256 color
+ * palette, which needs less bytes. Cells outside the visible dimension of the
+ * terminal are not written and stay changed, so they are written if the
+ * terminal gets larger again.
+ *****************************************************************************/
+
+size_t s_canvas_present(FILE *stream, const s_tarr *cells, s_tarr *prev, const s_point visible, const bool palette_256) {
+	size_t bytes = 0;
+	short fg = COLOR_UNDEF;
+	short bg = COLOR_UNDEF;
+	int idx, idx_prev;
+
+	//
+	// The buffer for the parameters of a SGR sequence (reset, foreground and
+	// background with truecolor).
+	//
+	char sgr[64];
+	int len;
+
+	//
+	// The position after the last written cell.
+	//
+	int cur_row = -1;
+	int cur_col = -1;
+
+	bool changed = false;
+
+	const int row_end = lu_min(cells->dim.row, visible.row);
+	const int col_end = lu_min(cells->dim.col, visible.col);
+
+	for (int row = 0; row < row_end; row++) {
+		for (int col = 0; col < col_end; col++) {
+
+			idx = s_tarr_idx(cells, row, col);
+			idx_prev = s_tarr_idx(prev, row, col);
+
+			if (cells->chr[idx] == prev->chr[idx_prev] && cells->fg[idx] == prev->fg[idx_prev] && cells->bg[idx] == prev->bg[idx_prev]) {
+				continue;
+			}
+
+			//
+			// Cells on the same row are reached by moving the cursor forward,
+			// which is shorter than the absolute position.
+			//
+			if (row == cur_row && col > cur_col) {
+				bytes += col - cur_col == 1 ? fprintf(stream, "\033[C") : fprintf(stream, "\033[%dC", col - cur_col);
+
+			} else if (row != cur_row || col != cur_col) {
+				bytes += fprintf(stream, "\033[%d;%dH", row + 1, col + 1);
+			}
+
+			//
+			// The attributes of the terminal are reset with the first changed
+			// cell, so the current colors are the default colors. The reset
+			// and the colors are written with a single SGR sequence.
+			//
+			len = 0;
+
+			if (!changed) {
+				len = sprintf(sgr, ";0");
+				changed = true;
+			}
+
+			if (cells->fg[idx] != fg) {
+				fg = cells->fg[idx];
+				len = s_canvas_sgr_color(sgr, len, 38, fg, palette_256);
+			}
+
+			if (cells->bg[idx] != bg) {
+				bg = cells->bg[idx];
+				len = s_canvas_sgr_color(sgr, len, 48, bg, palette_256);
+			}
+
+			if (len > 0) {
+				bytes += fprintf(stream, "\033[%sm", &sgr[1]);
+			}
+
+			bytes += fprintf(stream, "%lc", cells->chr[idx] != TCHAR_CHR_UNUSED ? cells->chr[idx] : L' ');
+
+			cur_row = row;
+			cur_col = col + 1;
+
+			prev->chr[idx_prev] = cells->chr[idx];
+			prev->fg[idx_prev] = cells->fg[idx];
+			prev->bg[idx_prev] = cells->bg[idx];
+		}
+	}
+
+	if (changed) {
+		bytes += fprintf(stream, "\033[0m");
+	}
+
+	return bytes;
+}
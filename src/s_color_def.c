@@ -22,12 +22,10 @@
  * SOFTWARE.
  */
 
-#include <math.h>
 #include <string.h>
 
 #include "s_color_def.h"
 #include "lib_logging.h"
-#include "lib_color.h"
 
 /******************************************************************************
  * The function is called with a hex character and returns the decimal value.
@@ -110,11 +108,26 @@ void s_color_def_hex_dec(s_color_def *color_def) {
 	}
 #endif
 
-	color_def->r = round((double) color_def->r * 1000.0 / 0xff);
-	color_def->g = round((double) color_def->g * 1000.0 / 0xff);
-	color_def->b = round((double) color_def->b * 1000.0 / 0xff);
+	//
+	// Integer division, that rounds to the nearest value.
+	//
+	color_def->r = (color_def->r * 1000 + 0xff / 2) / 0xff;
+	color_def->g = (color_def->g * 1000 + 0xff / 2) / 0xff;
+	color_def->b = (color_def->b * 1000 + 0xff / 2) / 0xff;
 }
 
+/******************************************************************************
+ * The gradients are computed with fixed-point numbers, with 16 bits for the
+ * fraction. The macro interpolates a value from start to end with a ratio,
+ * which is a fixed-point number between 0 and 1. The result is rounded.
+ *****************************************************************************/
+
+#define S_COLOR_DEF_FP_SHIFT 16
+
+#define S_COLOR_DEF_FP_ONE (1 << S_COLOR_DEF_FP_SHIFT)
+
+#define s_color_def_fp_lerp(s, e, ratio) (((s) * (S_COLOR_DEF_FP_ONE - (ratio)) + (e) * (ratio) + S_COLOR_DEF_FP_ONE / 2) >> S_COLOR_DEF_FP_SHIFT)
+
 /******************************************************************************
  * The function computes the rgb values for the gradient step i.
  *
@@ -134,73 +147,12 @@ void s_color_def_gradient_do(const int num, const int i, const s_color_def *star
 #endif
 
 	//
-	// Ration of start and end color. The value should be between 0 and 1.
+	// Ratio of start and end color as a fixed-point number between 0 and 1. A
+	// gradient with one step has the start color.
 	//
-	const double x = (double) i / (num - 1);
+	const int ratio = num > 1 ? (i << S_COLOR_DEF_FP_SHIFT) / (num - 1) : 0;
 
-	result->r = end->r * x + start->r * (1 - x);
-	result->g = end->g * x + start->g * (1 - x);
-	result->b = end->b * x + start->b * (1 - x);
+	result->r = s_color_def_fp_lerp(start->r, end->r, ratio);
+	result->g = s_color_def_fp_lerp(start->g, end->g, ratio);
+	result->b = s_color_def_fp_lerp(start->b, end->b, ratio);
 }
-
-/******************************************************************************
- * The function is called with an array of colors with num elements, which
- * should be filled with the gradient from start color to end color.
- *****************************************************************************/
-
-void s_color_def_gradient(short *colors, const int num, const char *str_start, const char *str_end) {
-
-	log_debug("num: %d start: %s end: %s", num, str_start, str_end);
-
-	s_color_def start, end, result;
-
-	//
-	// Convert the start color from a string to hex values to ncurses values (0-1000)
-	//
-	s_color_def_hex_str(&start, str_start);
-	s_color_def_hex_dec(&start);
-
-	//
-	// Convert the end color from a string to hex values to ncurses values (0-1000)
-	//
-	s_color_def_hex_str(&end, str_end);
-	s_color_def_hex_dec(&end);
-
-	for (int i = 0; i < num; i++) {
-
-		//
-		// Create the color for step i.
-		//
-		s_color_def_gradient_do(num, i, &start, &end, &result);
-
-		//
-		// Create the color with the ncurses rgb values (0-1000).
-		//
-		colors[i] = col_color_create(result.r, result.g, result.b);
-	}
-}
-
-/******************************************************************************
- * The function creates a color from a hex string.
- *****************************************************************************/
-
-short s_color_def_hex_create(const char *hex) {
-
-	s_color_def color_def;
-
-	//
-	// Decode the hex string to 0-255
-	//
-	s_color_def_hex_str(&color_def, hex);
-
-	//
-	// Scale the value to 0-1000
-	//
-	s_color_def_hex_dec(&color_def);
-
-	//
-	// Create the color.
-	//
-	return col_color_create(color_def.r, color_def.g, color_def.b);
-}
-
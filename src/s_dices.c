@@ -223,6 +223,24 @@ void s_dices_next(s_dices *dices) {
 	log_exit_str("No active dice to set!");
 }
 
+/******************************************************************************
+ * The function is called if no checker can be moved with the dices, that are
+ * not set. Their status is changed to E_DICE_NOT_POS, so the player can
+ * confirm the round.
+ *
+ * (Unit tested)
+ *****************************************************************************/
+
+void s_dices_set_not_pos(s_dices *dices) {
+
+	for (int dice_idx = 0; dice_idx < 2; dice_idx++) {
+
+		if (dices->dice[dice_idx].status == E_DICE_ACTIVE || dices->dice[dice_idx].status == E_DICE_INACTIVE) {
+			dices->dice[dice_idx].status = E_DICE_NOT_POS;
+		}
+	}
+}
+
 /******************************************************************************
  * The function is called in reaction to a mouse event on one of the dices and
  * tries to toggle the active dice. To succeed this requires that the clicked
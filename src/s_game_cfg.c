@@ -22,6 +22,9 @@
  * SOFTWARE.
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "s_game_cfg.h"
 
 /******************************************************************************
@@ -103,4 +106,120 @@ void s_game_cfg_init(s_game_cfg *game_cfg) {
 	game_cfg->clr_ctrl_bg_active = "#6b6b47";
 
 	game_cfg->clr_ctrl_bg_inactive = "#3d3d29";
+
+	//
+	// Color: highlights
+	//
+	game_cfg->clr_hl_src = "#3399ff";
+
+	game_cfg->clr_hl_dst = "#33ff66";
+
+	//
+	// Color: hints
+	//
+	game_cfg->clr_hint_fg = "#f2f2f2";
+
+	game_cfg->clr_hint_bg = "#262626";
+
+	//
+	// Animation
+	//
+	game_cfg->anim_fps = 50;
+
+	game_cfg->anim_step_ms = 40;
+
+	//
+	// Color interning
+	//
+	game_cfg->clr_budget = 0;
+
+	game_cfg->clr_tolerance = 4;
+
+	game_cfg->clr_pair_budget = 0;
+
+	//
+	// Direct truecolor output
+	//
+	const char *direct = getenv("BAGA_DIRECT");
+
+	game_cfg->clr_direct = direct != NULL && strcmp(direct, "1") == 0;
+
+	//
+	// Low bandwidth mode
+	//
+	const char *low_bw = getenv("BAGA_LOW_BW");
+
+	game_cfg->low_bw = low_bw != NULL && strcmp(low_bw, "1") == 0;
+
+	game_cfg->low_bw_bands = 2;
+
+	//
+	// Computer player
+	//
+	const char *bot_level = getenv("BAGA_BOT_LEVEL");
+
+	game_cfg->bot_level = bot_level == NULL ? 2 : atoi(bot_level);
+
+	const char *bot_think_ms = getenv("BAGA_BOT_THINK_MS");
+
+	game_cfg->bot_think_ms = bot_think_ms == NULL ? 0 : atoi(bot_think_ms);
+
+	const char *bot_ponder = getenv("BAGA_BOT_PONDER");
+
+	game_cfg->bot_ponder = bot_ponder == NULL || strcmp(bot_ponder, "0") != 0;
+
+	//
+	// Thread pool
+	//
+	const char *pool_workers = getenv("BAGA_POOL_WORKERS");
+
+	game_cfg->pool_workers = pool_workers == NULL ? 0 : atoi(pool_workers);
+
+	const char *pool_pin = getenv("BAGA_POOL_PIN");
+
+	game_cfg->pool_pin = pool_pin != NULL && strcmp(pool_pin, "1") == 0;
+}
+
+/******************************************************************************
+ * The function fills an array with the color definitions of the game
+ * configuration (hex strings). The array has to have GAME_CFG_COLORS_NUM
+ * elements.
+ *****************************************************************************/
+
+void s_game_cfg_colors(const s_game_cfg *game_cfg, const char *colors[GAME_CFG_COLORS_NUM]) {
+	int i = 0;
+
+	colors[i++] = game_cfg->clr_board_start;
+	colors[i++] = game_cfg->clr_board_end;
+
+	colors[i++] = game_cfg->clr_outer_inner_start;
+	colors[i++] = game_cfg->clr_outer_inner_end;
+
+	colors[i++] = game_cfg->clr_points_black_start;
+	colors[i++] = game_cfg->clr_points_black_end;
+	colors[i++] = game_cfg->clr_points_white_start;
+	colors[i++] = game_cfg->clr_points_white_end;
+
+	colors[i++] = game_cfg->clr_checker_black_start;
+	colors[i++] = game_cfg->clr_checker_black_end;
+	colors[i++] = game_cfg->clr_checker_white_start;
+	colors[i++] = game_cfg->clr_checker_white_end;
+
+	colors[i++] = game_cfg->clr_dice_black_active;
+	colors[i++] = game_cfg->clr_dice_black_inactive;
+	colors[i++] = game_cfg->clr_dice_white_active;
+	colors[i++] = game_cfg->clr_dice_white_inactive;
+
+	colors[i++] = game_cfg->clr_ctrl_confirm_active;
+	colors[i++] = game_cfg->clr_ctrl_confirm_inactive;
+	colors[i++] = game_cfg->clr_ctrl_undo_active;
+	colors[i++] = game_cfg->clr_ctrl_undo_inactive;
+	colors[i++] = game_cfg->clr_ctrl_bg_active;
+	colors[i++] = game_cfg->clr_ctrl_bg_inactive;
+
+	colors[i++] = game_cfg->clr_hl_src;
+	colors[i++] = game_cfg->clr_hl_dst;
+
+	colors[i++] = game_cfg->clr_hint_fg;
+	colors[i++] = game_cfg->clr_hint_bg;
 }
@@ -168,7 +168,7 @@ s_area s_point_layout_get_area(const s_pos *pos, const int dim_row, const int di
 
 	};
 
-	log_debug("area - pos: %d/%d dim: %d/%d", result.pos.row, result.pos.col, result.dim.row, result.dim.col);
+	log_trace("area - pos: %d/%d dim: %d/%d", result.pos.row, result.pos.col, result.dim.row, result.dim.col);
 
 	return result;
 }
@@ -245,7 +245,7 @@ s_point s_point_layout_pos_full(const s_pos *pos, const e_compressed compressed,
 		}
 	}
 
-	log_debug("pos: %d/%d result: %d/%d full: %d", pos->pos.row, pos->pos.col, result.row, result.col, num_full);
+	log_trace("pos: %d/%d result: %d/%d full: %d", pos->pos.row, pos->pos.col, result.row, result.col, num_full);
 
 	return result;
 }
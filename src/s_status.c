@@ -37,6 +37,17 @@ static s_status _status_undo;
 
 static s_fieldset _fieldset_undo;
 
+/******************************************************************************
+ * The status at the start of the previous round. It is used to undo the
+ * round of the human player, while the computer player is in turn.
+ *****************************************************************************/
+
+static s_status _status_round;
+
+static s_fieldset _fieldset_round;
+
+static bool _round_valid = false;
+
 /******************************************************************************
  * The functions saves the status, so that we can do a undo.
  *****************************************************************************/
@@ -45,6 +56,10 @@ static void s_status_undo_save(const s_status *status, const s_fieldset *fieldse
 
 	log_debug_str("Do save");
 
+	memcpy(&_status_round, &_status_undo, sizeof(s_status));
+	memcpy(&_fieldset_round, &_fieldset_undo, sizeof(s_fieldset));
+	_round_valid = true;
+
 	memcpy(&_status_undo, status, sizeof(s_status));
 	memcpy(&_fieldset_undo, fieldset, sizeof(s_fieldset));
 }
@@ -61,6 +76,31 @@ void s_status_undo_reset(s_status *status, s_fieldset *fieldset) {
 	memcpy(fieldset, &_fieldset_undo, sizeof(s_fieldset));
 }
 
+/******************************************************************************
+ * The function resets the status to the start of the previous round, which
+ * is the start of the current round afterwards. This is only possible once
+ * and not in the first round. The dices are not tossed again.
+ *****************************************************************************/
+
+bool s_status_undo_round(s_status *status, s_fieldset *fieldset) {
+
+	if (!_round_valid) {
+		return false;
+	}
+
+	log_debug_str("Do reset round");
+
+	memcpy(status, &_status_round, sizeof(s_status));
+	memcpy(fieldset, &_fieldset_round, sizeof(s_fieldset));
+
+	memcpy(&_status_undo, &_status_round, sizeof(s_status));
+	memcpy(&_fieldset_undo, &_fieldset_round, sizeof(s_fieldset));
+
+	_round_valid = false;
+
+	return true;
+}
+
 /******************************************************************************
  * The function initializes the status struct, with the game configurations.
  * The values do not change after the start of the game.
@@ -93,6 +133,11 @@ void s_status_start(s_status *status, const s_fieldset *fieldset) {
 	//
 	s_dices_toss(&status->dices);
 	s_status_undo_save(status, fieldset);
+
+	//
+	// There is no previous round.
+	//
+	_round_valid = false;
 }
 
 /******************************************************************************
@@ -126,7 +171,9 @@ void s_status_do_confirm(s_status *status, const s_fieldset *fieldset) {
 
 	// TODO: check E_DICE_NOT_POS for the active dice
 
+#ifdef DEBUG
 	s_dices_debug(&status->dices);
+#endif
 }
 
 /******************************************************************************
@@ -22,37 +22,44 @@
  * SOFTWARE.
  */
 
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
 #include "lib_logging.h"
 #include "lib_utils.h"
-#include "lib_color.h"
-#include "lib_color_pair.h"
 
 #include "bg_defs.h"
 #include "s_tarr.h"
 
 /******************************************************************************
- * The function allocates a s_tarr structure with a given dimension.
+ * The number of elements of a row, which is a multiple of the number of
+ * shorts in an aligned block. So the rows of all planes are aligned.
  *****************************************************************************/
 
-s_tarr* s_tarr_new(const int row, const int col) {
+#define S_TARR_STRIDE_ELEM (LA_ALIGN / sizeof(short))
 
-	log_debug("New s_tarr with: %d/%d", row, col);
+#define s_tarr_stride(c) (((c) + S_TARR_STRIDE_ELEM - 1) / S_TARR_STRIDE_ELEM * S_TARR_STRIDE_ELEM)
 
-	//
-	// Allocate the structure
-	//
-	s_tarr *tarr = malloc(sizeof(s_tarr));
-	if (tarr == NULL) {
-		log_exit_str("Unable to allocate memory!");
-	}
+/******************************************************************************
+ * The function computes the size of a s_tarr with its planes.
+ *****************************************************************************/
 
-	//
-	// Allocate the array (1-dimensional)
-	//
-	tarr->arr = malloc(row * col * sizeof(s_tchar));
-	if (tarr->arr == NULL) {
-		log_exit_str("Unable to allocate memory!");
-	}
+static size_t s_tarr_size(const int row, const int col) {
+
+	const size_t num = row * s_tarr_stride(col);
+
+	return sizeof(s_tarr) + num * (sizeof(wchar_t) + 2 * sizeof(short));
+}
+
+/******************************************************************************
+ * The function initializes a s_tarr in an allocated block of memory. The
+ * planes are located in the flexible array member.
+ *****************************************************************************/
+
+static s_tarr* s_tarr_init(void *mem, const int row, const int col, const bool in_arena) {
+
+	s_tarr *tarr = mem;
 
 	//
 	// Set the dimensions.
@@ -60,9 +67,51 @@ s_tarr* s_tarr_new(const int row, const int col) {
 	tarr->dim.row = row;
 	tarr->dim.col = col;
 
+	tarr->stride = s_tarr_stride(col);
+	tarr->in_arena = in_arena;
+
+	//
+	// Set the planes. The size of each plane is a multiple of LA_ALIGN, so
+	// all planes are aligned.
+	//
+	const size_t num = row * tarr->stride;
+
+	tarr->chr = (wchar_t*) tarr->data;
+	tarr->fg = (short*) (tarr->data + num * sizeof(wchar_t));
+	tarr->bg = (short*) (tarr->data + num * (sizeof(wchar_t) + sizeof(short)));
+
 	return tarr;
 }
 
+/******************************************************************************
+ * The function allocates a s_tarr structure with a given dimension. The
+ * structure and the planes are allocated with a single call.
+ *****************************************************************************/
+
+s_tarr* s_tarr_new(const int row, const int col) {
+
+	log_debug("New s_tarr with: %d/%d", row, col);
+
+	void *mem = aligned_alloc(LA_ALIGN, s_tarr_size(row, col));
+	if (mem == NULL) {
+		log_exit_str("Unable to allocate memory!");
+	}
+
+	return s_tarr_init(mem, row, col, false);
+}
+
+/******************************************************************************
+ * The function allocates a s_tarr structure with a given dimension from an
+ * arena. The s_tarr is released with the arena.
+ *****************************************************************************/
+
+s_tarr* s_tarr_new_arena(s_arena *arena, const int row, const int col) {
+
+	log_debug("New s_tarr with: %d/%d from arena", row, col);
+
+	return s_tarr_init(la_alloc(arena, s_tarr_size(row, col)), row, col, true);
+}
+
 /******************************************************************************
  * The function frees the s_tarr structure.
  *
@@ -81,14 +130,12 @@ void s_tarr_free(s_tarr **tarr) {
 	}
 
 	//
-	// Free the array
-	//
-	free((*tarr)->arr);
-
+	// Free the structure with the planes. If the s_tarr is from an arena,
+	// the memory is released with the arena.
 	//
-	// Free the structure.
-	//
-	free(*tarr);
+	if (!(*tarr)->in_arena) {
+		free(*tarr);
+	}
 
 	//
 	// Set the pointer to NULL, to mark it as freed.
@@ -96,50 +143,90 @@ void s_tarr_free(s_tarr **tarr) {
 	*tarr = NULL;
 }
 
+/******************************************************************************
+ * The function fills a part of a color plane with a color. The simple loop
+ * can be vectorized by the compiler.
+ *****************************************************************************/
+
+static void s_tarr_fill_color(short *colors, const short color, const int num) {
+
+	for (int i = 0; i < num; i++) {
+		colors[i] = color;
+	}
+}
+
 /******************************************************************************
  * The function initializes the array with a s_tchar. All elements are treated
- * the same, so do not need to care about rows and cols and treat the structure
- * as a one dimensional array.
+ * the same, so do not need to care about rows and cols and treat the planes
+ * as one dimensional arrays.
  *****************************************************************************/
 
 void s_tarr_set(s_tarr *tarr, const s_tchar tchar) {
 
-	const int end = tarr->dim.row * tarr->dim.col;
+	const int end = tarr->dim.row * tarr->stride;
 
-	for (int i = 0; i < end; i++) {
-		tarr->arr[i] = tchar;
-	}
+	wmemset(tarr->chr, tchar.chr, end);
+
+	s_tarr_fill_color(tarr->fg, tchar.fg, end);
+
+	s_tarr_fill_color(tarr->bg, tchar.bg, end);
 }
 
 /******************************************************************************
- * The function deletes the s_tarr on the target at a given position.
- *
- * (unit tested)
+ * The function sets an area of the target to a s_tchar.
  *****************************************************************************/
 
-void s_tarr_del(const s_tarr *ta_target, const s_point dim_del, const s_point pos_del) {
+void s_tarr_set_area(const s_tarr *ta_target, const s_point dim_area, const s_point pos_area, const s_tchar tchar) {
 
-	const int row_end = pos_del.row + dim_del.row;
-	const int col_end = pos_del.col + dim_del.col;
+	const int row_end = pos_area.row + dim_area.row;
 
 #ifdef DEBUG
 
 	//
-	// Ensure that the array is inside the target.
+	// Ensure that the area is inside the target.
 	//
-	if (ta_target->dim.row < row_end || ta_target->dim.col < col_end) {
-		log_exit_str("Delete array not inside!");
+	if (ta_target->dim.row < row_end || ta_target->dim.col < pos_area.col + dim_area.col) {
+		log_exit_str("Area not inside!");
 	}
 #endif
 
-	for (int row = pos_del.row; row < row_end; row++) {
-		for (int col = pos_del.col; col < col_end; col++) {
+	int idx;
+
+	for (int row = pos_area.row; row < row_end; row++) {
+		idx = s_tarr_idx(ta_target, row, pos_area.col);
 
-			s_tarr_get(ta_target, row, col) = (s_tchar ) { TCHAR_CHR_UNUSED, -1, -1 };
-		}
+		wmemset(&ta_target->chr[idx], tchar.chr, dim_area.col);
+
+		s_tarr_fill_color(&ta_target->fg[idx], tchar.fg, dim_area.col);
+
+		s_tarr_fill_color(&ta_target->bg[idx], tchar.bg, dim_area.col);
 	}
 }
 
+/******************************************************************************
+ * The function writes a string with a foreground and a background color to a
+ * row of the array. The string is cut at the end of the row.
+ *
+ * (unit tested)
+ *****************************************************************************/
+
+void s_tarr_set_str(const s_tarr *ta_target, const s_point pos, const char *str, const short fg, const short bg) {
+
+	for (int col = pos.col; col < ta_target->dim.col && *str != '\0'; col++, str++) {
+		s_tarr_set_tchar(ta_target, pos.row, col, (s_tchar ) { (wchar_t) *str, fg, bg });
+	}
+}
+
+/******************************************************************************
+ * The function deletes the s_tarr on the target at a given position.
+ *
+ * (unit tested)
+ *****************************************************************************/
+
+void s_tarr_del(const s_tarr *ta_target, const s_point dim_del, const s_point pos_del) {
+	s_tarr_set_area(ta_target, dim_del, pos_del, S_TCHAR_UNUSED);
+}
+
 /******************************************************************************
  * The function initializes the array with a wchar_t character, a foreground
  * color and an array with a background gradient.
@@ -149,17 +236,17 @@ void s_tarr_del(const s_tarr *ta_target, const s_point dim_del, const s_point po
 
 void s_tarr_set_gradient(s_tarr *tarr, const wchar_t chr, const short fg_color, const short *bg_colors) {
 
-	s_tchar *tchr;
+	const int end = tarr->dim.row * tarr->stride;
 
-	for (int row = 0; row < tarr->dim.row; row++) {
-		for (int col = 0; col < tarr->dim.col; col++) {
+	wmemset(tarr->chr, chr, end);
 
-			tchr = &s_tarr_get(tarr, row, col);
+	s_tarr_fill_color(tarr->fg, fg_color, end);
 
-			tchr->chr = chr;
-			tchr->fg = fg_color;
-			tchr->bg = bg_colors[row];
-		}
+	//
+	// The background color is the same for all columns of a row.
+	//
+	for (int row = 0; row < tarr->dim.row; row++) {
+		s_tarr_fill_color(&tarr->bg[s_tarr_idx(tarr, row, 0)], bg_colors[row], tarr->dim.col);
 	}
 }
 
@@ -170,7 +257,7 @@ void s_tarr_set_gradient(s_tarr *tarr, const wchar_t chr, const short fg_color,
  *****************************************************************************/
 
 void s_tarr_cp(s_tarr *to_arr, const s_tarr *from_arr, const s_point pos) {
-	log_debug("pos: %d/%d", pos.row, pos.col);
+	log_trace("pos: %d/%d", pos.row, pos.col);
 
 #ifdef DEBUG
 
@@ -183,11 +270,20 @@ void s_tarr_cp(s_tarr *to_arr, const s_tarr *from_arr, const s_point pos) {
 
 #endif
 
+	int idx_to, idx_from;
+
+	//
+	// Copy the rows of each plane.
+	//
 	for (int row = 0; row < from_arr->dim.row; row++) {
-		for (int col = 0; col < from_arr->dim.col; col++) {
+		idx_to = s_tarr_idx(to_arr, pos.row + row, pos.col);
+		idx_from = s_tarr_idx(from_arr, row, 0);
+
+		wmemcpy(&to_arr->chr[idx_to], &from_arr->chr[idx_from], from_arr->dim.col);
 
-			s_tarr_get(to_arr, pos.row + row, pos.col + col) = s_tarr_get(from_arr, row, col);
-		}
+		memcpy(&to_arr->fg[idx_to], &from_arr->fg[idx_from], from_arr->dim.col * sizeof(short));
+
+		memcpy(&to_arr->bg[idx_to], &from_arr->bg[idx_from], from_arr->dim.col * sizeof(short));
 	}
 }
 
@@ -200,7 +296,7 @@ void s_tarr_cp(s_tarr *to_arr, const s_tarr *from_arr, const s_point pos) {
 
 void s_tarr_set_bg(s_tarr *tarr, const s_point pos, const s_point dim, const short *bg_colors, const bool reverse) {
 
-	log_debug("pos: %d/%d dim: %d/%d", pos.row, pos.col, dim.row, dim.col);
+	log_trace("pos: %d/%d dim: %d/%d", pos.row, pos.col, dim.row, dim.col);
 
 #ifdef DEBUG
 
@@ -213,21 +309,13 @@ void s_tarr_set_bg(s_tarr *tarr, const s_point pos, const s_point dim, const sho
 
 #endif
 
-	//
-	// Store the position of the area.
-	//
-	const int pos_row = pos.row;
-	const int pos_col = pos.col;
+	short color;
 
 	for (int row = 0; row < dim.row; row++) {
-		for (int col = 0; col < dim.col; col++) {
-
-			if (reverse) {
-				s_tarr_get(tarr, pos_row + row, pos_col + col).bg = bg_colors[lu_reverse_idx(dim.row, row)];
-			} else {
-				s_tarr_get(tarr, pos_row + row, pos_col + col).bg = bg_colors[row];
-			}
-		}
+
+		color = reverse ? bg_colors[lu_reverse_idx(dim.row, row)] : bg_colors[row];
+
+		s_tarr_fill_color(&tarr->bg[s_tarr_idx(tarr, pos.row + row, pos.col)], color, dim.col);
 	}
 }
 
@@ -251,18 +339,18 @@ void s_tarr_cp_fg(s_tarr *to_arr, const s_tarr *from_arr, const s_point pos) {
 
 #endif
 
-	const s_tchar *from;
-	s_tchar *to;
+	int idx_to, idx_from;
 
+	//
+	// Copy the rows of the character and the foreground plane.
+	//
 	for (int row = 0; row < from_arr->dim.row; row++) {
-		for (int col = 0; col < from_arr->dim.col; col++) {
+		idx_to = s_tarr_idx(to_arr, pos.row + row, pos.col);
+		idx_from = s_tarr_idx(from_arr, row, 0);
 
-			to = &s_tarr_get(to_arr, pos.row + row, pos.col + col);
-			from = &s_tarr_get(from_arr, row, col);
+		wmemcpy(&to_arr->chr[idx_to], &from_arr->chr[idx_from], from_arr->dim.col);
 
-			to->chr = from->chr;
-			to->fg = from->fg;
-		}
+		memcpy(&to_arr->fg[idx_to], &from_arr->fg[idx_from], from_arr->dim.col * sizeof(short));
 	}
 }
 
@@ -341,116 +429,3 @@ s_point s_tarr_ul_pos_get(const s_tarr *tarr, s_point cur_pos, const bool revers
 
 	return cur_pos;
 }
-
-/******************************************************************************
- * The function prints the foreground at a given position. If the foreground is
- * not defined we use the background.
- *****************************************************************************/
-
-void s_tarr_print_area(WINDOW *win, const s_tarr *ta_fg, const s_tarr *ta_bg, const s_point pos, const s_point dim) {
-
-	const int row_end = pos.row + dim.row;
-	const int col_end = pos.col + dim.col;
-
-#ifdef DEBUG
-
-	//
-	// Ensure that both have the same dimension.
-	//
-	if (ta_fg->dim.row != ta_bg->dim.row || ta_fg->dim.col != ta_bg->dim.col) {
-		log_exit_str("FG and BG dimensions differ!");
-	}
-
-	//
-	// Ensure that the area is inside the fg / bg.
-	//
-	if (ta_fg->dim.row < row_end || ta_fg->dim.col < col_end) {
-		log_exit_str("Area not inside!");
-	}
-
-#endif
-
-	short cp;
-	const s_tchar *tchar;
-
-	for (int row = pos.row; row < row_end; row++) {
-		for (int col = pos.col; col < col_end; col++) {
-
-			//
-			// We first try the foreground
-			//
-			tchar = &s_tarr_get(ta_fg, row, col);
-
-			//
-			// If it is not defined we use the background.
-			//
-			if (!s_tchar_is_defined(tchar)) {
-				tchar = &s_tarr_get(ta_bg, row, col);
-			}
-
-#ifdef DEBUG
-
-			//
-			// Ensure that the color pair is valid. Here we have a position.
-			//
-			if (!col_is_valid(tchar->fg) || !col_is_valid(tchar->bg)) {
-				log_exit("Color: %d/%d at: %d/%d", tchar->fg, tchar->bg, row, col);
-			}
-#endif
-
-			//
-			// Set the color pair with the t_char
-			//
-			cp = cp_color_pair_get(tchar->fg, tchar->bg);
-			wattrset(win, COLOR_PAIR(cp));
-
-			mvwprintw(win, row, col, "%lc", tchar->chr);
-		}
-	}
-}
-
-/******************************************************************************
- * The function simply print the s_tarr to a window at a given position.
- *****************************************************************************/
-
-void s_tarr_print(WINDOW *win, const s_tarr *tarr, const s_point pos) {
-	const s_tchar *tchar;
-	short cp;
-
-	for (int row = 0; row < tarr->dim.row; row++) {
-		for (int col = 0; col < tarr->dim.col; col++) {
-
-			//
-			// Get the element
-			//
-			tchar = &s_tarr_get(tarr, row, col);
-
-			//
-			// Set the color
-			//
-			cp = cp_color_pair_get(tchar->fg, tchar->bg);
-			wattrset(win, COLOR_PAIR(cp));
-
-			//
-			// Print the result
-			//
-			mvwprintw(win, pos.row + row, pos.col + col, "%lc", tchar->chr);
-		}
-	}
-}
-
-/******************************************************************************
- * The function writes blank with default colors / color pair to the given
- * window. It can be used to delete a s_tarr.
- *****************************************************************************/
-
-void s_tarr_print_empty(WINDOW *win, const s_point dim, const s_point pos) {
-	wattrset(win, COLOR_PAIR(0));
-
-	for (int row = 0; row < dim.row; row++) {
-		for (int col = 0; col < dim.col; col++) {
-
-			mvwaddch(win, pos.row + row, pos.col + col, ' ');
-		}
-	}
-}
@@ -0,0 +1,379 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/******************************************************************************
+ * The source file implements the theme table. The color definitions of the
+ * game configuration are parsed once and the gradients are computed once.
+ * Identical gradients (same start, end and number of steps) share a ramp. A
+ * ramp is an array of rgb values (0-1000) in a pool, so the table is compact
+ * and can be reused for each board.
+ *****************************************************************************/
+
+#include <string.h>
+
+#include "lib_logging.h"
+#include "lib_utils.h"
+#include "lib_color.h"
+#include "s_theme.h"
+
+/******************************************************************************
+ * The number of solid bands of the gradients. A gradient is collapsed to the
+ * bands, so fewer colors have to be written to the terminal. A value of 0
+ * means that the gradients are not collapsed.
+ *****************************************************************************/
+
+static int _bands = 0;
+
+/******************************************************************************
+ * The parsed color definitions. The hex string is stored with the rgb values
+ * (0-1000).
+ *****************************************************************************/
+
+#define S_THEME_HEX_MAX 64
+
+#define S_THEME_HEX_LEN 8
+
+typedef struct {
+
+	char hex[S_THEME_HEX_LEN];
+
+	s_color_def color_def;
+
+} s_theme_hex;
+
+static s_theme_hex _hex[S_THEME_HEX_MAX];
+
+static int _hex_num = 0;
+
+/******************************************************************************
+ * The ramps of the gradients. The start and the end color are the parsed rgb
+ * values (0-1000) and the offset is the index of the first step in the pool.
+ *****************************************************************************/
+
+#define S_THEME_RAMP_MAX 64
+
+#define S_THEME_POOL_MAX 2048
+
+typedef struct {
+
+	s_color_def start;
+
+	s_color_def end;
+
+	int num;
+
+	int offset;
+
+} s_theme_ramp_def;
+
+static s_theme_ramp_def _ramps[S_THEME_RAMP_MAX];
+
+static int _ramps_num = 0;
+
+static s_color_def _pool[S_THEME_POOL_MAX];
+
+static int _pool_num = 0;
+
+/******************************************************************************
+ * The number of requested gradients and the number of requests, that reused a
+ * ramp.
+ *****************************************************************************/
+
+static long _stat_requests = 0;
+
+static long _stat_hits = 0;
+
+/******************************************************************************
+ * The function removes all parsed colors and ramps.
+ *****************************************************************************/
+
+void s_theme_reset() {
+
+	_hex_num = 0;
+
+	_ramps_num = 0;
+
+	_pool_num = 0;
+
+	_stat_requests = 0;
+
+	_stat_hits = 0;
+}
+
+/******************************************************************************
+ * The function returns the rgb values (0-1000) of a hex string. The string is
+ * only parsed if it was not parsed before.
+ *****************************************************************************/
+
+static const s_color_def* s_theme_hex_get(const char *hex) {
+
+	for (int i = 0; i < _hex_num; i++) {
+		if (strcmp(_hex[i].hex, hex) == 0) {
+			return &_hex[i].color_def;
+		}
+	}
+
+	if (_hex_num == S_THEME_HEX_MAX) {
+		log_exit_str("Too many theme colors!");
+	}
+
+	s_theme_hex *theme_hex = &_hex[_hex_num];
+
+	//
+	// Convert the color from a string to hex values to ncurses values (0-1000)
+	// (the string is validated by the parsing, so it fits).
+	//
+	s_color_def_hex_str(&theme_hex->color_def, hex);
+	s_color_def_hex_dec(&theme_hex->color_def);
+
+	strcpy(theme_hex->hex, hex);
+
+	_hex_num++;
+
+	return &theme_hex->color_def;
+}
+
+/******************************************************************************
+ * The function parses all color definitions of the game configuration. This
+ * should be called once at the start.
+ *****************************************************************************/
+
+void s_theme_compile(const s_game_cfg *game_cfg) {
+
+	const char *colors[GAME_CFG_COLORS_NUM];
+
+	s_game_cfg_colors(game_cfg, colors);
+
+	for (int i = 0; i < GAME_CFG_COLORS_NUM; i++) {
+		s_theme_hex_get(colors[i]);
+	}
+
+	log_debug("Theme colors: %d", _hex_num);
+}
+
+/******************************************************************************
+ * The function returns the ramp of a gradient with num steps. If an identical
+ * ramp exists, it is reused. Otherwise the steps are computed and added to the
+ * pool.
+ *
+ * (Unit tested)
+ *****************************************************************************/
+
+const s_color_def* s_theme_ramp(const char *str_start, const char *str_end, const int num) {
+
+	_stat_requests++;
+
+	const s_color_def *start = s_theme_hex_get(str_start);
+	const s_color_def *end = s_theme_hex_get(str_end);
+
+	for (int i = 0; i < _ramps_num; i++) {
+		const s_theme_ramp_def *ramp = &_ramps[i];
+
+		if (ramp->num == num && memcmp(&ramp->start, start, sizeof(s_color_def)) == 0 && memcmp(&ramp->end, end, sizeof(s_color_def)) == 0) {
+			_stat_hits++;
+			return &_pool[ramp->offset];
+		}
+	}
+
+	if (_ramps_num == S_THEME_RAMP_MAX || _pool_num + num > S_THEME_POOL_MAX) {
+		log_exit("Theme table is full, ramps: %d pool: %d", _ramps_num, _pool_num);
+	}
+
+	s_theme_ramp_def *ramp = &_ramps[_ramps_num++];
+
+	ramp->start = *start;
+	ramp->end = *end;
+	ramp->num = num;
+	ramp->offset = _pool_num;
+
+	for (int i = 0; i < num; i++) {
+		s_color_def_gradient_do(num, i, start, end, &_pool[_pool_num + i]);
+	}
+
+	_pool_num += num;
+
+	log_debug("New ramp: %d num: %d start: %s end: %s", _ramps_num, num, str_start, str_end);
+
+	return &_pool[ramp->offset];
+}
+
+/******************************************************************************
+ * The function is called with an array of colors with num elements, which
+ * should be filled with the gradient from start color to end color.
+ *****************************************************************************/
+
+void s_theme_gradient(short *colors, const int num, const char *str_start, const char *str_end) {
+
+	const s_color_def *ramp = s_theme_ramp(str_start, str_end, num);
+
+	for (int i = 0; i < num; i++) {
+
+		//
+		// With bands, each step gets the color from the middle of its band.
+		//
+		const int idx = s_theme_band_idx(i, num);
+
+		colors[i] = col_color_create(ramp[idx].r, ramp[idx].g, ramp[idx].b);
+	}
+}
+
+/******************************************************************************
+ * The function sets the number of bands of the gradients (0 means that the
+ * gradients are not collapsed). It has to be called before the colors are
+ * created.
+ *****************************************************************************/
+
+void s_theme_set_bands(const int bands) {
+
+	log_debug("bands: %d", bands);
+
+	_bands = bands;
+}
+
+/******************************************************************************
+ * The function returns the index of the step of a ramp with num steps, that
+ * is used for the step idx. Without bands, this is the step itself. With
+ * bands, it is the step in the middle of the band of the step.
+ *****************************************************************************/
+
+int s_theme_band_idx(const int idx, const int num) {
+
+	if (_bands <= 0 || _bands >= num) {
+		return idx;
+	}
+
+	const int band = idx * _bands / num;
+
+	return lu_min(((2 * band + 1) * num) / (2 * _bands), num - 1);
+}
+
+/******************************************************************************
+ * The function creates a color from a hex string.
+ *****************************************************************************/
+
+short s_theme_color_create(const char *hex) {
+
+	const s_color_def *color_def = s_theme_hex_get(hex);
+
+	return col_color_create(color_def->r, color_def->g, color_def->b);
+}
+
+/******************************************************************************
+ * The function writes the theme table (the parsed colors, the ramps and the
+ * pool) to a stream. The function returns false on errors.
+ *****************************************************************************/
+
+bool s_theme_write(FILE *stream) {
+
+	return fwrite(&_hex_num, sizeof(int), 1, stream) == 1 &&
+
+	fwrite(_hex, sizeof(s_theme_hex), _hex_num, stream) == (size_t) _hex_num &&
+
+	fwrite(&_ramps_num, sizeof(int), 1, stream) == 1 &&
+
+	fwrite(_ramps, sizeof(s_theme_ramp_def), _ramps_num, stream) == (size_t) _ramps_num &&
+
+	fwrite(&_pool_num, sizeof(int), 1, stream) == 1 &&
+
+	fwrite(_pool, sizeof(s_color_def), _pool_num, stream) == (size_t) _pool_num;
+}
+
+/******************************************************************************
+ * The function reads an array with its size from a stream. The function
+ * returns false on errors or if the size exceeds the maximum.
+ *****************************************************************************/
+
+static bool s_theme_read_array(FILE *stream, void *array, int *num, const size_t size, const int max) {
+
+	if (fread(num, sizeof(int), 1, stream) != 1 || *num < 0 || *num > max) {
+		*num = 0;
+		return false;
+	}
+
+	return fread(array, size, *num, stream) == (size_t) *num;
+}
+
+/******************************************************************************
+ * The function checks the table after reading it from the cache file. Each
+ * hex string has to be terminated inside its field, because it is compared
+ * with strcmp, and each ramp has to be located inside the pool, because
+ * s_theme_ramp returns a pointer into the pool.
+ *****************************************************************************/
+
+static bool s_theme_is_valid() {
+
+	for (int i = 0; i < _hex_num; i++) {
+
+		if (memchr(_hex[i].hex, '\0', S_THEME_HEX_LEN) == NULL) {
+			log_debug("Hex: %d is not terminated", i);
+			return false;
+		}
+	}
+
+	for (int i = 0; i < _ramps_num; i++) {
+		const s_theme_ramp_def *ramp = &_ramps[i];
+
+		if (ramp->num <= 0 || ramp->offset < 0 || ramp->num > _pool_num - ramp->offset) {
+			log_debug("Ramp: %d offset: %d num: %d pool: %d", i, ramp->offset, ramp->num, _pool_num);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * The function reads the theme table from a stream. Nothing has to be parsed
+ * or computed afterwards. The function returns false on errors or if the table
+ * is not valid, in which case the table is reset.
+ *****************************************************************************/
+
+bool s_theme_read(FILE *stream) {
+
+	s_theme_reset();
+
+	if (s_theme_read_array(stream, _hex, &_hex_num, sizeof(s_theme_hex), S_THEME_HEX_MAX) &&
+
+	s_theme_read_array(stream, _ramps, &_ramps_num, sizeof(s_theme_ramp_def), S_THEME_RAMP_MAX) &&
+
+	s_theme_read_array(stream, _pool, &_pool_num, sizeof(s_color_def), S_THEME_POOL_MAX) &&
+
+	s_theme_is_valid()) {
+
+		log_debug("colors: %d ramps: %d pool: %d", _hex_num, _ramps_num, _pool_num);
+		return true;
+	}
+
+	s_theme_reset();
+
+	return false;
+}
+
+/******************************************************************************
+ * The function logs the statistics of the theme table.
+ *****************************************************************************/
+
+void s_theme_log_stats() {
+	log_debug("colors: %d ramps: %d pool: %d requests: %ld hits: %ld", _hex_num, _ramps_num, _pool_num, _stat_requests, _stat_hits);
+}
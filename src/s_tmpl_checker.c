@@ -22,8 +22,10 @@
  * SOFTWARE.
  */
 
+#include <ncurses.h>
+
 #include "lib_logging.h"
-#include "s_color_def.h"
+#include "s_theme.h"
 #include "s_tmpl_checker.h"
 
 /******************************************************************************
@@ -63,7 +65,6 @@ static short _colors[NUM_PLAYER][_COLOR_NUM];
 static wchar_t wchar_t_map[] = { L'0', L'1', L'2', L'3', L'4', L'5', L'6', L'7', L'8', L'9' };
 
 static void s_tmpl_checker_set_label(s_tarr *tmpl, const int total, const bool reverse) {
-	s_tchar *tchar;
 
 #ifdef DEBUG
 
@@ -78,43 +79,42 @@ static void s_tmpl_checker_set_label(s_tarr *tmpl, const int total, const bool r
 	//
 	// Add 1 or leading 0
 	//
-	tchar = &s_tarr_get(tmpl, reverse ? 0 : 1, 1);
-	tchar->chr = total < 10 ? L'0' : L'1';
+	s_tarr_chr(tmpl, reverse ? 0 : 1, 1) = total < 10 ? L'0' : L'1';
 
 	//
 	// Add the second digit.
 	//
-	tchar = &s_tarr_get(tmpl, reverse ? 0 : 1, 2);
-	tchar->chr = total < 10 ? wchar_t_map[total] : wchar_t_map[total - 10];
+	s_tarr_chr(tmpl, reverse ? 0 : 1, 2) = total < 10 ? wchar_t_map[total] : wchar_t_map[total - 10];
 
 }
 
 /******************************************************************************
- * The function initializes the template structures and the color array.
+ * The function initializes the template structures and the color array. The
+ * templates are allocated from the arena.
  *****************************************************************************/
 
-void s_tmpl_checker_create(const s_game_cfg *game_cfg) {
+void s_tmpl_checker_create(const s_game_cfg *game_cfg, s_arena *arena) {
 
 	//
 	// Create color: black
 	//
 	const int owner_black = e_player_color_2_owner(game_cfg->owner_top_color, PLAYER_COLOR_BLACK);
-	s_color_def_gradient(_colors[owner_black], _COLOR_NUM, game_cfg->clr_checker_black_start, game_cfg->clr_checker_black_end);
+	s_theme_gradient(_colors[owner_black], _COLOR_NUM, game_cfg->clr_checker_black_start, game_cfg->clr_checker_black_end);
 
 	//
 	// Create color: white
 	//
 	const int owner_white = e_player_color_2_owner(game_cfg->owner_top_color, PLAYER_COLOR_WHITE);
-	s_color_def_gradient(_colors[owner_white], _COLOR_NUM, game_cfg->clr_checker_white_start, game_cfg->clr_checker_white_end);
+	s_theme_gradient(_colors[owner_white], _COLOR_NUM, game_cfg->clr_checker_white_start, game_cfg->clr_checker_white_end);
 
 	//
 	// Create templates
 	//
-	_tmpls[TS_FULL] = s_tarr_new(CHECKER_ROW, CHECKER_COL);
+	_tmpls[TS_FULL] = s_tarr_new_arena(arena, CHECKER_ROW, CHECKER_COL);
 
-	_tmpls[TS_HALF] = s_tarr_new(CHECKER_ROW / 2, CHECKER_COL);
+	_tmpls[TS_HALF] = s_tarr_new_arena(arena, CHECKER_ROW / 2, CHECKER_COL);
 
-	_tmpls[TS_TRAVELER] = s_tarr_new(CHECKER_ROW, CHECKER_COL);
+	_tmpls[TS_TRAVELER] = s_tarr_new_arena(arena, CHECKER_ROW, CHECKER_COL);
 }
 
 /******************************************************************************
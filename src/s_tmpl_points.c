@@ -27,7 +27,7 @@
 #include "lib_logging.h"
 #include "lib_utils.h"
 #include "bg_defs.h"
-#include "s_color_def.h"
+#include "s_theme.h"
 #include "s_point_layout.h"
 #include "s_tmpl_points.h"
 
@@ -117,26 +117,19 @@ static s_tarr *_tmpls[NUM_PLAYER][NUM_ORIENT];
 
 static void s_tmpl_point_cp(s_tarr *tmpl, const wchar_t chr_tmpl[POINTS_ROW][POINTS_COL], const short *fg, const bool reverse) {
 
-	s_tchar *tchr;
 	int row_reverse;
 
 	for (int row = 0; row < POINTS_ROW; row++) {
 		for (int col = 0; col < POINTS_COL; col++) {
 
-			//
-			// The s_tmpl structure is not an 2 dim array, so we have to call
-			// the function to get the element.
-			//
-			tchr = &s_tarr_get(tmpl, row, col);
-
 			//
 			// If required, we copy the characters with reversed rows.
 			//
 			row_reverse = reverse ? lu_reverse_idx(POINTS_ROW, row) : row;
 
-			tchr->chr = chr_tmpl[row_reverse][col];
-			tchr->fg = fg[row];
-			tchr->bg = -1;
+			s_tarr_chr(tmpl, row, col) = chr_tmpl[row_reverse][col];
+			s_tarr_fg(tmpl, row, col) = fg[row];
+			s_tarr_bg(tmpl, row, col) = -1;
 		}
 	}
 }
@@ -152,10 +145,11 @@ static s_tarr* s_tmpl_point_get_tmpl(const int point_idx) {
 }
 
 /******************************************************************************
- * The function initializes the four templates for the points.
+ * The function initializes the four templates for the points. The templates
+ * are allocated from the arena.
  *****************************************************************************/
 
-void s_tmpl_point_create(const s_game_cfg *game_cfg) {
+void s_tmpl_point_create(const s_game_cfg *game_cfg, s_arena *arena) {
 
 	//
 	// An array for the color gradient.
@@ -165,26 +159,26 @@ void s_tmpl_point_create(const s_game_cfg *game_cfg) {
 	//
 	// Black points
 	//
-	s_color_def_gradient(colors, POINTS_ROW, game_cfg->clr_points_black_start, game_cfg->clr_points_black_end);
+	s_theme_gradient(colors, POINTS_ROW, game_cfg->clr_points_black_start, game_cfg->clr_points_black_end);
 
-	_tmpls[E_OWNER_TOP][ORIENT_TOP] = s_tarr_new(POINTS_ROW, POINTS_COL);
+	_tmpls[E_OWNER_TOP][ORIENT_TOP] = s_tarr_new_arena(arena, POINTS_ROW, POINTS_COL);
 
 	s_tmpl_point_cp(_tmpls[E_OWNER_TOP][ORIENT_TOP], _tchar_points, colors, false);
 
-	_tmpls[E_OWNER_TOP][ORIENT_BOT] = s_tarr_new(POINTS_ROW, POINTS_COL);
+	_tmpls[E_OWNER_TOP][ORIENT_BOT] = s_tarr_new_arena(arena, POINTS_ROW, POINTS_COL);
 
 	s_tmpl_point_cp(_tmpls[E_OWNER_TOP][ORIENT_BOT], _tchar_points, colors, true);
 
 	//
 	// White points
 	//
-	s_color_def_gradient(colors, POINTS_ROW, game_cfg->clr_points_white_start, game_cfg->clr_points_white_end);
+	s_theme_gradient(colors, POINTS_ROW, game_cfg->clr_points_white_start, game_cfg->clr_points_white_end);
 
-	_tmpls[E_OWNER_BOT][ORIENT_TOP] = s_tarr_new(POINTS_ROW, POINTS_COL);
+	_tmpls[E_OWNER_BOT][ORIENT_TOP] = s_tarr_new_arena(arena, POINTS_ROW, POINTS_COL);
 
 	s_tmpl_point_cp(_tmpls[E_OWNER_BOT][ORIENT_TOP], _tchar_points, colors, false);
 
-	_tmpls[E_OWNER_BOT][ORIENT_BOT] = s_tarr_new(POINTS_ROW, POINTS_COL);
+	_tmpls[E_OWNER_BOT][ORIENT_BOT] = s_tarr_new_arena(arena, POINTS_ROW, POINTS_COL);
 
 	s_tmpl_point_cp(_tmpls[E_OWNER_BOT][ORIENT_BOT], _tchar_points, colors, true);
 
@@ -264,7 +258,7 @@ void s_tmpl_point_add_2_tarr(s_tarr *tarr, const s_pos *points_pos) {
 
 	for (int i = 0; i < POINTS_NUM; i++) {
 
-		log_debug("Adding point: %d", i);
+		log_trace("Adding point: %d", i);
 
 		tmpl = s_tmpl_point_get_tmpl(i);
 
@@ -0,0 +1,236 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "lib_logging.h"
+#include "ut_utils.h"
+#include "anim.h"
+#include "ut_anim.h"
+
+/******************************************************************************
+ * The duration of a step is long, so the time does not advance the frames
+ * while a test runs. The time is stepped by moving the start of the job into
+ * the past.
+ *****************************************************************************/
+
+#define UT_STEP_MS 100000
+
+/******************************************************************************
+ * The render function counts the rendered frames and stores the last frame.
+ * The row of the traveler is the index of the frame and the column is the
+ * id of the job.
+ *****************************************************************************/
+
+static int _render_num;
+
+static int _render_idx;
+
+static int _render_frame;
+
+static int _render_job;
+
+static void ut_render(const s_anim_job *job, const int idx) {
+
+	_render_num++;
+
+	_render_idx = idx;
+	_render_frame = job->frames[idx].trv_pos.row;
+	_render_job = job->frames[idx].trv_pos.col;
+}
+
+/******************************************************************************
+ * The function resets the animation and the counters of the render function.
+ *****************************************************************************/
+
+static void ut_anim_reset() {
+
+	anim_init(0, UT_STEP_MS, ut_render);
+
+	anim_set_keyframes(false);
+
+	_render_num = 0;
+	_render_idx = -1;
+	_render_frame = -1;
+	_render_job = -1;
+}
+
+/******************************************************************************
+ * The function queues a job with a number of frames and returns it.
+ *****************************************************************************/
+
+static s_anim_job* ut_anim_job(const int id, const int num) {
+	s_anim_frame frame = { 0 };
+
+	s_anim_job *job = anim_job_new();
+
+	for (int i = 0; i < num; i++) {
+		frame.trv_pos = (s_point ) { .row = i, .col = id };
+		anim_job_add_frame(job, &frame);
+	}
+
+	anim_job_start(job);
+
+	return job;
+}
+
+/******************************************************************************
+ * The function checks that anim_step() renders all frames of a job without
+ * waiting.
+ *****************************************************************************/
+
+static void test_anim_step() {
+
+	ut_anim_reset();
+
+	ut_check_bool(anim_step(), false, "step: empty");
+
+	ut_anim_job(1, 3);
+
+	ut_check_bool(anim_is_active(), true, "step: active");
+	ut_check_int(anim_timeout(), 0, "step: not started");
+
+	for (int i = 0; i < 3; i++) {
+		ut_check_bool(anim_step(), true, "step: step");
+		ut_check_int(_render_idx, i, "step: idx");
+	}
+
+	ut_check_int(_render_num, 3, "step: num");
+	ut_check_bool(anim_is_active(), false, "step: done");
+	ut_check_int(anim_timeout(), -1, "step: timeout");
+}
+
+/******************************************************************************
+ * The function checks that the frame is computed from the time and that the
+ * frames, that are out of date, are skipped.
+ *****************************************************************************/
+
+static void test_anim_tick() {
+
+	ut_anim_reset();
+
+	s_anim_job *job = ut_anim_job(1, 5);
+
+	//
+	// The first tick starts the job and renders the first frame.
+	//
+	ut_check_bool(anim_tick(), true, "tick: first");
+	ut_check_int(_render_idx, 0, "tick: first idx");
+
+	ut_check_bool(anim_tick(), false, "tick: same frame");
+	ut_check_int(_render_num, 1, "tick: same frame num");
+
+	//
+	// The main loop falls behind 3 steps, so the frames 1 and 2 are skipped.
+	//
+	job->start -= 3 * UT_STEP_MS;
+
+	ut_check_bool(anim_tick(), true, "tick: skip");
+	ut_check_int(_render_idx, 3, "tick: skip idx");
+	ut_check_int(_render_num, 2, "tick: skip num");
+
+	//
+	// If the job is over, the last frame is rendered and the job is removed.
+	//
+	job->start -= 10 * UT_STEP_MS;
+
+	ut_check_bool(anim_tick(), true, "tick: over");
+	ut_check_int(_render_idx, 4, "tick: over idx");
+	ut_check_int(_render_num, 3, "tick: over num");
+	ut_check_bool(anim_is_active(), false, "tick: over active");
+}
+
+/******************************************************************************
+ * The function checks that the active job is finished, if the queue is full,
+ * and that anim_finish() renders the last frames of all jobs.
+ *****************************************************************************/
+
+static void test_anim_full() {
+
+	ut_anim_reset();
+
+	for (int i = 0; i < ANIM_JOBS_MAX; i++) {
+		ut_anim_job(i, 3);
+	}
+
+	ut_check_int(_render_num, 0, "full: queued");
+
+	ut_anim_job(ANIM_JOBS_MAX, 3);
+
+	ut_check_int(_render_num, 1, "full: finished");
+	ut_check_int(_render_job, 0, "full: finished job");
+	ut_check_int(_render_frame, 2, "full: finished frame");
+
+	//
+	// The fast forward renders the last frame of each job.
+	//
+	anim_finish();
+
+	ut_check_int(_render_num, ANIM_JOBS_MAX + 1, "finish: num");
+	ut_check_int(_render_job, ANIM_JOBS_MAX, "finish: job");
+	ut_check_int(_render_frame, 2, "finish: frame");
+	ut_check_bool(anim_is_active(), false, "finish: active");
+}
+
+/******************************************************************************
+ * The function checks that only the first and the last frame are rendered in
+ * the keyframes mode.
+ *****************************************************************************/
+
+static void test_anim_keyframes() {
+
+	ut_anim_reset();
+
+	anim_set_keyframes(true);
+
+	const s_anim_job *job = ut_anim_job(1, 5);
+
+	ut_check_int(job->num_frames, 2, "keyframes: num frames");
+
+	anim_step();
+	ut_check_int(_render_frame, 0, "keyframes: first");
+
+	anim_step();
+	ut_check_int(_render_frame, 4, "keyframes: last");
+
+	ut_check_int(_render_num, 2, "keyframes: num");
+	ut_check_bool(anim_is_active(), false, "keyframes: done");
+
+	anim_set_keyframes(false);
+}
+
+/******************************************************************************
+ * The function is the a wrapper, that triggers the internal unit tests.
+ *****************************************************************************/
+
+void ut_anim_exec() {
+
+	test_anim_step();
+
+	test_anim_tick();
+
+	test_anim_full();
+
+	test_anim_keyframes();
+
+	anim_clear();
+}
@@ -0,0 +1,389 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib_logging.h"
+#include "ut_utils.h"
+#include "bg_defs.h"
+#include "s_fieldset.h"
+#include "s_status.h"
+#include "rules.h"
+#include "engine.h"
+#include "ut_engine.h"
+
+/******************************************************************************
+ * The function tests the eng_pos_init() and eng_pos_flip() functions. The
+ * start position is symmetric, so the flipped position of one player is the
+ * position of the other player.
+ *****************************************************************************/
+
+static void test_eng_pos_init() {
+	s_fieldset fieldset;
+	s_eng_pos pos_top;
+	s_eng_pos pos_bot;
+
+	s_fieldset_new_game(&fieldset);
+
+	eng_pos_init(&pos_top, &fieldset, E_OWNER_TOP);
+	eng_pos_init(&pos_bot, &fieldset, E_OWNER_BOT);
+
+	ut_check_int(pos_top.point[0], 2, "top 0");
+	ut_check_int(pos_top.point[POINTS_NUM - 1], -2, "top 23");
+	ut_check_int(pos_bot.point[0], 2, "bot 0");
+	ut_check_int(pos_bot.point[POINTS_NUM - 1], -2, "bot 23");
+
+	eng_pos_flip(&pos_top, &pos_top);
+	ut_check_bool(memcmp(&pos_top, &pos_bot, sizeof(s_eng_pos)) == 0, true, "flip");
+}
+
+/******************************************************************************
+ * The function tests the eng_gen_plays() function.
+ *****************************************************************************/
+
+static void test_eng_gen_plays() {
+	s_eng_pos pos;
+	s_eng_plays *plays = malloc(sizeof(s_eng_plays));
+
+	//
+	// A single checker with two dices has one result with both orders.
+	//
+	memset(&pos, 0, sizeof(s_eng_pos));
+	pos.point[0] = 1;
+
+	eng_gen_plays(&pos, 2, 1, plays);
+	ut_check_int(plays->num, 1, "single num");
+	ut_check_int(plays->play[0].num, 2, "single steps");
+	ut_check_int(plays->play[0].pos.point[3], 1, "single dst");
+
+	//
+	// Doublets have four steps.
+	//
+	eng_gen_plays(&pos, 1, 1, plays);
+	ut_check_int(plays->num, 1, "doublets num");
+	ut_check_int(plays->play[0].num, ENG_STEPS_MAX, "doublets steps");
+	ut_check_int(plays->play[0].pos.point[4], 1, "doublets dst");
+
+	//
+	// A hit with the first dice and a move without a hit.
+	//
+	pos.point[3] = -1;
+
+	eng_gen_plays(&pos, 3, 1, plays);
+	ut_check_int(plays->num, 2, "hit num");
+
+	//
+	// The checker on the bar cannot reenter.
+	//
+	memset(&pos, 0, sizeof(s_eng_pos));
+	pos.bar[0] = 1;
+	pos.point[10] = 1;
+
+	for (int i = 0; i < POINTS_QUARTER; i++) {
+		pos.point[i] = -2;
+	}
+
+	eng_gen_plays(&pos, 6, 5, plays);
+	ut_check_int(plays->num, 1, "bar num");
+	ut_check_int(plays->play[0].num, 0, "bar steps");
+	ut_check_bool(eng_can_move(&pos, 1), false, "bar can move");
+
+	//
+	// Bear off with an exact and a higher dice: {}, {21}, {23}
+	//
+	memset(&pos, 0, sizeof(s_eng_pos));
+	pos.point[20] = 1;
+	pos.point[23] = 1;
+	pos.off[0] = CHECKER_NUM - 2;
+
+	eng_gen_plays(&pos, 6, 1, plays);
+	ut_check_int(plays->num, 3, "bear off num");
+
+	//
+	// A higher dice is only possible for the last checker.
+	//
+	eng_gen_plays(&pos, 5, 5, plays);
+	ut_check_int(plays->num, 1, "bear off doublets num");
+	ut_check_int(plays->play[0].pos.off[0], CHECKER_NUM, "bear off doublets off");
+
+	free(plays);
+}
+
+/******************************************************************************
+ * The function compares eng_can_move() with the rules module for each dice
+ * value.
+ *****************************************************************************/
+
+static void check_eng_rules(s_fieldset *fieldset, s_status *status, const char *msg) {
+	s_eng_pos pos;
+
+	rules_update_phase(status, fieldset);
+
+	eng_pos_init(&pos, fieldset, status->turn);
+
+	for (int dice = 1; dice <= 6; dice++) {
+		bool can_move = false;
+
+		s_dices_set(&status->dices, dice, dice);
+
+		for (int i = 0; i < POINTS_NUM + BARS_NUM && !can_move; i++) {
+
+			const s_field_id id = i < POINTS_NUM ? (s_field_id ) { E_FIELD_POINTS, i } : (s_field_id ) { E_FIELD_BAR, i - POINTS_NUM };
+
+			const s_field *field_src = rules_get_field_src(status, fieldset, id);
+
+			can_move = field_src != NULL && rules_can_mv(status, fieldset, field_src) != NULL;
+		}
+
+		ut_check_bool(eng_can_move(&pos, dice), can_move, msg);
+	}
+}
+
+/******************************************************************************
+ * The function tests that the moves of the engine are the moves of the rules
+ * module.
+ *****************************************************************************/
+
+static void test_eng_rules() {
+	s_fieldset fieldset;
+	s_status status;
+
+	for (e_owner owner = E_OWNER_TOP; owner <= E_OWNER_BOT; owner++) {
+
+		status.turn = owner;
+
+		s_fieldset_new_game(&fieldset);
+		check_eng_rules(&fieldset, &status, "new game");
+
+		//
+		// A checker on the bar with blocked points.
+		//
+		s_fieldset_init(&fieldset);
+		s_fieldset_set_bar(&fieldset, owner, 1);
+		s_fieldset_set_point_rel(&fieldset, owner, 10, CHECKER_NUM - 1);
+
+		for (int i = 0; i < POINTS_QUARTER; i += 2) {
+			s_fieldset_set_point_rel(&fieldset, e_owner_other(owner), POINTS_NUM - 1 - i, 2);
+		}
+
+		check_eng_rules(&fieldset, &status, "bar");
+
+		//
+		// Bear off with checkers on the 3 and the 5 point.
+		//
+		s_fieldset_init(&fieldset);
+		s_fieldset_set_point_rel(&fieldset, owner, 19, 2);
+		s_fieldset_set_point_rel(&fieldset, owner, 21, 3);
+		s_fieldset_set_point_rel(&fieldset, e_owner_other(owner), 10, 2);
+
+		check_eng_rules(&fieldset, &status, "bear off");
+	}
+}
+
+/******************************************************************************
+ * The function tests the eng_search() function. The search should hit the
+ * blot of the opponent and has to stop if it is cancelled.
+ *****************************************************************************/
+
+static void test_eng_search() {
+	s_eng_pos pos;
+	s_eng_play play;
+	s_eng_stats stats;
+	atomic_bool cancel = false;
+
+	memset(&pos, 0, sizeof(s_eng_pos));
+	pos.point[10] = 1;
+	pos.point[20] = CHECKER_NUM - 1;
+	pos.point[13] = -1;
+	pos.point[2] = -(CHECKER_NUM - 1);
+
+	const s_eng_budget budget = { .depth = 1, .deadline = 0, .nodes = 0, .cancel = &cancel };
+
+	ut_check_bool(eng_search(&pos, 3, 1, &budget, &play, &stats), true, "search result");
+	ut_check_int(play.pos.bar[1], 1, "search hit");
+	ut_check_bool(stats.searched > 0, true, "search searched");
+
+	//
+	// The second search gets the evaluations from the cache.
+	//
+	ut_check_bool(eng_search(&pos, 3, 1, &budget, &play, &stats), true, "search cache result");
+	ut_check_bool(stats.cache_hits == stats.nodes, true, "search cache hits");
+
+	atomic_store(&cancel, true);
+
+	ut_check_bool(eng_search(&pos, 3, 1, &budget, &play, &stats), false, "search cancel");
+	ut_check_int(stats.searched, 0, "search cancel searched");
+}
+
+/******************************************************************************
+ * The function tests the iterative deepening of eng_search() with the depth
+ * and the node budget. The search always returns a play with the depth, that
+ * was reached.
+ *****************************************************************************/
+
+static void test_eng_search_budget() {
+	s_eng_pos pos;
+	s_eng_play play;
+	s_eng_stats stats;
+
+	memset(&pos, 0, sizeof(s_eng_pos));
+	pos.point[10] = 2;
+	pos.point[20] = CHECKER_NUM - 2;
+	pos.point[13] = -1;
+	pos.point[2] = -(CHECKER_NUM - 1);
+
+	s_eng_budget budget = { .depth = 0, .deadline = 0, .nodes = 0, .cancel = NULL };
+
+	ut_check_bool(eng_search(&pos, 4, 2, &budget, &play, &stats), true, "depth 0 result");
+	ut_check_int(stats.depth, 0, "depth 0 depth");
+	ut_check_int(stats.nodes, stats.candidates, "depth 0 nodes");
+
+	budget.depth = ENG_DEPTH_MAX;
+
+	ut_check_bool(eng_search(&pos, 4, 2, &budget, &play, &stats), true, "depth 2 result");
+	ut_check_int(stats.depth, 2, "depth 2 depth");
+	ut_check_bool(stats.searched > 0, true, "depth 2 searched");
+
+	//
+	// A node budget of a complete search with one ply stops the second
+	// iteration before the first candidate is done.
+	//
+	budget.depth = 1;
+
+	eng_search(&pos, 4, 2, &budget, &play, &stats);
+
+	budget.depth = ENG_DEPTH_MAX;
+	budget.nodes = stats.nodes;
+
+	ut_check_bool(eng_search(&pos, 4, 2, &budget, &play, &stats), true, "nodes result");
+	ut_check_int(stats.depth, 1, "nodes depth");
+	ut_check_bool(stats.nodes <= budget.nodes, true, "nodes budget");
+
+	budget.nodes = stats.candidates + 1;
+
+	ut_check_bool(eng_search(&pos, 4, 2, &budget, &play, &stats), true, "nodes 0 result");
+	ut_check_int(stats.depth, 0, "nodes 0 depth");
+}
+
+/******************************************************************************
+ * The function tests the eng_rank() and eng_play_str() functions.
+ *****************************************************************************/
+
+static void test_eng_rank() {
+	s_eng_pos pos;
+	s_eng_play play;
+	s_eng_stats stats;
+	char buf[64];
+
+	s_eng_plays *plays = malloc(sizeof(s_eng_plays));
+
+	memset(&stats, 0, sizeof(s_eng_stats));
+
+	memset(&pos, 0, sizeof(s_eng_pos));
+	pos.point[10] = 2;
+	pos.point[13] = -1;
+
+	eng_rank(&pos, 3, 1, plays, &stats);
+	ut_check_int(stats.nodes, plays->num, "rank nodes");
+
+	for (int i = 1; i < plays->num; i++) {
+		ut_check_bool(plays->play[i - 1].eval >= plays->play[i].eval, true, "rank sorted");
+	}
+
+	//
+	// The first dice (3) hits, the second dice (1) continues.
+	//
+	play = (s_eng_play ) { .dice_first = 0, .num = 2, .src = { 10, 13 } };
+	eng_play_str(&pos, 3, 1, &play, buf, sizeof(buf));
+	ut_check_char_str(buf, "14/11* 11/10", "play str hit");
+
+	play.dice_first = 1;
+	play.src[1] = 10;
+	eng_play_str(&pos, 3, 1, &play, buf, sizeof(buf));
+	ut_check_char_str(buf, "14/13 14/11*", "play str first");
+
+	//
+	// Enter from the bar and bear off.
+	//
+	memset(&pos, 0, sizeof(s_eng_pos));
+	pos.bar[0] = 1;
+
+	play = (s_eng_play ) { .dice_first = 1, .num = 2, .src = { ENG_SRC_BAR, 1 } };
+	eng_play_str(&pos, 6, 2, &play, buf, sizeof(buf));
+	ut_check_char_str(buf, "bar/23 23/17", "play str bar");
+
+	memset(&pos, 0, sizeof(s_eng_pos));
+	pos.point[22] = 2;
+
+	play = (s_eng_play ) { .dice_first = 0, .num = 2, .src = { 22, 22 } };
+	eng_play_str(&pos, 6, 2, &play, buf, sizeof(buf));
+	ut_check_char_str(buf, "2/off 2/off", "play str off");
+
+	play.num = 0;
+	eng_play_str(&pos, 6, 2, &play, buf, sizeof(buf));
+	ut_check_char_str(buf, "(no move)", "play str no move");
+
+	free(plays);
+}
+
+/******************************************************************************
+ * The function tests the eng_roll() and eng_roll_idx() functions.
+ *****************************************************************************/
+
+static void test_eng_roll() {
+	int weight = 0;
+
+	for (int idx = 0; idx < ENG_ROLLS_NUM; idx++) {
+
+		const s_eng_roll roll = eng_roll(idx);
+
+		ut_check_int(eng_roll_idx(roll.dice_1, roll.dice_2), idx, "roll idx");
+
+		weight += roll.weight;
+	}
+
+	ut_check_int(weight, 36, "roll weight");
+}
+
+/******************************************************************************
+ * The function is the a wrapper, that triggers the internal unit tests.
+ *****************************************************************************/
+
+void ut_engine_exec() {
+
+	test_eng_pos_init();
+
+	test_eng_gen_plays();
+
+	test_eng_rules();
+
+	test_eng_search();
+
+	test_eng_search_budget();
+
+	test_eng_rank();
+
+	test_eng_roll();
+}
@@ -0,0 +1,115 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "lib_logging.h"
+#include "ut_utils.h"
+#include "input.h"
+#include "ut_input.h"
+
+/******************************************************************************
+ * The function initializes an event. Mouse events have a position and a
+ * state, keys have no mouse event.
+ *****************************************************************************/
+
+static void ut_input_event(s_input_event *event, const int key, const int x, const mmask_t bstate) {
+	MEVENT mouse = { .x = x, .y = 0, .bstate = bstate };
+
+	input_event_init(event, key, key == KEY_MOUSE ? &mouse : NULL);
+}
+
+/******************************************************************************
+ * The function checks that consecutive motions collapse to the last motion
+ * and that clicks and keys keep their order.
+ *****************************************************************************/
+
+static void test_input_collapse() {
+	s_input_event events[8];
+
+	ut_input_event(&events[0], KEY_MOUSE, 1, REPORT_MOUSE_POSITION);
+	ut_input_event(&events[1], KEY_MOUSE, 2, REPORT_MOUSE_POSITION);
+	ut_input_event(&events[2], KEY_MOUSE, 3, REPORT_MOUSE_POSITION);
+	ut_input_event(&events[3], KEY_MOUSE, 4, BUTTON1_PRESSED);
+	ut_input_event(&events[4], 'h', 0, 0);
+	ut_input_event(&events[5], KEY_MOUSE, 5, REPORT_MOUSE_POSITION);
+	ut_input_event(&events[6], KEY_MOUSE, 6, REPORT_MOUSE_POSITION);
+	ut_input_event(&events[7], KEY_MOUSE, 7, BUTTON1_RELEASED);
+
+	ut_check_int(input_collapse(events, 8), 5, "collapse: num");
+
+	ut_check_bool(input_is_motion(&events[0]), true, "collapse: motion 1");
+	ut_check_int(events[0].mouse.x, 3, "collapse: motion 1 last");
+
+	ut_check_bool(input_is_click(&events[1]), true, "collapse: click");
+	ut_check_int(events[1].mouse.x, 4, "collapse: click pos");
+
+	ut_check_int(events[2].key, 'h', "collapse: key");
+
+	ut_check_bool(input_is_motion(&events[3]), true, "collapse: motion 2");
+	ut_check_int(events[3].mouse.x, 6, "collapse: motion 2 last");
+
+	ut_check_int(events[4].mouse.x, 7, "collapse: release");
+
+	//
+	// Events without motions are not changed.
+	//
+	ut_check_int(input_collapse(events, 1), 1, "collapse: single");
+	ut_check_int(input_collapse(events, 0), 0, "collapse: empty");
+}
+
+/******************************************************************************
+ * The function checks that a click, that was read before the state of the
+ * game changed, is stale.
+ *****************************************************************************/
+
+static void test_input_stale() {
+	s_input_event click, key;
+
+	ut_input_event(&click, KEY_MOUSE, 1, BUTTON1_PRESSED);
+	ut_input_event(&key, 'h', 0, 0);
+
+	ut_check_bool(input_is_stale(&click), false, "stale: before");
+
+	input_state_changed();
+
+	ut_check_bool(input_is_stale(&click), true, "stale: after");
+	ut_check_bool(input_is_stale(&key), false, "stale: key");
+
+	//
+	// A click, that is read after the change, is not stale.
+	//
+	ut_input_event(&click, KEY_MOUSE, 1, BUTTON1_PRESSED);
+
+	ut_check_bool(input_is_stale(&click), false, "stale: new");
+}
+
+/******************************************************************************
+ * The function is the a wrapper, that triggers the internal unit tests.
+ *****************************************************************************/
+
+void ut_input_exec() {
+
+	test_input_collapse();
+
+	test_input_stale();
+}
@@ -0,0 +1,108 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdint.h>
+
+#include "lib_logging.h"
+#include "ut_utils.h"
+#include "lib_arena.h"
+#include "s_tarr.h"
+
+/******************************************************************************
+ * The function checks whether a pointer is aligned.
+ *****************************************************************************/
+
+#define ut_is_aligned(p) (((uintptr_t) (p)) % LA_ALIGN == 0)
+
+/******************************************************************************
+ * The function checks the allocations from an arena. Small allocations share
+ * a block, large allocations get their own block.
+ *****************************************************************************/
+
+static void test_la_alloc() {
+
+	s_arena *arena = la_new(512);
+
+	char *ptr_1 = la_alloc(arena, 1);
+	char *ptr_2 = la_alloc(arena, 65);
+	char *ptr_3 = la_alloc(arena, 64);
+
+	ut_check_bool(ut_is_aligned(ptr_1) && ut_is_aligned(ptr_2) && ut_is_aligned(ptr_3), true, "test_la_alloc: aligned");
+
+	ut_check_bool(ptr_2 == ptr_1 + LA_ALIGN, true, "test_la_alloc: ptr 2");
+	ut_check_bool(ptr_3 == ptr_2 + 2 * LA_ALIGN, true, "test_la_alloc: ptr 3");
+
+	ut_check_int(arena->num_blocks, 1, "test_la_alloc: one block");
+
+	//
+	// The large allocation gets its own block and the head block is used
+	// afterwards.
+	//
+	la_alloc(arena, 1024);
+	ut_check_int(arena->num_blocks, 2, "test_la_alloc: large block");
+
+	char *ptr_4 = la_alloc(arena, 64);
+	ut_check_bool(ptr_4 == ptr_3 + LA_ALIGN, true, "test_la_alloc: ptr 4");
+
+	//
+	// The head block is full, so a new block is necessary.
+	//
+	la_alloc(arena, 256);
+	ut_check_int(arena->num_blocks, 3, "test_la_alloc: new block");
+	ut_check_int(arena->num_allocs, 6, "test_la_alloc: allocs");
+
+	la_free(&arena);
+	ut_check_bool(arena == NULL, true, "test_la_alloc: free");
+}
+
+/******************************************************************************
+ * The function checks that the rows of a s_tarr from an arena are aligned.
+ *****************************************************************************/
+
+static void test_la_s_tarr() {
+
+	s_arena *arena = la_new(4096);
+
+	s_tarr *tarr = s_tarr_new_arena(arena, 3, 5);
+
+	ut_check_bool(ut_is_aligned(&s_tarr_chr(tarr, 1, 0)), true, "test_la_s_tarr: chr");
+	ut_check_bool(ut_is_aligned(&s_tarr_fg(tarr, 2, 0)), true, "test_la_s_tarr: fg");
+	ut_check_bool(ut_is_aligned(&s_tarr_bg(tarr, 1, 0)), true, "test_la_s_tarr: bg");
+
+	s_tarr_free(&tarr);
+	ut_check_bool(tarr == NULL, true, "test_la_s_tarr: free");
+
+	la_free(&arena);
+}
+
+/******************************************************************************
+ * The function is the a wrapper, that triggers the internal unit tests.
+ *****************************************************************************/
+
+void ut_lib_arena_exec() {
+
+	test_la_alloc();
+
+	test_la_s_tarr();
+}
@@ -0,0 +1,134 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ncurses.h>
+
+#include "ut_utils.h"
+#include "lib_color.h"
+#include "lib_logging.h"
+
+/******************************************************************************
+ * The function checks that equal colors share a color id.
+ *****************************************************************************/
+
+static void test_color_intern() {
+
+	col_init(0, 0);
+
+	const short color_1 = col_color_create(100, 200, 300);
+	const short color_2 = col_color_create(100, 200, 301);
+
+	ut_check_bool(color_1 != color_2, true, "intern: different");
+
+	ut_check_short(col_color_create(100, 200, 300), color_1, "intern: same 1");
+	ut_check_short(col_color_create(100, 200, 301), color_2, "intern: same 2");
+
+	ut_check_int(col_color_num(), 2, "intern: num");
+}
+
+/******************************************************************************
+ * The function checks that colors with the same quantized values share a color
+ * id.
+ *****************************************************************************/
+
+static void test_color_tolerance() {
+	short r, g, b;
+
+	col_init(0, 10);
+
+	const short color = col_color_create(500, 500, 500);
+
+	ut_check_short(col_color_create(502, 499, 503), color, "tolerance: same");
+
+	ut_check_bool(col_color_create(520, 500, 500) != color, true, "tolerance: different");
+
+	//
+	// The color keeps the values of the first request.
+	//
+	col_color_rgb(color, &r, &g, &b);
+	ut_check_short(r, 500, "tolerance: red");
+	ut_check_short(b, 500, "tolerance: blue");
+
+	ut_check_int(col_color_num(), 2, "tolerance: num");
+}
+
+/******************************************************************************
+ * The function checks that the nearest color is returned, if the budget is
+ * exhausted.
+ *****************************************************************************/
+
+static void test_color_budget() {
+
+	col_init(2, 0);
+
+	const short color_dark = col_color_create(10, 10, 10);
+	const short color_light = col_color_create(900, 900, 900);
+
+	ut_check_short(col_color_create(100, 50, 0), color_dark, "budget: dark");
+	ut_check_short(col_color_create(700, 1000, 800), color_light, "budget: light");
+
+	ut_check_int(col_color_num(), 2, "budget: num");
+}
+
+/******************************************************************************
+ * The function checks the mapping of the colors to the 256 color palette.
+ *****************************************************************************/
+
+static void test_color_256() {
+
+	col_init(0, 0);
+
+	ut_check_short(col_color_256(COLOR_BLUE), COLOR_BLUE, "256: default");
+
+	ut_check_short(col_color_256(col_color_create(1000, 0, 0)), 196, "256: cube red");
+	ut_check_short(col_color_256(col_color_create(0, 0, 0)), 16, "256: cube black");
+	ut_check_short(col_color_256(col_color_create(500, 500, 500)), 244, "256: gray");
+}
+
+/******************************************************************************
+ * The function is the a wrapper, that triggers the internal unit tests.
+ *****************************************************************************/
+
+void ut_lib_color_exec() {
+
+	//
+	// The tests do not initialize the colors with curses.
+	//
+	col_set_headless(true);
+
+	test_color_intern();
+
+	test_color_tolerance();
+
+	test_color_budget();
+
+	test_color_256();
+
+	//
+	// Reset the colors for the following tests.
+	//
+	col_init(0, 0);
+
+	col_set_headless(false);
+}
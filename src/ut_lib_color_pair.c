@@ -24,6 +24,7 @@
 
 #include "ut_utils.h"
 #include "lib_color_pair.h"
+#include "lib_curses.h"
 #include "lib_logging.h"
 
 #include <ncurses.h>
@@ -73,6 +74,117 @@ static void test_color_pair_add_get() {
 	ut_check_short(cp_12, cp_get, "Test again: 1, 2");
 }
 
+/******************************************************************************
+ * The data of the last call of the evict function.
+ *****************************************************************************/
+
+static short _evict_cp, _evict_fg, _evict_bg;
+
+static void test_evict_fct(const short cp, const short fg, const short bg) {
+
+	_evict_cp = cp;
+	_evict_fg = fg;
+	_evict_bg = bg;
+}
+
+/******************************************************************************
+ * The function checks that the least recently used color pair is recycled.
+ *****************************************************************************/
+
+static void test_color_pair_recycle() {
+	s_cp_stats stats;
+
+	cp_init(2);
+	cp_set_evict_fct(test_evict_fct);
+
+	const short cp_12 = cp_color_pair_get(1, 2);
+	const short cp_34 = cp_color_pair_get(3, 4);
+
+	//
+	// Next frame, only 3/4 is used.
+	//
+	cp_frame_next();
+	cp_color_pair_get(3, 4);
+
+	ut_check_short(cp_color_pair_get(5, 6), cp_12, "recycle: lru");
+
+	ut_check_short(_evict_cp, cp_12, "recycle: evict cp");
+	ut_check_short(_evict_fg, 1, "recycle: evict fg");
+	ut_check_short(_evict_bg, 2, "recycle: evict bg");
+
+	ut_check_short(cp_color_pair_get(3, 4), cp_34, "recycle: hit");
+
+	cp_stats(&stats);
+	ut_check_int(stats.adds, 3, "recycle: adds");
+	ut_check_int(stats.evictions, 1, "recycle: evictions");
+}
+
+/******************************************************************************
+ * The function checks that the color pairs of the current frame are not
+ * recycled. This includes a pair that was just created.
+ *****************************************************************************/
+
+static void test_color_pair_frame() {
+	s_cp_stats stats;
+
+	cp_init(2);
+	cp_set_evict_fct(test_evict_fct);
+
+	const short cp_12 = cp_color_pair_get(1, 2);
+	const short cp_34 = cp_color_pair_get(3, 4);
+
+	//
+	// Both pairs are used in the current frame.
+	//
+	ut_check_short(cp_color_pair_get(5, 6), 0, "frame: overflow");
+
+	//
+	// Next frame, 3/4 is used, so 1/2 is recycled and the new pair is
+	// protected.
+	//
+	cp_frame_next();
+	cp_color_pair_get(3, 4);
+
+	ut_check_short(cp_color_pair_get(5, 6), cp_12, "frame: lru");
+
+	ut_check_short(cp_color_pair_get(7, 8), 0, "frame: new pair protected");
+
+	ut_check_short(cp_color_pair_get(3, 4), cp_34, "frame: hit");
+
+	cp_stats(&stats);
+	ut_check_int(stats.evictions, 1, "frame: evictions");
+	ut_check_int(stats.overflows, 2, "frame: overflows");
+}
+
+/******************************************************************************
+ * The function checks that the rows with a color pair are marked.
+ *****************************************************************************/
+
+static void test_win_pair_rows() {
+	bool rows[3] = { false, false, false };
+
+	WINDOW *win = newwin(3, 3, 0, 0);
+
+	cp_init(3);
+
+	const short cp_12 = cp_color_pair_get(1, 2);
+	const short cp_34 = cp_color_pair_get(3, 4);
+
+	mvwchgat(win, 1, 2, 1, A_NORMAL, cp_12, NULL);
+	mvwchgat(win, 2, 0, 2, A_NORMAL, cp_12, NULL);
+
+	ut_check_int(lc_win_pair_rows(win, cp_12, rows), 2, "pair rows: used");
+	ut_check_bool(rows[0], false, "pair rows: row 0");
+	ut_check_bool(rows[1], true, "pair rows: row 1");
+	ut_check_bool(rows[2], true, "pair rows: row 2");
+
+	ut_check_int(lc_win_pair_rows(win, cp_12, NULL), 1, "pair rows: check");
+
+	ut_check_int(lc_win_pair_rows(win, cp_34, rows), 0, "pair rows: unused");
+
+	delwin(win);
+}
+
 /******************************************************************************
  * The function is the a wrapper, that triggers the internal unit tests.
  *****************************************************************************/
@@ -92,5 +204,15 @@ void ut_lib_color_pair_exec() {
 
 	test_color_pair_add_get();
 
+	test_color_pair_recycle();
+
+	test_color_pair_frame();
+
+	test_win_pair_rows();
+
+	cp_set_evict_fct(NULL);
+
+	cp_init(0);
+
 	endwin();
 }
@@ -0,0 +1,160 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include <wchar.h>
+
+#include "lib_logging.h"
+#include "ut_utils.h"
+#include "ut_lib_logging.h"
+
+/******************************************************************************
+ * The size of the buffers for the formatted records.
+ *****************************************************************************/
+
+#define UT_LOG_SIZE 256
+
+/******************************************************************************
+ * The macro formats the arguments with a record and with snprintf() and
+ * compares the results.
+ *****************************************************************************/
+
+#define ut_check_log(msg, fmt, ...) do {                                            \
+	static const s_log_site site = { LOG_LEVEL_DEBUG, "file.c", 1, "func", fmt };  \
+	const s_log_arg args[] = { LOG_MAP(LOG_NARG(__VA_ARGS__), __VA_ARGS__) };    \
+	char current[UT_LOG_SIZE];                                                     \
+	char expected[UT_LOG_SIZE];                                                    \
+	s_log_rec rec;                                                                 \
+	log_rec_init(&rec, &site, LOG_NARG(__VA_ARGS__), args);                        \
+	log_rec_format(&rec, current, UT_LOG_SIZE);                                    \
+	snprintf(expected, UT_LOG_SIZE, "DEBUG file.c:1:func() " fmt "\n", __VA_ARGS__); \
+	ut_check_char_str(current, expected, msg);                                     \
+} while (0)
+
+/******************************************************************************
+ * The function checks the formatting of the different types of arguments.
+ *****************************************************************************/
+
+static void test_log_rec_format() {
+	char buf[8];
+
+	ut_check_log("log int", "%d %5d %-3d| %i", 1, -22, 3, -4);
+
+	ut_check_log("log long", "%ld %lu %zu %x", -12345678901L, 12345678901UL, (size_t ) 42, 255u);
+
+	ut_check_log("log double", "%.2f %f %g", 1.005, -2.5, 0.125f);
+
+	ut_check_log("log char", "%c %lc %%", 'a', (wint_t) L'x');
+
+	ut_check_log("log bool", "%d %d", true, false);
+
+	ut_check_log("log str", "'%s' '%-6.3s'", "abc", "defgh");
+
+	//
+	// The string is copied, so the buffer can be changed after the record was
+	// initialized.
+	//
+	static const s_log_site site = { LOG_LEVEL_DEBUG, "file.c", 1, "func", "%s" };
+	char current[UT_LOG_SIZE];
+	s_log_rec rec;
+
+	strncpy(buf, "before", sizeof(buf));
+
+	const s_log_arg args[] = { log_arg(buf) };
+
+	log_rec_init(&rec, &site, 1, args);
+
+	strncpy(buf, "after", sizeof(buf));
+
+	log_rec_format(&rec, current, UT_LOG_SIZE);
+
+	ut_check_char_str(current, "DEBUG file.c:1:func() before\n", "log str copy");
+}
+
+/******************************************************************************
+ * The function checks that long strings are cut and a line does not exceed
+ * the buffer.
+ *****************************************************************************/
+
+static void test_log_rec_cut() {
+	char str[LOG_STR_SIZE * 2];
+	char current[UT_LOG_SIZE];
+	s_log_rec rec;
+
+	memset(str, 'x', sizeof(str) - 1);
+	str[sizeof(str) - 1] = '\0';
+
+	static const s_log_site site = { LOG_LEVEL_DEBUG, "file.c", 1, "func", "%s|%s|%d" };
+
+	const s_log_arg args[] = { log_arg(str), log_arg("y"), log_arg(7) };
+
+	log_rec_init(&rec, &site, 3, args);
+
+	const size_t len = log_rec_format(&rec, current, UT_LOG_SIZE);
+
+	ut_check_int((int) len, (int) strlen(current), "log cut: len");
+
+	ut_check_int((int) strcspn(current, "|"), (int) (strlen("DEBUG file.c:1:func() ") + LOG_STR_SIZE - 2), "log cut: first");
+
+	ut_check_char_str(current + len - 4, "||7\n", "log cut: rest");
+
+	log_rec_format(&rec, current, 16);
+
+	ut_check_char_str(current, "DEBUG file.c:1\n", "log cut: line");
+}
+
+/******************************************************************************
+ * The function checks the runtime level of a module and that the levels below
+ * the compile time level are always disabled.
+ *****************************************************************************/
+
+static void test_log_module() {
+
+	log_set_module("ut_lib_logging", LOG_LEVEL_WARN);
+
+	ut_check_bool(log_is_enabled(LOG_LEVEL_INFO), false, "log module: warn info");
+
+	ut_check_bool(log_is_enabled(LOG_LEVEL_WARN), LOG_LEVEL_COMPILE <= LOG_LEVEL_WARN, "log module: warn warn");
+
+	log_set_module("ut_lib_logging", LOG_LEVEL_TRACE);
+
+	ut_check_bool(log_is_enabled(LOG_LEVEL_TRACE), LOG_LEVEL_COMPILE <= LOG_LEVEL_TRACE, "log module: trace trace");
+
+	ut_check_bool(log_is_enabled(LOG_LEVEL_INFO), LOG_LEVEL_COMPILE <= LOG_LEVEL_INFO, "log module: trace info");
+
+	log_set_module("ut_lib_logging", LOG_LEVEL_DEBUG);
+}
+
+/******************************************************************************
+ * The function is the a wrapper, that triggers the internal unit tests.
+ *****************************************************************************/
+
+void ut_lib_logging_exec() {
+
+	test_log_rec_format();
+
+	test_log_rec_cut();
+
+	test_log_module();
+}
@@ -0,0 +1,122 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pthread.h>
+
+#include "lib_logging.h"
+#include "ut_utils.h"
+#include "lib_perf.h"
+#include "ut_lib_perf.h"
+
+/******************************************************************************
+ * The number of increments of a thread.
+ *****************************************************************************/
+
+#define UT_PERF_COUNT 1000
+
+//
+// Without the PERF flag, the counters are compiled out and do not change.
+//
+#ifdef PERF
+#define UT_PERF_ENABLED 1
+#else
+#define UT_PERF_ENABLED 0
+#endif
+
+/******************************************************************************
+ * The thread function increments a counter.
+ *****************************************************************************/
+
+static void* ut_perf_count(void *arg) {
+
+	(void) arg;
+
+	for (int i = 0; i < UT_PERF_COUNT; i++) {
+		pf_count(PF_COLOR_PAIR_GET);
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ * The function checks that the totals are the sums of the counters of all
+ * threads, including the finished threads.
+ *****************************************************************************/
+
+static void test_pf_count() {
+	s_pf_stats before, after;
+	pthread_t thread;
+
+	pf_stats(&before);
+
+	if (pthread_create(&thread, NULL, ut_perf_count, NULL) != 0) {
+		log_exit_str("Unable to create thread!");
+	}
+
+	ut_perf_count(NULL);
+
+	pthread_join(thread, NULL);
+
+	pf_stats(&after);
+
+	ut_check_int((int) (after.count[PF_COLOR_PAIR_GET] - before.count[PF_COLOR_PAIR_GET]), 2 * UT_PERF_COUNT * UT_PERF_ENABLED, "pf count: threads");
+
+	ut_check_int((int) (after.ns[PF_COLOR_PAIR_GET] - before.ns[PF_COLOR_PAIR_GET]), 0, "pf count: no time");
+}
+
+/******************************************************************************
+ * The function checks that a scoped timer adds a call and the time at the end
+ * of the scope.
+ *****************************************************************************/
+
+static void test_pf_scope() {
+	s_pf_stats before, after;
+
+	pf_stats(&before);
+
+	{
+		pf_scope(PF_CONTROLS_PRINT);
+
+		pf_stats(&after);
+
+		ut_check_int((int) (after.count[PF_CONTROLS_PRINT] - before.count[PF_CONTROLS_PRINT]), 0, "pf scope: inside");
+	}
+
+	pf_stats(&after);
+
+	ut_check_int((int) (after.count[PF_CONTROLS_PRINT] - before.count[PF_CONTROLS_PRINT]), UT_PERF_ENABLED, "pf scope: count");
+
+	ut_check_bool(after.ns[PF_CONTROLS_PRINT] > before.ns[PF_CONTROLS_PRINT], UT_PERF_ENABLED, "pf scope: time");
+}
+
+/******************************************************************************
+ * The function is the a wrapper, that triggers the internal unit tests.
+ *****************************************************************************/
+
+void ut_lib_perf_exec() {
+
+	test_pf_count();
+
+	test_pf_scope();
+}
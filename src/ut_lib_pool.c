@@ -0,0 +1,198 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <sched.h>
+
+#include "lib_logging.h"
+#include "ut_utils.h"
+#include "lib_pool.h"
+#include "ut_lib_pool.h"
+
+/******************************************************************************
+ * The number of workers of the tests. There are more workers than cores in
+ * most cases, which is fine for the tests.
+ *****************************************************************************/
+
+#define UT_POOL_WORKERS 4
+
+#define UT_POOL_TASKS 64
+
+/******************************************************************************
+ * The task adds its argument to a sum.
+ *****************************************************************************/
+
+static atomic_int _sum;
+
+static void ut_add(void *arg) {
+
+	atomic_fetch_add(&_sum, *(int*) arg);
+}
+
+/******************************************************************************
+ * The function checks that all tasks, that are spawned by the main thread,
+ * are executed.
+ *****************************************************************************/
+
+static void test_tp_spawn() {
+	s_tp_task task[UT_POOL_TASKS];
+	int value[UT_POOL_TASKS];
+	s_tp_group group;
+
+	atomic_store(&_sum, 0);
+
+	tp_group_init(&group);
+
+	for (int i = 0; i < UT_POOL_TASKS; i++) {
+		value[i] = i + 1;
+		tp_spawn(&group, &task[i], ut_add, &value[i]);
+	}
+
+	tp_group_wait(&group);
+
+	ut_check_bool(tp_group_is_done(&group), true, "test_tp_spawn: done");
+	ut_check_int(atomic_load(&_sum), UT_POOL_TASKS * (UT_POOL_TASKS + 1) / 2, "test_tp_spawn: sum");
+}
+
+/******************************************************************************
+ * The task computes a fibonacci number with nested groups, so the tasks are
+ * pushed to the deques of the workers and stolen by the others.
+ *****************************************************************************/
+
+typedef struct {
+
+	int n;
+
+	int result;
+
+} s_ut_fib;
+
+static void ut_fib(void *arg) {
+	s_ut_fib *fib = arg;
+
+	if (fib->n < 2) {
+		fib->result = fib->n;
+		return;
+	}
+
+	s_ut_fib sub[2] = { { .n = fib->n - 1 }, { .n = fib->n - 2 } };
+	s_tp_task task[2];
+	s_tp_group group;
+
+	tp_group_init(&group);
+
+	tp_spawn(&group, &task[0], ut_fib, &sub[0]);
+	tp_spawn(&group, &task[1], ut_fib, &sub[1]);
+
+	tp_group_wait(&group);
+
+	fib->result = sub[0].result + sub[1].result;
+}
+
+/******************************************************************************
+ * The function checks the nested groups and the statistics of the workers.
+ * The deques are empty after the group is done.
+ *****************************************************************************/
+
+static void test_tp_nested() {
+	s_tp_stats stats;
+	s_tp_task task;
+	s_tp_group group;
+	long tasks = 0;
+	long depth = 0;
+
+	s_ut_fib fib = { .n = 16 };
+
+	tp_group_init(&group);
+
+	tp_spawn(&group, &task, ut_fib, &fib);
+
+	tp_group_wait(&group);
+
+	ut_check_int(fib.result, 987, "test_tp_nested: result");
+
+	for (int i = 0; i < tp_workers(); i++) {
+		tp_stats(i, &stats);
+		tasks += stats.tasks;
+		depth += stats.depth;
+	}
+
+	//
+	// fib(16) spawns 2 * fib(17) - 1 tasks.
+	//
+	ut_check_bool(tasks >= 2 * 1597 - 1, true, "test_tp_nested: tasks");
+	ut_check_int((int) depth, 0, "test_tp_nested: depth");
+}
+
+/******************************************************************************
+ * The task runs until its group is cancelled.
+ *****************************************************************************/
+
+static void ut_wait_cancel(void *arg) {
+	s_tp_group *group = arg;
+
+	while (!tp_group_is_cancelled(group)) {
+		sched_yield();
+	}
+}
+
+/******************************************************************************
+ * The function checks the cancellation of a group.
+ *****************************************************************************/
+
+static void test_tp_cancel() {
+	s_tp_task task[UT_POOL_WORKERS];
+	s_tp_group group;
+
+	tp_group_init(&group);
+
+	for (int i = 0; i < UT_POOL_WORKERS; i++) {
+		tp_spawn(&group, &task[i], ut_wait_cancel, &group);
+	}
+
+	ut_check_bool(tp_group_is_done(&group), false, "test_tp_cancel: running");
+
+	tp_group_cancel(&group);
+
+	tp_group_wait(&group);
+
+	ut_check_bool(tp_group_is_done(&group), true, "test_tp_cancel: done");
+}
+
+/******************************************************************************
+ * The function is the a wrapper, that triggers the internal unit tests. The
+ * pool is started for the tests and stopped afterwards.
+ *****************************************************************************/
+
+void ut_lib_pool_exec() {
+
+	tp_init(UT_POOL_WORKERS, false);
+
+	test_tp_spawn();
+
+	test_tp_nested();
+
+	test_tp_cancel();
+
+	tp_free();
+}
@@ -0,0 +1,93 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "ut_utils.h"
+#include "bg_defs.h"
+#include "e_owner.h"
+#include "s_board_areas.h"
+
+/******************************************************************************
+ * The function checks the field of a position with the hit-test map.
+ *****************************************************************************/
+
+static void ut_check_target(const s_point pos, const e_field_type type, const int idx, const char *msg) {
+	s_field_id field_id;
+
+	s_board_areas_mouse_target(pos, &field_id);
+
+	ut_check_int(field_id.type, type, msg);
+	ut_check_int(field_id.idx, idx, msg);
+}
+
+/******************************************************************************
+ * The function checks the fields of the hit-test map.
+ *****************************************************************************/
+
+static void test_s_board_areas_mouse_target() {
+
+	const s_board_areas *board_areas = s_board_areas_init();
+
+	const s_area *inner = &board_areas->board_inner;
+	const s_area *outer = &board_areas->board_outer;
+
+	//
+	// Positions outside of the fields and outside of the board.
+	//
+	ut_check_target((s_point ) { 0, 0 }, E_FIELD_NONE, FIELD_NONE_IDX, "target: border");
+	ut_check_target((s_point ) { -1, 4 }, E_FIELD_NONE, FIELD_NONE_IDX, "target: negative");
+	ut_check_target(board_areas->board_dim, E_FIELD_NONE, FIELD_NONE_IDX, "target: dim");
+
+	//
+	// The first point is upper right on the inner board.
+	//
+	const s_point inner_upper_right = { inner->pos.row, inner->pos.col + inner->dim.col - 1 };
+	ut_check_target(inner_upper_right, E_FIELD_POINTS, 0, "target: inner upper right");
+
+	const s_point inner_lower_left = { inner->pos.row + inner->dim.row - 1, inner->pos.col };
+	ut_check_target(inner_lower_left, E_FIELD_POINTS, 3 * POINTS_QUARTER, "target: inner lower left");
+
+	const s_point outer_upper_left = { outer->pos.row, outer->pos.col };
+	ut_check_target(outer_upper_left, E_FIELD_POINTS, 2 * POINTS_QUARTER - 1, "target: outer upper left");
+
+	const s_point outer_lower_right = { outer->pos.row + outer->dim.row - 1, outer->pos.col + outer->dim.col - 1 };
+	ut_check_target(outer_lower_right, E_FIELD_POINTS, 3 * POINTS_QUARTER - 1, "target: outer lower right");
+
+	//
+	// The bar and the bear off areas.
+	//
+	ut_check_target(board_areas->bar_inner.pos, E_FIELD_BAR, E_OWNER_TOP, "target: bar top");
+
+	const s_point bear_off_lower = { board_areas->bear_off.pos.row + board_areas->bear_off.dim.row - 1, board_areas->bear_off.pos.col };
+	ut_check_target(bear_off_lower, E_FIELD_BEAR_OFF, E_OWNER_BOT, "target: bear off bottom");
+}
+
+/******************************************************************************
+ * The function is the a wrapper, that triggers the internal unit tests.
+ *****************************************************************************/
+
+void ut_s_board_areas_exec() {
+
+	test_s_board_areas_mouse_target();
+}
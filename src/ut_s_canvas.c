@@ -0,0 +1,258 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <ncurses.h>
+
+#include "lib_logging.h"
+#include "lib_color.h"
+#include "ut_utils.h"
+#include "s_canvas.h"
+
+/******************************************************************************
+ * The size of the buffer for the dumps.
+ *****************************************************************************/
+
+#define UT_DUMP_MAX 256
+
+/******************************************************************************
+ * The function creates a temporary file for the output.
+ *****************************************************************************/
+
+static FILE* ut_stream_open() {
+
+	FILE *stream = tmpfile();
+	if (stream == NULL) {
+		log_exit_str("Unable to create temp file!");
+	}
+
+	return stream;
+}
+
+/******************************************************************************
+ * The function reads the content of the temporary file, closes it and
+ * compares it and the number of bytes with the expected snapshot.
+ *****************************************************************************/
+
+static void ut_stream_check(FILE *stream, const size_t bytes, const char *expected, const char *msg) {
+	char buf[UT_DUMP_MAX];
+
+	rewind(stream);
+
+	const size_t num = fread(buf, 1, UT_DUMP_MAX - 1, stream);
+	buf[num] = '\0';
+
+	fclose(stream);
+
+	ut_check_int(bytes, num, msg);
+
+	ut_check_char_str(buf, expected, msg);
+}
+
+/******************************************************************************
+ * The function dumps the cells to a temporary file, reads the result and
+ * compares it with the expected snapshot.
+ *****************************************************************************/
+
+static void ut_check_dump(const s_tarr *cells, const bool ansi, const char *expected, const char *msg) {
+
+	FILE *stream = ut_stream_open();
+
+	const size_t bytes = s_canvas_dump(stream, cells, ansi);
+
+	ut_stream_check(stream, bytes, expected, msg);
+}
+
+/******************************************************************************
+ * The function presents the changed cells to a temporary file, reads the
+ * result and compares it with the expected snapshot.
+ *****************************************************************************/
+
+static void ut_check_present(const s_tarr *cells, s_tarr *prev, const s_point visible, const bool palette_256, const char *expected, const char *msg) {
+
+	FILE *stream = ut_stream_open();
+
+	const size_t bytes = s_canvas_present(stream, cells, prev, visible, palette_256);
+
+	ut_stream_check(stream, bytes, expected, msg);
+}
+
+/******************************************************************************
+ * The function checks the compositing of two canvases, which share a cell
+ * buffer, with a golden snapshot.
+ *****************************************************************************/
+
+static void test_s_canvas_print() {
+	s_canvas canvas_left, canvas_right;
+
+	s_tarr *cells = s_tarr_new(3, 6);
+	s_tarr_set(cells, S_TCHAR_EMPTY);
+
+	s_canvas_init_cells(&canvas_left, cells, (s_point ) { 0, 0 });
+	s_canvas_init_cells(&canvas_right, cells, (s_point ) { 1, 3 });
+
+	//
+	// The foreground is transparent, except for the upper left corner.
+	//
+	s_tarr *fg = s_tarr_new(2, 3);
+	s_tarr_set(fg, S_TCHAR_UNUSED);
+	s_tarr_set_tchar(fg, 0, 0, (s_tchar ) { L'F', 1, 2 });
+
+	s_tarr *bg = s_tarr_new(2, 3);
+	s_tarr_set(bg, (s_tchar ) { L'b', 3, 4 });
+
+	s_canvas_print_area(&canvas_left, fg, bg, (s_point ) { 0, 0 }, fg->dim);
+
+	//
+	// Print a template and delete a part of it.
+	//
+	s_tarr *tmpl = s_tarr_new(2, 2);
+	s_tarr_set(tmpl, (s_tchar ) { L'T', 5, 6 });
+
+	s_canvas_print(&canvas_right, tmpl, (s_point ) { 0, 1 });
+
+	s_canvas_print_empty(&canvas_right, (s_point ) { 1, 1 }, (s_point ) { 1, 2 });
+
+	ut_check_dump(cells, false, "Fbb   \nbbb TT\n    T \n", "test_s_canvas_print");
+
+	//
+	// Check the colors of the composited cells.
+	//
+	ut_check_short(s_tarr_bg(cells, 0, 0), 2, "test_s_canvas_print: fg");
+	ut_check_short(s_tarr_bg(cells, 0, 1), 4, "test_s_canvas_print: bg");
+	ut_check_short(s_tarr_bg(cells, 1, 5), 6, "test_s_canvas_print: tmpl");
+	ut_check_short(s_tarr_bg(cells, 2, 5), -1, "test_s_canvas_print: empty");
+
+	//
+	// The overlay covers the foreground and the background.
+	//
+	s_tarr *ov = s_tarr_new(2, 3);
+	s_tarr_set(ov, S_TCHAR_UNUSED);
+	s_tarr_set_tchar(ov, 0, 0, (s_tchar ) { L'O', 7, 1 });
+	s_tarr_set_tchar(ov, 1, 2, (s_tchar ) { L'O', 7, 1 });
+
+	s_canvas_print_overlay(&canvas_left, ov, fg, bg, (s_point ) { 0, 0 }, fg->dim);
+
+	ut_check_dump(cells, false, "Obb   \nbbO TT\n    T \n", "test_s_canvas_print: overlay");
+
+	s_tarr_free(&ov);
+	s_tarr_free(&tmpl);
+	s_tarr_free(&bg);
+	s_tarr_free(&fg);
+	s_tarr_free(&cells);
+}
+
+/******************************************************************************
+ * The function checks the ANSI dump with a default and a registered color.
+ *****************************************************************************/
+
+static void test_s_canvas_dump_ansi() {
+
+	col_set_headless(true);
+
+	const short color = col_color_create(996, 4, 500);
+
+	s_tarr *cells = s_tarr_new(1, 3);
+
+	s_tarr_set_tchar(cells, 0, 0, (s_tchar ) { L'A', COLOR_WHITE, COLOR_BLACK });
+	s_tarr_set_tchar(cells, 0, 1, (s_tchar ) { L'B', COLOR_WHITE, COLOR_BLACK });
+	s_tarr_set_tchar(cells, 0, 2, (s_tchar ) { L'C', COLOR_WHITE, color });
+
+	ut_check_dump(cells, true, "\033[38;2;173;173;173m\033[48;2;0;0;0mAB\033[48;2;253;1;127mC\033[0m\n", "test_s_canvas_dump_ansi");
+
+	s_tarr_free(&cells);
+
+	col_set_headless(false);
+}
+
+/******************************************************************************
+ * The function checks that only the changed cells are presented.
+ *****************************************************************************/
+
+static void test_s_canvas_present() {
+
+	s_tarr *cells = s_tarr_new(2, 3);
+	s_tarr_set(cells, (s_tchar ) { L'A', COLOR_WHITE, COLOR_BLACK });
+
+	//
+	// The previous cells differ from all cells.
+	//
+	s_tarr *prev = s_tarr_new(2, 3);
+	s_tarr_set(prev, (s_tchar ) { L'A', -2, -2 });
+
+	ut_check_present(cells, prev, cells->dim, false, "\033[1;1H\033[0;38;2;173;173;173;48;2;0;0;0mAAA\033[2;1HAAA\033[0m", "test_s_canvas_present: all");
+
+	ut_check_present(cells, prev, cells->dim, false, "", "test_s_canvas_present: none");
+
+	//
+	// Two adjacent cells and a cell with a different color.
+	//
+	s_tarr_chr(cells, 0, 1) = L'B';
+	s_tarr_chr(cells, 0, 2) = L'C';
+	s_tarr_set_tchar(cells, 1, 2, (s_tchar ) { L'D', COLOR_WHITE, COLOR_RED });
+
+	ut_check_present(cells, prev, cells->dim, false, "\033[1;2H\033[0;38;2;173;173;173;48;2;0;0;0mBC\033[2;3H\033[48;2;173;0;0mD\033[0m", "test_s_canvas_present: diff");
+
+	//
+	// The colors of the 256 color palette.
+	//
+	s_tarr_set(prev, (s_tchar ) { L'A', -2, -2 });
+
+	ut_check_present(cells, prev, cells->dim, true, "\033[1;1H\033[0;37;40mABC\033[2;1HAA\033[41mD\033[0m", "test_s_canvas_present: 256");
+
+	//
+	// The terminal is smaller than the cells, the remaining cells are written
+	// if it gets larger.
+	//
+	s_tarr_set(prev, (s_tchar ) { L'A', -2, -2 });
+
+	ut_check_present(cells, prev, (s_point ) { 1, 2 }, true, "\033[1;1H\033[0;37;40mAB\033[0m", "test_s_canvas_present: clip");
+
+	ut_check_present(cells, prev, cells->dim, true, "\033[1;3H\033[0;37;40mC\033[2;1HAA\033[41mD\033[0m", "test_s_canvas_present: unclip");
+
+	//
+	// Cells on the same row are reached by moving the cursor forward.
+	//
+	s_tarr_chr(cells, 0, 0) = L'X';
+	s_tarr_chr(cells, 0, 2) = L'Y';
+
+	ut_check_present(cells, prev, cells->dim, true, "\033[1;1H\033[0;37;40mX\033[CY\033[0m", "test_s_canvas_present: forward");
+
+	s_tarr_free(&prev);
+	s_tarr_free(&cells);
+}
+
+/******************************************************************************
+ * The function is the a wrapper, that triggers the internal unit tests.
+ *****************************************************************************/
+
+void ut_s_canvas_exec() {
+
+	test_s_canvas_print();
+
+	test_s_canvas_dump_ansi();
+
+	test_s_canvas_present();
+}
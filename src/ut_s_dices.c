@@ -158,6 +158,29 @@ static void test_s_dices_get_value() {
 	ut_check_int(result, 2, "2");
 }
 
+/******************************************************************************
+ * The function checks the s_dices_set_not_pos() calls.
+ *****************************************************************************/
+
+static void test_s_dices_set_not_pos() {
+	s_dices dices;
+
+	dices.dice[0].status = E_DICE_ACTIVE;
+	dices.dice[1].status = E_DICE_INACTIVE;
+
+	s_dices_set_not_pos(&dices);
+	ut_check_bool(dices.dice[0].status == E_DICE_NOT_POS, true, "not pos active");
+	ut_check_bool(dices.dice[1].status == E_DICE_NOT_POS, true, "not pos inactive");
+	ut_check_bool(s_dices_is_done(dices), true, "not pos done");
+
+	dices.dice[0].status = E_DICE_SET;
+	dices.dice[1].status = E_DICE_ACTIVE;
+
+	s_dices_set_not_pos(&dices);
+	ut_check_bool(dices.dice[0].status == E_DICE_SET, true, "not pos set");
+	ut_check_bool(dices.dice[1].status == E_DICE_NOT_POS, true, "not pos active");
+}
+
 /******************************************************************************
  * The function is the a wrapper, that triggers the internal unit tests.
  *****************************************************************************/
@@ -170,4 +193,6 @@ void ut_s_dices_exec() {
 
 	test_s_dices_get_value();
 
+	test_s_dices_set_not_pos();
+
 }
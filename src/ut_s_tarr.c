@@ -67,11 +67,9 @@ static void ut_check_free(s_tarr *tarr, const char *msg) {
 
 static void ut_check_s_tchar(const s_tchar *current, const s_tchar *expected, const char *msg) {
 
-	log_debug("Check: %s", msg);
-
-	ut_check_wchar_t(current->chr, expected->chr, "chr");
-	ut_check_int(current->fg, expected->fg, "fg");
-	ut_check_int(current->bg, expected->bg, "bg");
+	ut_check_wchar_t(current->chr, expected->chr, msg);
+	ut_check_int(current->fg, expected->fg, msg);
+	ut_check_int(current->bg, expected->bg, msg);
 }
 
 /******************************************************************************
@@ -129,6 +127,59 @@ static void test_s_tarr_del() {
 	ut_check_free(tarr, "test_set_del");
 }
 
+/******************************************************************************
+ * The function checks the s_tarr_set_area() functions.
+ *****************************************************************************/
+
+static void test_s_tarr_set_area() {
+
+	s_tarr *tarr = s_tarr_new(UT_ROWS_TO, UT_COLS_TO);
+	s_tarr_set(tarr, C_TO);
+
+	s_tarr_set_area(tarr, (s_point ) { 1, 2 }, (s_point ) { 2, 0 }, C_FROM);
+
+	s_tchar arr[UT_ROWS_TO][UT_COLS_TO] = {
+
+	{ C_TO, C_TO, C_TO },
+
+	{ C_TO, C_TO, C_TO },
+
+	{ C_FROM, C_FROM, C_TO },
+
+	};
+
+	ut_check_arrays(tarr, arr, "test_s_tarr_set_area");
+
+	ut_check_free(tarr, "test_s_tarr_set_area");
+}
+
+/******************************************************************************
+ * The function checks the s_tarr_set_str() function. The string is cut at
+ * the end of the row.
+ *****************************************************************************/
+
+static void test_s_tarr_set_str() {
+
+	s_tarr *tarr = s_tarr_new(UT_ROWS_TO, UT_COLS_TO);
+	s_tarr_set(tarr, C_TO);
+
+	s_tarr_set_str(tarr, (s_point ) { 1, 1 }, "FFF", C_FROM.fg, C_FROM.bg);
+
+	s_tchar arr[UT_ROWS_TO][UT_COLS_TO] = {
+
+	{ C_TO, C_TO, C_TO },
+
+	{ C_TO, C_FROM, C_FROM },
+
+	{ C_TO, C_TO, C_TO },
+
+	};
+
+	ut_check_arrays(tarr, arr, "test_s_tarr_set_str");
+
+	ut_check_free(tarr, "test_s_tarr_set_str");
+}
+
 /******************************************************************************
  * The function checks the s_tarr_set_gradient function.
  *****************************************************************************/
@@ -458,6 +509,10 @@ void ut_s_tarr_exec() {
 
 	test_s_tarr_del();
 
+	test_s_tarr_set_area();
+
+	test_s_tarr_set_str();
+
 	test_s_tarr_set_gradient();
 
 	test_s_tarr_cp();
@@ -0,0 +1,207 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ut_utils.h"
+#include "lib_logging.h"
+#include "s_theme.h"
+
+/******************************************************************************
+ * The function checks that identical gradients share a ramp and that the
+ * steps are computed.
+ *****************************************************************************/
+
+static void test_s_theme_ramp() {
+
+	s_theme_reset();
+
+	const s_color_def *ramp = s_theme_ramp("#000000", "#ffffff", 5);
+
+	ut_check_int(ramp[0].r, 0, "ramp: first");
+	ut_check_int(ramp[2].g, 500, "ramp: middle");
+	ut_check_int(ramp[4].b, 1000, "ramp: last");
+
+	//
+	// The same colors with a different notation share the ramp.
+	//
+	ut_check_bool(s_theme_ramp("#000000", "#FFFFFF", 5) == ramp, true, "ramp: shared");
+
+	//
+	// A different number of steps is a different ramp.
+	//
+	const s_color_def *ramp_3 = s_theme_ramp("#000000", "#ffffff", 3);
+
+	ut_check_bool(ramp_3 != ramp, true, "ramp: num");
+	ut_check_int(ramp_3[1].r, 500, "ramp: num middle");
+
+	s_theme_reset();
+}
+
+/******************************************************************************
+ * The function checks that a theme table can be written and read again.
+ *****************************************************************************/
+
+static void test_s_theme_write_read() {
+
+	s_theme_reset();
+
+	s_theme_ramp("#102030", "#405060", 4);
+
+	FILE *stream = tmpfile();
+	if (stream == NULL) {
+		log_exit_str("Unable to create temp file!");
+	}
+
+	ut_check_bool(s_theme_write(stream), true, "write");
+
+	s_theme_reset();
+
+	rewind(stream);
+
+	ut_check_bool(s_theme_read(stream), true, "read");
+
+	fclose(stream);
+
+	//
+	// The ramp is read, so the values are equal without computing them.
+	//
+	const s_color_def *ramp = s_theme_ramp("#102030", "#405060", 4);
+
+	s_color_def expected;
+	s_color_def_set(&expected, 0x40, 0x50, 0x60);
+	s_color_def_hex_dec(&expected);
+
+	ut_check_int(ramp[3].r, expected.r, "read: red");
+	ut_check_int(ramp[3].b, expected.b, "read: blue");
+
+	//
+	// An empty stream is not valid.
+	//
+	stream = tmpfile();
+	ut_check_bool(s_theme_read(stream), false, "read: empty");
+	fclose(stream);
+
+	s_theme_reset();
+}
+
+/******************************************************************************
+ * The function checks that the steps of a gradient are collapsed to bands.
+ *****************************************************************************/
+
+static void test_s_theme_bands() {
+
+	ut_check_int(s_theme_band_idx(3, 5), 3, "bands: none");
+
+	s_theme_set_bands(2);
+
+	ut_check_int(s_theme_band_idx(0, 5), 1, "bands: first");
+	ut_check_int(s_theme_band_idx(2, 5), 1, "bands: first band");
+	ut_check_int(s_theme_band_idx(3, 5), 3, "bands: second band");
+	ut_check_int(s_theme_band_idx(4, 5), 3, "bands: last");
+
+	//
+	// A gradient with fewer steps than bands is not collapsed.
+	//
+	ut_check_int(s_theme_band_idx(1, 2), 1, "bands: short");
+
+	s_theme_set_bands(0);
+}
+
+/******************************************************************************
+ * The function writes a table with a ramp of 4 colors to a temp file, replaces
+ * an int at a position (negative positions are relative to the end) and
+ * checks that reading the corrupted file fails.
+ *****************************************************************************/
+
+static void ut_check_read_corrupt(const long pos, const int value, const char *msg) {
+
+	s_theme_reset();
+
+	s_theme_ramp("#102030", "#405060", 4);
+
+	FILE *stream = tmpfile();
+	if (stream == NULL) {
+		log_exit_str("Unable to create temp file!");
+	}
+
+	ut_check_bool(s_theme_write(stream), true, msg);
+
+	if (fseek(stream, pos, pos < 0 ? SEEK_END : SEEK_SET) != 0 || fwrite(&value, sizeof(int), 1, stream) != 1) {
+		log_exit_str("Unable to corrupt temp file!");
+	}
+
+	s_theme_reset();
+
+	rewind(stream);
+
+	ut_check_bool(s_theme_read(stream), false, msg);
+
+	fclose(stream);
+
+	//
+	// The table is reset, so the ramp is computed again.
+	//
+	const s_color_def *ramp = s_theme_ramp("#102030", "#405060", 4);
+
+	s_color_def expected;
+	s_color_def_set(&expected, 0x10, 0x20, 0x30);
+	s_color_def_hex_dec(&expected);
+
+	ut_check_int(ramp[0].r, expected.r, msg);
+
+	s_theme_reset();
+}
+
+/******************************************************************************
+ * The function checks that a corrupted cache file is rejected.
+ *****************************************************************************/
+
+static void test_s_theme_read_invalid() {
+
+	//
+	// The pool size is located before the 4 colors of the pool. With a pool
+	// of 2 colors the ramp exceeds the pool.
+	//
+	ut_check_read_corrupt(-(long) (4 * sizeof(s_color_def) + sizeof(int)), 2, "read: pool");
+
+	//
+	// The first hex string "#102030" follows the number of hex strings. The
+	// int at offset 4 overwrites the terminating NUL.
+	//
+	ut_check_read_corrupt(sizeof(int) + 4, 0x41414141, "read: hex");
+}
+
+/******************************************************************************
+ * The function is the a wrapper, that triggers the internal unit tests.
+ *****************************************************************************/
+
+void ut_s_theme_exec() {
+
+	test_s_theme_ramp();
+
+	test_s_theme_write_read();
+
+	test_s_theme_read_invalid();
+
+	test_s_theme_bands();
+}
@@ -27,16 +27,27 @@
 
 #include "lib_logging.h"
 
+#include "ut_lib_logging.h"
+#include "ut_lib_perf.h"
+#include "ut_lib_color.h"
 #include "ut_lib_color_pair.h"
+#include "ut_lib_arena.h"
+#include "ut_lib_pool.h"
 #include "ut_lib_string.h"
 #include "ut_s_color_def.h"
+#include "ut_s_theme.h"
 #include "ut_direction.h"
 #include "ut_s_point_layout.h"
 #include "ut_s_tarr.h"
+#include "ut_s_canvas.h"
+#include "ut_s_board_areas.h"
+#include "ut_anim.h"
+#include "ut_input.h"
 #include "ut_lib_s_point.h"
 #include "ut_s_field.h"
 #include "ut_rules.h"
 #include "ut_s_dices.h"
+#include "ut_engine.h"
 
 /******************************************************************************
  * The main function delegates the call to the individual unit test functions.
@@ -44,6 +55,8 @@
 
 int main() {
 
+	log_init();
+
 	//
 	// Set the locale to support wchar_t
 	//
@@ -51,18 +64,38 @@ int main() {
 		log_exit_str("Unable to set the locale.");
 	}
 
+	ut_lib_logging_exec();
+
+	ut_lib_perf_exec();
+
+	ut_lib_color_exec();
+
 	ut_lib_color_pair_exec();
 
+	ut_lib_arena_exec();
+
+	ut_lib_pool_exec();
+
 	ut_lib_string_exec();
 
 	ut_s_color_def_exec();
 
+	ut_s_theme_exec();
+
 	ut_direction_exec();
 
 	ut_s_point_layout_exec();
 
 	ut_s_tarr_exec();
 
+	ut_s_canvas_exec();
+
+	ut_s_board_areas_exec();
+
+	ut_anim_exec();
+
+	ut_input_exec();
+
 	ut_lib_s_point_exec();
 
 	ut_s_field_exec();
@@ -71,5 +104,7 @@ int main() {
 
 	ut_s_dices_exec();
 
+	ut_engine_exec();
+
 	return EXIT_SUCCESS;
 }